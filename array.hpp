@@ -14,8 +14,9 @@ private:
 
     void resize(int newCapacity) {
         T* newData = new T[newCapacity];
+        INSTRUMENT_COUNT(COUNTER_ALLOCATIONS, 1);
         for (int i = 0; i < size; i++) {
-            newData[i] = data[i];
+            newData[i] = move(data[i]);
         }
         delete[] data;
         data = newData;
@@ -35,6 +36,25 @@ public:
         }
     }
 
+    CustomArrayV2(CustomArrayV2&& other) : data(other.data), capacity(other.capacity), size(other.size) {
+        other.data = nullptr;
+        other.capacity = 0;
+        other.size = 0;
+    }
+
+    CustomArrayV2& operator=(CustomArrayV2&& other) {
+        if (this != &other) {
+            delete[] data;
+            data = other.data;
+            capacity = other.capacity;
+            size = other.size;
+            other.data = nullptr;
+            other.capacity = 0;
+            other.size = 0;
+        }
+        return *this;
+    }
+
     CustomArrayV2& operator=(const CustomArrayV2& other) {
         if (this != &other) {
             clear();
@@ -45,6 +65,10 @@ public:
         return *this;
     }
 
+    void reserve(int newCapacity) {
+        if (newCapacity > capacity) resize(newCapacity);
+    }
+
     void push_back(const T& item) {
         if (size >= capacity) {
             int newCapacity = (capacity == 0) ? 1 : capacity * 2;
@@ -53,6 +77,14 @@ public:
         data[size++] = item;
     }
 
+    void push_back(T&& item) {
+        if (size >= capacity) {
+            int newCapacity = (capacity == 0) ? 1 : capacity * 2;
+            resize(newCapacity);
+        }
+        data[size++] = move(item);
+    }
+
     T& operator[](int index) {
         if (index < 0 || index >= size)
             throw out_of_range("Index out of range");
@@ -65,6 +97,10 @@ public:
         return data[index];
     }
 
+    // Raw element storage for bulk algorithms (sorts, parallel loops)
+    T* getData() { return data; }
+    const T* getData() const { return data; }
+
     int getSize() const { return size; }
     int getCapacity() const { return capacity; }
     bool empty() const { return size == 0; }
@@ -75,7 +111,7 @@ public:
         
         // Shift elements left
         for (int i = index; i < size - 1; i++) {
-            data[i] = data[i + 1];
+            data[i] = move(data[i + 1]);
         }
         size--;
         
@@ -4,6 +4,18 @@
 #include "readcsv.hpp"
 #include "preprocessor.hpp"
 #include "matching.hpp"
+#include "snapshot.hpp"
+#include "query.hpp"
+#include "versioned_store.hpp"
+#include "sorting.hpp"
+#include "bm25_index.hpp"
+#include "match_cache.hpp"
+#include "match_writer.hpp"
+#include "bplus_tree.hpp"
+#include "id_index.hpp"
+#include "trigram_index.hpp"
+#include "skill_trie.hpp"
+#include "job_buckets.hpp"
 #include <iostream>
 #include <iomanip>
 #include <ctime>
@@ -17,29 +29,282 @@ private:
     CustomArrayV2<Job> jobArray;
     CustomArrayV2<Resume> resumeArray;
     CustomArray<CustomString> validSkills; 
+    VersionedJobStore publishedStore;                   // immutable versions for concurrent readers
+    const KeywordMatcher& keywordMatcher;               // the store's automaton, so masks filled here carry over
+    CustomArray<Job> jobSortBuffer;                     // merge space reused by stable sorts
+    CustomArray<Resume> resumeSortBuffer;
+    WeightedScoreColumns weightedColumns;               // job skill bitmasks, appended on ingest
+    SkillStatistics skillStatistics;                    // skill document frequencies, counted on ingest
+    DescriptionIndex descriptionIndex;                  // BM25 postings, appended on ingest, rebuilt lazily after a sort
+    TrigramIndex titleTrigrams;                         // title substring postings, appended on ingest
+    SkillTrie skillTrie;                                // validSkills for completion, extended on ingest
+    JobBuckets<int> jobBuckets;                         // positions by (category, priority), rebuilt on reorder
+    bool descriptionIndexDirty;
+    mutable MatchCache<int> matchCache;                 // ranked positions per (resume, scorer, K)
+    bool matchCacheEnabled;
 
-public:
-    ArrayDataStorage() {}
+    // Secondary indexes of jobArray rows, bulk-loaded on first use after a
+    // load or a job reorder; appended jobs are inserted
+    BPlusTreeIndex<JobTitleKey> jobTitleTree;
+    BPlusTreeIndex<JobCategoryKey> jobCategoryTree;
+    BPlusTreeIndex<JobPriorityKey> jobPriorityTree;
+    BPlusTreeIndex<JobSkillCountKey> jobSkillCountTree;
+    BPlusTreeIndex<JobIdKey> jobIdTree;
+    bool jobTreesDirty;
 
-    
-    CustomArray<CustomString> buildValidSkillsetFromJobs() {
-        CustomArray<CustomString> skillset;
+    // Set by sorts; publishSnapshot passes the new order on to the store and
+    // the position-keyed indexes. A reload rebuilds those indexes in full,
+    // unless a snapshot restored them; ingest keeps them current row by row.
+    bool jobsReordered;
+    bool resumesReordered;
+    bool indexesReloaded;
 
-        for (int i = 0; i < jobArray.getSize(); i++) {
-            const Job& job = jobArray[i];
-            for (int j = 0; j < job.lowerCaseSkills.size(); j++) {
-                CustomString skill = job.lowerCaseSkills[j];
-                bool exists = false;
-                for (int k = 0; k < skillset.size(); k++) {
-                    if (strcmp(skillset[k].c_str(), skill.c_str()) == 0) {
-                        exists = true;
-                        break;
-                    }
-                }
-                if (!exists)
-                    skillset.push_back(skill);
+    // Incremental ingestion state
+    CustomHashMap<CustomString, int> validSkillIndex;   // skill -> position in validSkills
+    PendingSkillMap pendingResumeSkills;                // rejected resume skills -> resume ids
+    DenseIdIndex<int> resumePositionById;               // id -> array position, rebuilt on publish
+    DenseIdIndex<int> jobPositionById;
+    int nextJobId;
+    int nextResumeId;
+    long long jobFileOffset;                            // CSV bytes already ingested
+    long long resumeFileOffset;
+
+    void resetIngestionState() {
+        validSkills = CustomArray<CustomString>();
+        validSkillIndex.clear();
+        pendingResumeSkills.clear();
+        resumePositionById.clear();
+        jobPositionById.clear();
+        jobTreesDirty = true;
+        jobsReordered = false;
+        resumesReordered = false;
+        indexesReloaded = true;
+        descriptionIndexDirty = true;
+        publishedStore.resetRecords();
+        nextJobId = 1;
+        nextResumeId = 1;
+        jobFileOffset = 0;
+        resumeFileOffset = 0;
+    }
+
+    void markJobsReordered() {
+        jobTreesDirty = true;
+        jobsReordered = true;
+    }
+
+    int findResumePosition(int resumeId) const {
+        const int* position = resumePositionById.find(resumeId);
+        return position ? *position : -1;
+    }
+
+    // After a job sort, before the positions are rebuilt: the new position of
+    // the job at each old position, for indexes that remap instead of rebuilding
+    void collectJobMoves(CustomArray<int>& newPosition) const {
+        newPosition.resize(jobArray.getSize());
+        for (int i = 0; i < jobArray.getSize(); i++)
+            newPosition[*jobPositionById.find(jobArray[i].id)] = i;
+    }
+
+    // Positions move on every sort; one pass after each reorder keeps the
+    // lookups O(1) instead of rebuilding on the next query
+    void rebuildJobPositions() {
+        jobPositionById.clear();
+        jobPositionById.reserve(nextJobId);
+        for (int i = 0; i < jobArray.getSize(); i++)
+            jobPositionById.insert(jobArray[i].id, i);
+    }
+
+    void rebuildResumePositions() {
+        resumePositionById.clear();
+        resumePositionById.reserve(nextResumeId);
+        for (int i = 0; i < resumeArray.getSize(); i++)
+            resumePositionById.insert(resumeArray[i].id, i);
+    }
+
+    // Serve a ranking of one of the store's own resumes from the match cache,
+    // computing and caching it on a miss. Other resumes (ids may clash) are
+    // always computed.
+    template<typename Compute>
+    void cachedRanking(const Resume& resume, const char* scorer, int topN, QueryResult& out, Compute compute) const {
+        const Resume* stored = resumeArray.getData();
+        if (!matchCacheEnabled || stored == nullptr || &resume < stored || &resume >= stored + resumeArray.getSize()) {
+            compute(out);
+            return;
+        }
+        MatchCacheKey key(resume.id, scorer, topN);
+        unsigned long long version = publishedStore.getVersion();
+        out.clear();
+        if (matchCache.lookup(key, version, out.indices, out.scores)) return;
+        compute(out);
+        matchCache.store(key, version, out.indices, out.scores);
+    }
+
+    // Restore the indexes saved with a snapshot over the rows just read. False
+    // if one is missing or invalid; publishSnapshot then rebuilds them all.
+    // The BM25 index is built lazily anyway, so it is restored only if saved.
+    bool restoreIndexes(const SnapshotReader& reader) {
+        int jobs = jobArray.getSize();
+        int resumes = resumeArray.getSize();
+        auto restored = [&](uint32_t kind, auto restore) {
+            SnapshotSectionReader section;
+            return reader.openIndex(kind, section) && restore(section) && section.finished();
+        };
+        bool ok = restored(SNAPSHOT_INDEX_JOB_POSITIONS, [&](SnapshotSectionReader& in) {
+                      return jobPositionById.restore(in, [&](int id, int p) { return p >= 0 && p < jobs && jobArray[p].id == id; })
+                          && jobPositionById.size() == jobs;
+                  })
+               && restored(SNAPSHOT_INDEX_RESUME_POSITIONS, [&](SnapshotSectionReader& in) {
+                      return resumePositionById.restore(in, [&](int id, int p) { return p >= 0 && p < resumes && resumeArray[p].id == id; })
+                          && resumePositionById.size() == resumes;
+                  })
+               && restored(SNAPSHOT_INDEX_SKILL_TRIE, [&](SnapshotSectionReader& in) { return skillTrie.restore(in, validSkills.size()); })
+               && restored(SNAPSHOT_INDEX_SKILL_STATISTICS, [&](SnapshotSectionReader& in) { return skillStatistics.restore(in, jobs); })
+               && restored(SNAPSHOT_INDEX_WEIGHTED_COLUMNS, [&](SnapshotSectionReader& in) { return weightedColumns.restore(in, jobs); })
+               && restored(SNAPSHOT_INDEX_TITLE_TRIGRAMS, [&](SnapshotSectionReader& in) { return titleTrigrams.restore(in, jobs); })
+               && restored(SNAPSHOT_INDEX_JOB_BUCKETS, [&](SnapshotSectionReader& in) {
+                      return jobBuckets.restore(in, jobs, [&](int p) -> const Job& { return jobArray[p]; }, [](int p) { return p; });
+                  });
+        if (ok) {
+            descriptionIndexDirty = !restored(SNAPSHOT_INDEX_DESCRIPTIONS, [&](SnapshotSectionReader& in) {
+                return descriptionIndex.restore(in, jobs);
+            });
+        }
+        return ok;
+    }
+
+    // Keyword masks of every row, before the rows go to the store
+    void fillKeywordMasks() {
+        parallelFor(0, jobArray.getSize(), 0, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) keywordMatcher.maskFor(jobArray[i]);
+        }, "preprocess.masks.jobs");
+        parallelFor(0, resumeArray.getSize(), 0, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) keywordMatcher.maskFor(resumeArray[i]);
+        }, "preprocess.masks.resumes");
+    }
+
+    // Room for extra more items; grows geometrically like push_back, since an
+    // exact reserve per ingest would move the whole array every time
+    template<typename T>
+    static void reserveForAppend(CustomArrayV2<T>& items, int extra) {
+        int needed = items.getSize() + extra;
+        if (needed > items.getCapacity()) items.reserve(max(needed, items.getCapacity() * 2));
+    }
+
+    // Preprocess a batch of job rows on the thread pool, then append them in
+    // file order, extending the skillset; new skills are reported
+    void appendJobs(const CustomArray<CustomString>& lines, CustomArray<CustomString>& newSkills) {
+        int firstId = nextJobId;
+        Job* jobs = new Job[lines.size() > 0 ? lines.size() : 1];
+        parallelFor(0, lines.size(), 0, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                jobs[i] = preprocessJobDescription(lines[i], firstId + i);
+                keywordMatcher.maskFor(jobs[i]);
+            }
+        }, "preprocess.jobs");
+        nextJobId += lines.size();
+
+        int firstSkill = validSkills.size();
+        reserveForAppend(jobArray, lines.size());
+        for (int i = 0; i < lines.size(); i++) {
+            extendValidSkillset(jobs[i], validSkills, validSkillIndex, &newSkills);
+            jobPositionById.insert(jobs[i].id, jobArray.getSize());
+            jobArray.push_back(jobs[i]);
+            if (!jobTreesDirty) insertJobIntoTrees(jobArray.getSize() - 1);
+            if (!indexesReloaded) {
+                jobBuckets.append(jobs[i], jobArray.getSize() - 1);
+                skillStatistics.add(jobs[i]);
+            }
+            publishedStore.appendJob(jobs[i]);
+        }
+        if (!indexesReloaded) {
+            titleTrigrams.append(jobArray);
+            weightedColumns.append(jobArray);
+        }
+        if (!descriptionIndexDirty) descriptionIndex.append(jobArray);
+        for (int i = firstSkill; i < validSkills.size(); i++) {
+            publishedStore.appendSkill(validSkills[i]);
+            if (!indexesReloaded) skillTrie.insert(validSkills[i], i);
+        }
+        delete[] jobs;
+    }
+
+    // Resumes only read the skill index while preprocessing, so the batch runs in
+    // parallel; rejected skills are recorded afterwards in file order
+    void appendResumes(const CustomArray<CustomString>& lines) {
+        int firstId = nextResumeId;
+        Resume* resumes = new Resume[lines.size() > 0 ? lines.size() : 1];
+        CustomArray<CustomString>* rejected = new CustomArray<CustomString>[lines.size() > 0 ? lines.size() : 1];
+        parallelFor(0, lines.size(), 0, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                resumes[i] = preprocessResumeDescription(lines[i], firstId + i, validSkillIndex, &rejected[i]);
+                keywordMatcher.maskFor(resumes[i]);
             }
+        }, "preprocess.resumes");
+        nextResumeId += lines.size();
+
+        reserveForAppend(resumeArray, lines.size());
+        for (int i = 0; i < lines.size(); i++) {
+            recordRejectedSkills(pendingResumeSkills, rejected[i], resumes[i].id);
+            resumePositionById.insert(resumes[i].id, resumeArray.getSize());
+            resumeArray.push_back(resumes[i]);
+            publishedStore.appendResume(resumes[i]);
         }
+        delete[] resumes;
+        delete[] rejected;
+    }
+
+    void insertJobIntoTrees(int row) {
+        const Job& job = jobArray[row];
+        jobTitleTree.insert(JobTitleKey::of(job), row);
+        jobCategoryTree.insert(JobCategoryKey::of(job), row);
+        jobPriorityTree.insert(JobPriorityKey::of(job), row);
+        jobSkillCountTree.insert(JobSkillCountKey::of(job), row);
+        jobIdTree.insert(JobIdKey::of(job), row);
+    }
+
+    void ensureJobTrees() {
+        if (!jobTreesDirty) return;
+        bulkLoadIndex(jobTitleTree, jobArray);
+        bulkLoadIndex(jobCategoryTree, jobArray);
+        bulkLoadIndex(jobPriorityTree, jobArray);
+        bulkLoadIndex(jobSkillCountTree, jobArray);
+        bulkLoadIndex(jobIdTree, jobArray);
+        jobTreesDirty = false;
+    }
+
+    // Re-filter only the resumes that listed a skill which just became valid
+    int refilterResumesForNewSkills(const CustomArray<CustomString>& newSkills) {
+        CustomArray<int> affected = takeAffectedResumes(pendingResumeSkills, newSkills);
+        for (int i = 0; i < affected.size(); i++) {
+            int position = findResumePosition(affected[i]);
+            if (position < 0) continue;
+            Resume& resume = resumeArray[position];
+            resume = preprocessResumeDescription(resume.fullDescription, resume.id, validSkillIndex, nullptr);
+            keywordMatcher.maskFor(resume);
+            publishedStore.replaceResume(resume);
+        }
+        return affected.size();
+    }
+
+public:
+    ArrayDataStorage() : keywordMatcher(publishedStore.getKeywordMatcher()), descriptionIndexDirty(true), matchCacheEnabled(true), jobTreesDirty(true),
+                         jobsReordered(false), resumesReordered(false), indexesReloaded(true) {
+        resetIngestionState();
+    }
+
+    
+    CustomArray<CustomString> buildValidSkillsetFromJobs() {
+        // Unique skills per chunk of jobs, merged in chunk order
+        CustomArray<CustomString> skillset = parallelReduce(0, jobArray.getSize(), 0, CustomArray<CustomString>(),
+            [this](int begin, int end) {
+                CustomArray<CustomString> chunkSkills;
+                for (int i = begin; i < end; i++) mergeUniqueSkills(chunkSkills, jobArray[i].lowerCaseSkills);
+                return chunkSkills;
+            },
+            [](CustomArray<CustomString> acc, const CustomArray<CustomString>& chunkSkills) {
+                mergeUniqueSkills(acc, chunkSkills);
+                return acc;
+            }, "skillset.build");
 
         cout << "Built valid skillset with " << skillset.size() << " unique skills.\n";
         return skillset;
@@ -47,26 +312,143 @@ public:
 
    
     bool loadArrayData(const char* jobFile, const char* resumeFile) {
+        jobArray.clear();
+        resumeArray.clear();
+        resetIngestionState();
+
         CSVReader jobReader(jobFile);
-        CustomArray<CustomString> jobLines = jobReader.readAllLines();
+        CustomArray<CustomString> jobLines = jobReader.readLinesFrom(0, jobFileOffset, true);
         cout << "Loading " << jobLines.size() << " jobs..." << endl;
 
-        for (int i = 0; i < jobLines.size(); i++) {
-            jobArray.push_back(preprocessJobDescription(jobLines[i], i + 1));
-        }
-
-        
-        validSkills = buildValidSkillsetFromJobs();
+        CustomArray<CustomString> newSkills;
+        appendJobs(jobLines, newSkills);
+        cout << "Built valid skillset with " << validSkills.size() << " unique skills.\n";
 
         CSVReader resumeReader(resumeFile);
-        CustomArray<CustomString> resumeLines = resumeReader.readAllLines();
+        CustomArray<CustomString> resumeLines = resumeReader.readLinesFrom(0, resumeFileOffset, true);
         cout << "Loading " << resumeLines.size() << " resumes..." << endl;
 
-        for (int i = 0; i < resumeLines.size(); i++) {
-            resumeArray.push_back(preprocessResumeDescription(resumeLines[i], i + 1, validSkills));
-        }
+        appendResumes(resumeLines);
 
         cout << "Loaded " << jobArray.getSize() << " jobs and " << resumeArray.getSize() << " resumes." << endl;
+        publishSnapshot();
+        return true;
+    }
+
+    // Incremental ingestion: preprocess and append new job rows. Skills that appear
+    // for the first time extend the skillset and only the resumes that listed them
+    // are re-filtered. appendJobs keeps the positions, trees and job indexes
+    // current and the store publishes only the changed chunks, so the cost
+    // follows the new rows; a sort or reload still rebuilds on the next publish.
+    int ingestJobLines(const CustomArray<CustomString>& lines) {
+        CustomArray<CustomString> newSkills;
+        appendJobs(lines, newSkills);
+        int refiltered = refilterResumesForNewSkills(newSkills);
+        cout << "Ingested " << lines.size() << " jobs (" << newSkills.size() << " new skills, "
+             << refiltered << " resumes re-filtered)." << endl;
+        publishSnapshot();
+        return lines.size();
+    }
+
+    int ingestResumeLines(const CustomArray<CustomString>& lines) {
+        appendResumes(lines);
+        cout << "Ingested " << lines.size() << " resumes." << endl;
+        publishSnapshot();
+        return lines.size();
+    }
+
+    // Ingest rows from an in-memory CSV block (one row per line, no header)
+    int ingestJobBuffer(const char* buffer) {
+        return ingestJobLines(splitCSVBuffer(buffer));
+    }
+
+    int ingestResumeBuffer(const char* buffer) {
+        return ingestResumeLines(splitCSVBuffer(buffer));
+    }
+
+    // Ingest rows appended to the CSV files since the last load or ingest
+    int ingestNewRows(const char* jobFile, const char* resumeFile) {
+        CSVReader jobReader(jobFile);
+        CustomArray<CustomString> jobLines = jobReader.readLinesFrom(jobFileOffset, jobFileOffset);
+        CSVReader resumeReader(resumeFile);
+        CustomArray<CustomString> resumeLines = resumeReader.readLinesFrom(resumeFileOffset, resumeFileOffset);
+
+        // Jobs first so new resumes are filtered against the extended skillset
+        int ingested = 0;
+        if (jobLines.size() > 0) ingested += ingestJobLines(jobLines);
+        if (resumeLines.size() > 0) ingested += ingestResumeLines(resumeLines);
+        if (ingested == 0) cout << "No new rows to ingest." << endl;
+        return ingested;
+    }
+
+    // Write the preprocessed jobs, resumes and skillset to a binary snapshot
+    bool saveSnapshot(const char* snapshotFile) const {
+        SnapshotWriter writer;
+        writer.setKeywordMatcher(keywordMatcher);
+        for (int i = 0; i < jobArray.getSize(); i++)
+            writer.addJob(jobArray[i]);
+        for (int i = 0; i < resumeArray.getSize(); i++)
+            writer.addResume(resumeArray[i]);
+        writer.setValidSkills(validSkills);
+        writer.setPendingSkills(pendingResumeSkills);
+        writer.setSourceOffsets(jobFileOffset, resumeFileOffset);
+        // Every publish leaves these current; the lazy ones only if built
+        if (!indexesReloaded && !jobsReordered && !resumesReordered) {
+            writer.addIndex(SNAPSHOT_INDEX_JOB_POSITIONS, jobPositionById);
+            writer.addIndex(SNAPSHOT_INDEX_RESUME_POSITIONS, resumePositionById);
+            writer.addIndex(SNAPSHOT_INDEX_SKILL_TRIE, skillTrie);
+            writer.addIndex(SNAPSHOT_INDEX_SKILL_STATISTICS, skillStatistics);
+            writer.addIndex(SNAPSHOT_INDEX_WEIGHTED_COLUMNS, weightedColumns);
+            writer.addIndex(SNAPSHOT_INDEX_TITLE_TRIGRAMS, titleTrigrams);
+            writer.addIndex(SNAPSHOT_INDEX_JOB_BUCKETS, jobBuckets);
+            if (!descriptionIndexDirty) writer.addIndex(SNAPSHOT_INDEX_DESCRIPTIONS, descriptionIndex);
+        }
+        return writer.write(snapshotFile);
+    }
+
+    // Warm start: restore preprocessed state and indexes from a snapshot
+    // instead of the CSV files
+    bool loadFromSnapshot(const char* snapshotFile) {
+        SnapshotReader reader;
+        if (!reader.open(snapshotFile))
+            return false;
+
+        auto start = chrono::high_resolution_clock::now();
+
+        jobArray.clear();
+        resumeArray.clear();
+        resetIngestionState();
+        jobArray.reserve(reader.getJobCount());
+        resumeArray.reserve(reader.getResumeCount());
+
+        for (int i = 0; i < reader.getJobCount(); i++) {
+            jobArray.push_back(reader.readJob(i, &keywordMatcher));
+            nextJobId = max(nextJobId, jobArray[i].id + 1);
+        }
+        for (int i = 0; i < reader.getResumeCount(); i++) {
+            resumeArray.push_back(reader.readResume(i, &keywordMatcher));
+            nextResumeId = max(nextResumeId, resumeArray[i].id + 1);
+        }
+        fillKeywordMasks();     // only rows the snapshot had no mask for
+        for (int i = 0; i < jobArray.getSize(); i++) publishedStore.appendJob(jobArray[i]);
+        for (int i = 0; i < resumeArray.getSize(); i++) publishedStore.appendResume(resumeArray[i]);
+        validSkills = reader.readValidSkills();
+        for (int i = 0; i < validSkills.size(); i++) {
+            validSkillIndex.insert(validSkills[i], i);
+            publishedStore.appendSkill(validSkills[i]);
+        }
+        reader.readPendingSkills(pendingResumeSkills);
+        jobFileOffset = reader.getJobSourceOffset();
+        resumeFileOffset = reader.getResumeSourceOffset();
+        if (restoreIndexes(reader)) indexesReloaded = false;
+
+        auto end = chrono::high_resolution_clock::now();
+        auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
+
+        cout << "Loaded " << jobArray.getSize() << " jobs and " << resumeArray.getSize()
+             << " resumes from snapshot in " << duration.count() << " ms"
+             << (indexesReloaded ? " (indexes rebuilt)." : ".") << endl;
+        publishSnapshot();
         return true;
     }
 
@@ -92,10 +474,13 @@ public:
 
    
     void bubbleSortJobsByTitle() {
+        INSTRUMENT_SCOPE("sort.jobs.title.bubble");
         int n = jobArray.getSize();
+        markJobsReordered();
         cout << "Sorting " << n << " jobs by title... This may take a moment." << endl;
         
         auto start = chrono::high_resolution_clock::now();
+        long long comparisons = 0, swaps = 0;
         
         for (int i = 0; i < n - 1; i++) {
             bool swapped = false;
@@ -105,12 +490,14 @@ public:
                 cout << "Progress: " << (i * 100) / (n - 1) << "%" << endl;
             }
             
+            comparisons += n - i - 1;
             for (int j = 0; j < n - i - 1; j++) {
                 if (strcmp(jobArray[j].jobTitle.c_str(), jobArray[j + 1].jobTitle.c_str()) > 0) {
                     Job temp = jobArray[j];
                     jobArray[j] = jobArray[j + 1];
                     jobArray[j + 1] = temp;
                     swapped = true;
+                    swaps++;
                 }
             }
             
@@ -123,15 +510,22 @@ public:
         
         auto end = chrono::high_resolution_clock::now();
         auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
+        INSTRUMENT_COUNT(COUNTER_COMPARISONS, comparisons);
+        INSTRUMENT_COUNT(COUNTER_STRCMP, comparisons);
+        INSTRUMENT_COUNT(COUNTER_SWAPS, swaps);
         
         cout << "Sorting complete! Time taken: " << duration.count() << " ms" << endl;
+        publishSnapshot();
     }
 
     void bubbleSortJobsBySkillCount() {
+        INSTRUMENT_SCOPE("sort.jobs.skillCount.bubble");
         int n = jobArray.getSize();
+        markJobsReordered();
         cout << "Sorting " << n << " jobs by skill count... This may take a moment." << endl;
         
         auto start = chrono::high_resolution_clock::now();
+        long long comparisons = 0, swaps = 0;
         
         for (int i = 0; i < n - 1; i++) {
             bool swapped = false;
@@ -141,12 +535,14 @@ public:
                 cout << "Progress: " << (i * 100) / (n - 1) << "%" << endl;
             }
             
+            comparisons += n - i - 1;
             for (int j = 0; j < n - i - 1; j++) {
                 if (jobArray[j].skillCount > jobArray[j + 1].skillCount) {
                     Job temp = jobArray[j];
                     jobArray[j] = jobArray[j + 1];
                     jobArray[j + 1] = temp;
                     swapped = true;
+                    swaps++;
                 }
             }
             
@@ -159,15 +555,21 @@ public:
         
         auto end = chrono::high_resolution_clock::now();
         auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
+        INSTRUMENT_COUNT(COUNTER_COMPARISONS, comparisons);
+        INSTRUMENT_COUNT(COUNTER_SWAPS, swaps);
         
         cout << "Sorting complete! Time taken: " << duration.count() << " ms" << endl;
+        publishSnapshot();
     }
 
     void bubbleSortResumesBySkillCount() {
+        INSTRUMENT_SCOPE("sort.resumes.skillCount.bubble");
         int n = resumeArray.getSize();
+        resumesReordered = true;
         cout << "Sorting " << n << " resumes by skill count... This may take a moment." << endl;
         
         auto start = chrono::high_resolution_clock::now();
+        long long comparisons = 0, swaps = 0;
         
         for (int i = 0; i < n - 1; i++) {
             bool swapped = false;
@@ -177,12 +579,14 @@ public:
                 cout << "Progress: " << (i * 100) / (n - 1) << "%" << endl;
             }
             
+            comparisons += n - i - 1;
             for (int j = 0; j < n - i - 1; j++) {
                 if (resumeArray[j].skillCount > resumeArray[j + 1].skillCount) {
                     Resume temp = resumeArray[j];
                     resumeArray[j] = resumeArray[j + 1];
                     resumeArray[j + 1] = temp;
                     swapped = true;
+                    swaps++;
                 }
             }
             
@@ -195,105 +599,44 @@ public:
         
         auto end = chrono::high_resolution_clock::now();
         auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
+        INSTRUMENT_COUNT(COUNTER_COMPARISONS, comparisons);
+        INSTRUMENT_COUNT(COUNTER_SWAPS, swaps);
         
         cout << "Sorting complete! Time taken: " << duration.count() << " ms" << endl;
+        publishSnapshot();
     }
 
-    // QuickSort implementation for jobs by skill count
+    // QuickSort implementation for jobs by skill count (parallel introsort)
     void quickSortJobsBySkillCount() {
-        quickSortJobsBySkillCountHelper(0, jobArray.getSize() - 1);
-    }
-
-private:
-    void quickSortJobsBySkillCountHelper(int low, int high) {
-        if (low < high) {
-            int pivotIndex = partitionJobsBySkillCount(low, high);
-            quickSortJobsBySkillCountHelper(low, pivotIndex - 1);
-            quickSortJobsBySkillCountHelper(pivotIndex + 1, high);
-        }
-    }
-
-    int partitionJobsBySkillCount(int low, int high) {
-        int pivot = jobArray[high].skillCount;
-        int i = low - 1;
-        
-        for (int j = low; j < high; j++) {
-            if (jobArray[j].skillCount <= pivot) {
-                i++;
-                Job temp = jobArray[i];
-                jobArray[i] = jobArray[j];
-                jobArray[j] = temp;
-            }
-        }
-        
-        Job temp = jobArray[i + 1];
-        jobArray[i + 1] = jobArray[high];
-        jobArray[high] = temp;
-        
-        return i + 1;
+        markJobsReordered();
+        parallelIntroSort(jobArray.getData(), jobArray.getSize(), JobSkillCountLess(), "sort.jobs.skillCount");
+        publishSnapshot();
     }
 
-public:
-    // MergeSort implementation for jobs by skill count
+    // MergeSort implementation for jobs by skill count (stable, halves sorted in parallel)
     void mergeSortJobsBySkillCount() {
-        mergeSortJobsBySkillCountHelper(0, jobArray.getSize() - 1);
+        markJobsReordered();
+        parallelSort(jobArray.getData(), jobArray.getSize(), JobSkillCountLess(), jobSortBuffer,
+                     "sort.jobs.skillCount");
+        publishSnapshot();
     }
 
-private:
-    void mergeSortJobsBySkillCountHelper(int left, int right) {
-        if (left < right) {
-            int mid = left + (right - left) / 2;
-            mergeSortJobsBySkillCountHelper(left, mid);
-            mergeSortJobsBySkillCountHelper(mid + 1, right);
-            mergeJobsBySkillCount(left, mid, right);
-        }
+    // Sort jobs by any key, e.g. sortJobsBy(JobTitleLess(), true). Stable sorts
+    // use the merge sort, otherwise the introsort.
+    template<typename Less>
+    void sortJobsBy(Less less, bool stable, const char* label = "sort.jobs") {
+        markJobsReordered();
+        if (stable) parallelSort(jobArray.getData(), jobArray.getSize(), less, jobSortBuffer, label);
+        else parallelIntroSort(jobArray.getData(), jobArray.getSize(), less, label);
+        publishSnapshot();
     }
 
-    void mergeJobsBySkillCount(int left, int mid, int right) {
-        int n1 = mid - left + 1;
-        int n2 = right - mid;
-        
-        // Create temporary arrays
-        Job* leftArray = new Job[n1];
-        Job* rightArray = new Job[n2];
-        
-        // Copy data to temporary arrays
-        for (int i = 0; i < n1; i++) {
-            leftArray[i] = jobArray[left + i];
-        }
-        for (int j = 0; j < n2; j++) {
-            rightArray[j] = jobArray[mid + 1 + j];
-        }
-        
-        // Merge the temporary arrays back
-        int i = 0, j = 0, k = left;
-        
-        while (i < n1 && j < n2) {
-            if (leftArray[i].skillCount <= rightArray[j].skillCount) {
-                jobArray[k] = leftArray[i];
-                i++;
-            } else {
-                jobArray[k] = rightArray[j];
-                j++;
-            }
-            k++;
-        }
-        
-        // Copy remaining elements
-        while (i < n1) {
-            jobArray[k] = leftArray[i];
-            i++;
-            k++;
-        }
-        while (j < n2) {
-            jobArray[k] = rightArray[j];
-            j++;
-            k++;
-        }
-        
-        // Clean up temporary arrays
-        delete[] leftArray;
-        delete[] rightArray;
+    template<typename Less>
+    void sortResumesBy(Less less, bool stable, const char* label = "sort.resumes") {
+        resumesReordered = true;
+        if (stable) parallelSort(resumeArray.getData(), resumeArray.getSize(), less, resumeSortBuffer, label);
+        else parallelIntroSort(resumeArray.getData(), resumeArray.getSize(), less, label);
+        publishSnapshot();
     }
 
 public:
@@ -376,15 +719,72 @@ public:
     }
 
    
-    // Simple keyword-based score based on full descriptions
-    int calculateKeywordOverlapScore(const Job& job, const Resume& resume) {
-        return calculateMatchScore(job.fullDescription, resume.fullDescription);
+    // === Indexed views (B+-trees) ===
+    // Row positions in key order without reordering jobArray; each view keeps
+    // its own order, so switching views does not re-sort the jobs.
+    void queryJobsByTitleIndexed(const CustomString& title, QueryResult& out) {
+        out.clear();
+        ensureJobTrees();
+        jobTitleTree.find(title.c_str() ? title.c_str() : "", out.indices);
+    }
+
+    void queryJobsByCategory(const CustomString& category, QueryResult& out) {
+        out.clear();
+        int code = jobCategoryCode(category.c_str());
+        if (code < 0) return;
+        ensureJobTrees();
+        jobCategoryTree.find(code, out.indices);
+    }
+
+    void queryJobsByPriorityRange(int low, int high, QueryResult& out) {
+        out.clear();
+        ensureJobTrees();
+        jobPriorityTree.range(low, high, out.indices);
+    }
+
+    void queryJobsBySkillCountRange(int low, int high, QueryResult& out) {
+        out.clear();
+        ensureJobTrees();
+        jobSkillCountTree.range(low, high, out.indices);
+    }
+
+    // Row of the job with id, -1 if none
+    int findJobRowById(int id) const {
+        const int* position = jobPositionById.find(id);
+        return position ? *position : -1;
+    }
+
+    // Up to limit rows from offset in the order of one index (a paged view)
+    void queryJobsOrderedBy(const char* field, int offset, int limit, QueryResult& out) {
+        out.clear();
+        ensureJobTrees();
+        if (strcmp(field, "title") == 0) collectOrderedRows(jobTitleTree, offset, limit, out.indices);
+        else if (strcmp(field, "category") == 0) collectOrderedRows(jobCategoryTree, offset, limit, out.indices);
+        else if (strcmp(field, "priority") == 0) collectOrderedRows(jobPriorityTree, offset, limit, out.indices);
+        else if (strcmp(field, "skillCount") == 0) collectOrderedRows(jobSkillCountTree, offset, limit, out.indices);
+        else if (strcmp(field, "id") == 0) collectOrderedRows(jobIdTree, offset, limit, out.indices);
     }
 
-    // Rank all jobs for a given resume using keyword overlap (bubble sort)
+    template<typename KeyTraits>
+    static void collectOrderedRows(const BPlusTreeIndex<KeyTraits>& tree, int offset, int limit, CustomArray<int>& rows) {
+        int position = 0;
+        for (typename BPlusTreeIndex<KeyTraits>::Cursor cursor = tree.begin(); cursor.valid() && rows.size() < limit; cursor.next(), position++) {
+            if (position >= offset) rows.push_back(cursor.row());
+        }
+    }
+
+    // Simple keyword-based score based on full descriptions (cached keyword masks)
+    int calculateKeywordOverlapScore(Job& job, const Resume& resume) {
+        return KeywordMatcher::score(keywordMatcher.maskFor(job), keywordMatcher.maskFor(resume));
+    }
+
+    // Rank all jobs for a given resume using keyword overlap (bubble sort).
+    // Reorders the store; queryTopJobsByKeywords gives the same ranking read-only.
     void rankJobsForResumeByKeywords(const Resume& resume) {
+        markJobsReordered();
+        unsigned long long resumeMask = keywordMatcher.maskFor(resume);
         for (int i = 0; i < jobArray.getSize(); i++) {
-            jobArray[i].matchScore = static_cast<double>(calculateKeywordOverlapScore(jobArray[i], resume));
+            jobArray[i].matchScore = static_cast<double>(KeywordMatcher::score(keywordMatcher.maskFor(jobArray[i]), resumeMask));
         }
         int n = jobArray.getSize();
         for (int i = 0; i < n - 1; i++) {
@@ -396,6 +796,18 @@ public:
                 }
             }
         }
+        publishSnapshot();
+    }
+
+    // Constant-time lookups by id through the position indexes
+    Job* findJobById(int id) {
+        int position = findJobRowById(id);
+        return position >= 0 ? &jobArray[position] : nullptr;
+    }
+
+    Resume* findResumeById(int id) {
+        int position = findResumePosition(id);
+        return position >= 0 ? &resumeArray[position] : nullptr;
     }
 
     // Linear search for a resume by id
@@ -406,70 +818,181 @@ public:
         return nullptr;
     }
 
-    // Search jobs by skill
-    CustomArrayV2<Job> searchJobsBySkill(const CustomString& skill) {
-        CustomArrayV2<Job> results;
-        CustomString lowerSkill = convertToLowerCase(skill);
-        
-        for (int i = 0; i < jobArray.getSize(); i++) {
-            const Job& job = jobArray[i];
-            for (int j = 0; j < job.skills.size(); j++) {
-                CustomString jobSkill = convertToLowerCase(job.skills[j]);
-                if (strcmp(jobSkill.c_str(), lowerSkill.c_str()) == 0) {
-                    results.push_back(job);
-                    break; // Found the skill, no need to check other skills for this job
-                }
-            }
-        }
-        return results;
+    // Search jobs by skill (copies the matches; queryJobsBySkill returns positions instead)
+    CustomArrayV2<Job> searchJobsBySkill(const CustomString& skill) const {
+        QueryResult matches;
+        queryJobsBySkill(skill, matches);
+        return copyJobs(matches);
     }
 
-    // Search resumes by skill
-    CustomArrayV2<Resume> searchResumesBySkill(const CustomString& skill) {
+    // Search resumes by skill (copies the matches; queryResumesBySkill returns positions instead)
+    CustomArrayV2<Resume> searchResumesBySkill(const CustomString& skill) const {
+        QueryResult matches;
+        queryResumesBySkill(skill, matches);
         CustomArrayV2<Resume> results;
-        CustomString lowerSkill = convertToLowerCase(skill);
-        
-        for (int i = 0; i < resumeArray.getSize(); i++) {
-            const Resume& resume = resumeArray[i];
-            for (int j = 0; j < resume.resumeSkills.size(); j++) {
-                CustomString resumeSkill = convertToLowerCase(resume.resumeSkills[j]);
-                if (strcmp(resumeSkill.c_str(), lowerSkill.c_str()) == 0) {
-                    results.push_back(resume);
-                    break; // Found the skill, no need to check other skills for this resume
-                }
-            }
-        }
+        results.reserve(matches.size());
+        for (int i = 0; i < matches.size(); i++) results.push_back(resumeArray[matches.indices[i]]);
         return results;
     }
 
     // Filter jobs whose title contains a keyword (case-insensitive using stored lowerCaseTitle)
     CustomArrayV2<Job> filterJobsByTitleKeyword(const CustomString& keyword) const {
-        CustomArrayV2<Job> results;
-        CustomString lowerKey = convertToLowerCase(keyword);
-        for (int i = 0; i < jobArray.getSize(); i++) {
-            const Job& j = jobArray[i];
-            if (j.lowerCaseTitle.c_str() && lowerKey.c_str() && strstr(j.lowerCaseTitle.c_str(), lowerKey.c_str())) {
-                results.push_back(j);
-            }
+        QueryResult matches;
+        queryJobsByTitleKeyword(keyword, matches);
+        return copyJobs(matches);
+    }
+
+    // === Read-only queries ===
+    // Results hold positions into getJobArray()/getResumeArray() and stay valid
+    // until the store is sorted or reloaded. The store itself is never modified.
+    void queryJobsByTitle(const CustomString& title, QueryResult& out) const {
+        ::queryJobsByTitle(jobArray, title, out);
+    }
+
+    void queryJobsBySkill(const CustomString& skill, QueryResult& out) const {
+        ::queryJobsBySkill(jobArray, skill, out);
+    }
+
+    void queryResumesBySkill(const CustomString& skill, QueryResult& out) const {
+        ::queryResumesBySkill(resumeArray, skill, out);
+    }
+
+    // Jobs and resumes with a skill of the valid skillset
+    void queryJobsBySkillId(int skillId, QueryResult& out) const {
+        ::queryJobsBySkill(jobArray, validSkills[skillId], out);
+    }
+
+    void queryResumesBySkillId(int skillId, QueryResult& out) const {
+        ::queryResumesBySkill(resumeArray, validSkills[skillId], out);
+    }
+
+    // Through the trigram index; keywords under three letters scan every title
+    void queryJobsByTitleKeyword(const CustomString& keyword, QueryResult& out) const {
+        titleTrigrams.query(jobArray, convertToLowerCase(keyword), out);
+    }
+
+    const TrigramIndex& getTitleTrigrams() const { return titleTrigrams; }
+
+    // === Skill lookup ===
+    // Ids are positions in the valid skillset. Resolving takes the exact skill
+    // ignoring case, else the closest one within skillEditBound edits.
+    int resolveSkillId(const CustomString& text) const {
+        return skillTrie.resolve(text, skillEditBound(text.size()));
+    }
+
+    // Up to limit skill ids starting with prefix, in lexicographic order
+    void completeSkill(const CustomString& prefix, int limit, CustomArray<int>& ids) const {
+        skillTrie.complete(prefix, limit, ids);
+    }
+
+    const CustomString& getSkillName(int skillId) const { return validSkills[skillId]; }
+    const SkillTrie& getSkillTrie() const { return skillTrie; }
+
+    // Rankings of stored resumes are cached until the next publish
+    void queryTopJobsForResume(const Resume& resume, int topN, QueryResult& out) const {
+        cachedRanking(resume, WeightedScorer::label(), topN, out, [&](QueryResult& result) {
+            queryTopJobsByWeightedScore(weightedColumns, jobArray, resume, topN, result);
+        });
+    }
+
+    void queryTopJobsByKeywords(const Resume& resume, int topN, QueryResult& out) const {
+        cachedRanking(resume, KeywordScorer::label(), topN, out, [&](QueryResult& result) {
+            ::queryTopJobsByKeywords(jobArray, resume, keywordMatcher, topN, result);
+        });
+    }
+
+    // Top jobs under any scoring policy from scoring.hpp
+    template<typename Scorer>
+    void queryTopJobsWith(const Resume& resume, Scorer& scorer, int topN, QueryResult& out) const {
+        queryTopJobs(jobArray, resume, scorer, topN, false, out);
+    }
+
+    // === Filtered queries ===
+    // Only the jobs of the (category, priority) buckets filter selects are
+    // scanned or scored; results are positions in store order, as a full scan
+    // with the same filter would give.
+    void queryJobsInBuckets(const JobFilter& filter, QueryResult& out) const {
+        out.clear();
+        jobBuckets.select(filter, out.indices);
+    }
+
+    void queryJobsBySkillFiltered(const CustomString& skill, const JobFilter& filter, QueryResult& out) const {
+        if (filter.isAny()) {
+            queryJobsBySkill(skill, out);
+            return;
+        }
+        out.clear();
+        CustomString lowerSkill = convertToLowerCase(skill);
+        if (lowerSkill.c_str() == nullptr) return;
+        CustomArray<int> rows;
+        jobBuckets.select(filter, rows);
+        for (int i = 0; i < rows.size(); i++) {
+            if (hasLowerCaseSkill(jobArray[rows[i]].lowerCaseSkills, lowerSkill)) out.indices.push_back(rows[i]);
         }
-        return results;
     }
 
-    void findTopMatchesForResume(const Resume& resume, int topN = 5) {
+    template<typename Scorer>
+    void queryTopJobsFiltered(const Resume& resume, Scorer& scorer, const JobFilter& filter, int topN, QueryResult& out) const {
+        if (filter.isAny()) {
+            queryTopJobsWith(resume, scorer, topN, out);
+            return;
+        }
+        CustomArray<int> rows;
+        jobBuckets.select(filter, rows);
+        queryTopJobsInRows(jobArray, rows, resume, scorer, topN, false, out);
+    }
+
+    // Weighted ranking through the score columns, like queryTopJobsForResume
+    void queryTopJobsForResumeFiltered(const Resume& resume, const JobFilter& filter, int topN, QueryResult& out) const {
+        if (filter.isAny()) {
+            queryTopJobsForResume(resume, topN, out);
+            return;
+        }
+        CustomArray<int> rows;
+        jobBuckets.select(filter, rows);
+        queryTopJobsByWeightedScoreInRows(weightedColumns, jobArray, rows, resume, topN, out);
+    }
+
+    int countJobsInBuckets(const JobFilter& filter) const { return jobBuckets.count(filter); }
+
+    const KeywordMatcher& getKeywordMatcher() const { return keywordMatcher; }
+    const SkillStatistics& getSkillStatistics() const { return skillStatistics; }
+
+    // Top jobs by BM25 over skills, idf from the skill statistics of the last publish
+    void queryTopJobsBySkillBM25(const Resume& resume, int topN, QueryResult& out) const {
+        cachedRanking(resume, BM25Scorer::label(), topN, out, [&](QueryResult& result) {
+            BM25Scorer scorer(skillStatistics);
+            queryTopJobsWith(resume, scorer, topN, result);
+        });
+    }
+
+    MatchCacheStats getMatchCacheStats() const { return matchCache.getStats(); }
+    void setMatchCacheEnabled(bool enabled) { matchCacheEnabled = enabled; }
+
+    // Description index of the current jobs, built on first use after a sort or reload
+    const DescriptionIndex& getDescriptionIndex() {
+        if (descriptionIndexDirty) {
+            descriptionIndex.build(jobArray);
+            descriptionIndexDirty = false;
+        }
+        return descriptionIndex;
+    }
+
+    // Top jobs by BM25 of the resume's description words against job
+    // descriptions (WAND). Returns the number of jobs fully scored.
+    int queryTopJobsByDescription(const Resume& resume, int topN, QueryResult& out) {
+        return getDescriptionIndex().search(resume, topN, out);
+    }
+
+    void findTopMatchesForResume(const Resume& resume, int topN = 5) const {
+        INSTRUMENT_SCOPE("query.findTopMatchesForResume");
         cout << "\n=== Finding Job Matches for Resume " << resume.id << " ===" << endl;
         cout << "Processing " << jobArray.getSize() << " jobs..." << endl;
         
         auto start = chrono::high_resolution_clock::now();
         
-        CustomArrayV2<Job> matches;
-        for (int i = 0; i < jobArray.getSize(); i++) {
-            Job job = jobArray[i];
-            job.matchScore = calculateWeightedMatchScore(job, resume);
-            matches.push_back(job);
-        }
-
-        // Sort by match score (QuickSort for better performance)
-        quickSortJobsByMatchScore(matches, 0, matches.getSize() - 1);
+        QueryResult matches;
+        queryTopJobsForResume(resume, topN, matches);
         
         auto end = chrono::high_resolution_clock::now();
         auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
@@ -483,104 +1006,127 @@ public:
         cout << endl << endl;
         
         // Display top N different jobs with full details
-        int displayed = 0;
-        for (int i = 0; i < matches.getSize() && displayed < topN; i++) {
-            cout << "Match " << (displayed + 1) << ":" << endl;
-            cout << "Job ID: " << matches[i].id << endl;
-            cout << "Title: " << matches[i].jobTitle << endl;
-            cout << "Skills (" << matches[i].skillCount << "): ";
-            for (int j = 0; j < matches[i].skills.size(); j++) {
-                cout << matches[i].skills[j];
-                if (j < matches[i].skills.size() - 1) cout << ", ";
+        for (int i = 0; i < matches.size(); i++) {
+            const Job& job = jobArray[matches.indices[i]];
+            cout << "Match " << (i + 1) << ":" << endl;
+            cout << "Job ID: " << job.id << endl;
+            cout << "Title: " << job.jobTitle << endl;
+            cout << "Skills (" << job.skillCount << "): ";
+            for (int j = 0; j < job.skills.size(); j++) {
+                cout << job.skills[j];
+                if (j < job.skills.size() - 1) cout << ", ";
             }
             cout << endl;
-            cout << "Category: " << matches[i].jobCategory << endl;
-            cout << "Priority: " << matches[i].priority << endl;
-            cout << "Match Score: " << fixed << setprecision(6) << matches[i].matchScore << endl;
+            cout << "Category: " << job.jobCategory << endl;
+            cout << "Priority: " << job.priority << endl;
+            cout << "Match Score: " << fixed << setprecision(6) << matches.scores[i] << endl;
             cout << "---" << endl;
-            displayed++;
         }
         
         cout << "\nJob matching completed in: " << duration.count() << " ms" << endl;
     }
 
+    // Top topK jobs of every resume into filename, through the asynchronous
+    // writer. Bypasses the match cache. Returns the number of rows written, or
+    // -1 if the file could not be written.
+    long long writeAllMatches(const char* filename, int topK, MatchOutputFormat format) const {
+        MatchOutputWriter writer;
+        if (!writer.open(filename, format)) return -1;
+
+        auto start = chrono::high_resolution_clock::now();
+        QueryResult matches;
+        CustomArray<MatchRecord> rows;
+        for (int r = 0; r < resumeArray.getSize(); r++) {
+            queryTopJobsByWeightedScore(weightedColumns, jobArray, resumeArray[r], topK, matches);
+            rows.clear();
+            for (int i = 0; i < matches.size(); i++) {
+                MatchRecord row = {resumeArray[r].id, jobArray[matches.indices[i]].id, i + 1, 0, matches.scores[i]};
+                rows.push_back(row);
+            }
+            if (!rows.empty()) writer.append(&rows[0], rows.size());
+        }
+        auto scored = chrono::high_resolution_clock::now();
+        bool ok = writer.close();
+        auto end = chrono::high_resolution_clock::now();
+
+        cout << "Wrote " << writer.getRowsWritten() << " rows (" << writer.getBytesWritten() << " bytes) to "
+             << filename << endl;
+        cout << "Scoring: " << chrono::duration_cast<chrono::milliseconds>(scored - start).count() << " ms, writer stalls: "
+             << writer.getStallMs() << " ms, final drain: "
+             << chrono::duration_cast<chrono::milliseconds>(end - scored).count() << " ms" << endl;
+        if (!ok) {
+            cerr << "Error: Writing " << filename << " failed" << endl;
+            return -1;
+        }
+        return writer.getRowsWritten();
+    }
+
+    // === Concurrent readers ===
+    // Publish the current arrays as a new immutable version. Called after every
+    // load, ingest and sort; readers pinned to older versions are unaffected.
+    // Loads and ingests have already handed their rows to the store and the
+    // indexes, a sort only passes on the new order: position-keyed indexes are
+    // remapped or rebuilt here, and after a reload everything is built in full.
+    unsigned long long publishSnapshot() {
+        if (jobsReordered) {
+            publishedStore.reorderJobs([&](auto visit) {
+                for (int i = 0; i < jobArray.getSize(); i++) visit(jobArray[i]);
+            });
+        }
+        if (resumesReordered) {
+            publishedStore.reorderResumes([&](auto visit) {
+                for (int i = 0; i < resumeArray.getSize(); i++) visit(resumeArray[i]);
+            });
+        }
+        if (indexesReloaded) {
+            titleTrigrams.build(jobArray);
+            skillTrie.build(validSkills);
+            weightedColumns.build(jobArray);
+            skillStatistics.build(jobArray);
+            descriptionIndexDirty = true;
+        } else if (jobsReordered) {
+            CustomArray<int> jobMoves;
+            collectJobMoves(jobMoves);
+            titleTrigrams.remap(jobMoves);
+            weightedColumns.remap(jobMoves);
+            descriptionIndexDirty = true;
+        }
+        if (jobsReordered || indexesReloaded) {
+            rebuildJobPositions();
+            jobBuckets.build([&](auto visit) {
+                for (int i = 0; i < jobArray.getSize(); i++) visit(jobArray[i], i);
+            });
+        }
+        if (resumesReordered || indexesReloaded) rebuildResumePositions();
+        jobsReordered = false;
+        resumesReordered = false;
+        indexesReloaded = false;
+        return publishedStore.publish();
+    }
+
+    VersionedJobStore& getPublishedStore() { return publishedStore; }
+
     // === Getters ===
     CustomArrayV2<Job>& getJobArray() { return jobArray; }
     CustomArrayV2<Resume>& getResumeArray() { return resumeArray; }
+    const CustomArrayV2<Job>& getJobArray() const { return jobArray; }
+    const CustomArrayV2<Resume>& getResumeArray() const { return resumeArray; }
 
-    // QuickSort for job matching (by match score)
+    // Sort jobs[low..high] by match score, highest first
     void quickSortJobsByMatchScore(CustomArrayV2<Job>& jobs, int low, int high) {
-        if (low < high) {
-            int pivotIndex = partitionJobsByMatchScore(jobs, low, high);
-            quickSortJobsByMatchScore(jobs, low, pivotIndex - 1);
-            quickSortJobsByMatchScore(jobs, pivotIndex + 1, high);
-        }
-    }
-    
-    int partitionJobsByMatchScore(CustomArrayV2<Job>& jobs, int low, int high) {
-        double pivot = jobs[high].matchScore;
-        int i = low - 1;
-        for (int j = low; j < high; j++) {
-            if (jobs[j].matchScore >= pivot) { // Descending order
-                i++;
-                Job temp = jobs[i];
-                jobs[i] = jobs[j];
-                jobs[j] = temp;
-            }
-        }
-        Job temp = jobs[i + 1];
-        jobs[i + 1] = jobs[high];
-        jobs[high] = temp;
-        return i + 1;
+        if (low < 0 || high >= jobs.getSize() || low >= high) return;
+        parallelIntroSort(jobs.getData() + low, high - low + 1, JobMatchScoreGreater(), "sort.jobs.matchScore");
     }
 
 private:
+    CustomArrayV2<Job> copyJobs(const QueryResult& matches) const {
+        CustomArrayV2<Job> results;
+        results.reserve(matches.size());
+        for (int i = 0; i < matches.size(); i++) results.push_back(jobArray[matches.indices[i]]);
+        return results;
+    }
+
     double calculateWeightedMatchScore(const Job& job, const Resume& resume) {
-        int matchCount = 0;
-        int resumeSkillsUsed = 0;
-        
-        // Count matching skills
-        for (int i = 0; i < job.skills.size(); i++) {
-            for (int j = 0; j < resume.resumeSkills.size(); j++) {
-                if (strcmp(job.skills[i].c_str(), resume.resumeSkills[j].c_str()) == 0) {
-                    matchCount++;
-                    break; // Found match, move to next job skill
-                }
-            }
-        }
-        
-        // Count how many resume skills are utilized
-        for (int j = 0; j < resume.resumeSkills.size(); j++) {
-            for (int i = 0; i < job.skills.size(); i++) {
-                if (strcmp(resume.resumeSkills[j].c_str(), job.skills[i].c_str()) == 0) {
-                    resumeSkillsUsed++;
-                    break; // Found match, move to next resume skill
-                }
-            }
-        }
-        
-        if (job.skills.size() == 0 || resume.resumeSkills.size() == 0)
-            return 0.0;
-        
-        // Calculate base score (job skill coverage)
-        double jobCoverage = (double)matchCount / job.skills.size();
-        
-        // Calculate resume utilization bonus
-        double resumeUtilization = (double)resumeSkillsUsed / resume.resumeSkills.size();
-        
-        // Calculate total matching skills bonus (more matches = higher score)
-        double matchBonus = (double)matchCount / max(job.skills.size(), resume.resumeSkills.size());
-        
-        // Calculate skill density bonus (jobs with more skills get slight bonus)
-        double skillDensityBonus = (double)job.skills.size() / 10.0; // Normalize to 0-1 range
-        
-        // Weighted combination: 40% job coverage + 25% resume utilization + 20% match bonus + 15% skill density
-        double finalScore = (0.4 * jobCoverage) + (0.25 * resumeUtilization) + (0.2 * matchBonus) + (0.15 * skillDensityBonus);
-        
-        // Add tiny tie-breaker based on job ID to ensure different scores
-        double tieBreaker = (double)job.id / 100000.0; // Very small adjustment
-        finalScore += tieBreaker;
-        
-        return finalScore;
+        return ::calculateWeightedMatchScore(job, resume);
     }
 };
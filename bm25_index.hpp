@@ -0,0 +1,652 @@
+#pragma once
+#include "model.hpp"
+#include "array.hpp"
+#include "hashmap.hpp"
+#include "simd_text.hpp"
+#include "query.hpp"
+#include "snapshot_section.hpp"
+#include <cmath>
+#include <climits>
+
+using namespace std;
+
+// BM25 inverted index over job descriptions.
+//
+// Terms are the lower-cased alphabetic runs of fullDescription, the same words
+// countWords counts. Each term's postings (job position, term frequency) are
+// delta + varint encoded in one byte array, in blocks of POSTING_BLOCK entries
+// with a skip entry (last job, byte offset) per block. Queries take the
+// distinct words of a resume's description and run MaxScore: once the top k
+// fill up, the terms whose summed upper bounds can't beat the k-th score stop
+// producing candidates and are only probed for jobs that still could. Probes
+// jump over whole blocks, so the long postings of common words are mostly never
+// decoded. Results equal the exhaustive ranking (searchExhaustive), ties kept
+// in job order.
+//
+// Ingest appends: the new jobs' postings go to a delta segment per term,
+// after the compressed ones, and are compressed into blocks once they hold a
+// quarter as many postings. Collection statistics are running totals; idf and
+// length norms are worked out from them at query time with the same
+// expressions a build uses, so scores equal those of a fresh build. A term's
+// upper bound is its compressed maximum, scaled by how far the average length
+// has moved since (norms shrink by at most that factor), or the bound of its
+// delta postings if higher.
+
+const double BM25_K1 = 1.2;
+const double BM25_B = 0.75;
+const int POSTING_BLOCK = 64;
+
+// Call fn(word, length) for each lower-cased alphabetic run of text
+template<typename Fn>
+void forEachLowerWord(const CustomString& text, CustomArray<char>& buffer, Fn fn) {
+    int len = text.size();
+    if (text.c_str() == nullptr || len == 0) return;
+    buffer.resize(len);
+    asciiLowerCopy(&buffer[0], text.c_str(), len);
+    const char* lower = &buffer[0];
+    int i = 0;
+    while (i < len) {
+        while (i < len && !asciiAlpha(lower[i])) i++;
+        int start = i;
+        while (i < len && asciiAlpha(lower[i])) i++;
+        if (i > start) fn(lower + start, i - start);
+    }
+}
+
+inline void appendVarint(CustomArray<unsigned char>& out, unsigned int value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+inline unsigned int readVarint(const unsigned char*& p) {
+    unsigned int value = 0;
+    int shift = 0;
+    while (*p & 0x80) {
+        value |= static_cast<unsigned int>(*p++ & 0x7F) << shift;
+        shift += 7;
+    }
+    value |= static_cast<unsigned int>(*p++) << shift;
+    return value;
+}
+
+// readVarint for untrusted bytes: false if the value runs past end or 32 bits
+inline bool readVarintChecked(const unsigned char*& p, const unsigned char* end, unsigned int& value) {
+    value = 0;
+    for (int shift = 0; shift < 35 && p < end; shift += 7) {
+        unsigned char byte = *p++;
+        value |= static_cast<unsigned int>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+class DescriptionIndex {
+private:
+    CustomHashMap<CustomString, int> termIds;
+    CustomArray<int> postingStart;        // byte offset of each term's postings, plus an end marker
+    CustomArray<int> blockStart;          // first skip entry of each term, plus an end marker
+    CustomArray<int> blockLastDoc;        // skip entries: last job in the block
+    CustomArray<int> blockOffset;         //               byte offset of the block
+    CustomArray<int> documentFrequency;   // compressed and delta postings
+    CustomArray<int> packedCount;         // compressed postings per term
+    CustomArray<double> packedBound;      // highest tf part of a compressed posting, idf aside
+    CustomArray<unsigned char> postingBytes;
+    CustomArray<CustomArray<int>> deltaDocs;    // postings appended since the last compression
+    CustomArray<CustomArray<int>> deltaFreqs;
+    CustomArray<int> deltaMaxFreq;
+    CustomArray<int> deltaMinLength;
+    CustomArray<int> documentLength;      // words per job
+    int packedPostings;
+    int deltaPostings;
+    int documents;
+    long long totalLength;
+    double averageLength;
+    double packedAverageLength;           // averageLength when packedBound was taken
+
+    // Decodes one term's postings, skipping whole blocks when advancing; the
+    // delta postings follow the compressed ones
+    struct Cursor {
+        const DescriptionIndex* index;
+        const unsigned char* next;
+        int firstBlock;      // the term's first skip entry
+        int position;        // posting number of doc
+        int packed;          // compressed postings of the term
+        int count;           // all postings of the term
+        const CustomArray<int>* deltaDocs;
+        const CustomArray<int>* deltaFreqs;
+        int doc;             // INT_MAX once exhausted
+        int tf;
+        int term;            // index into the query's term list
+        double idf;
+        double upperBound;
+
+        void advance() {
+            if (position + 1 >= count) {
+                position = count;
+                doc = INT_MAX;
+                return;
+            }
+            position++;
+            if (position < packed) {
+                doc += static_cast<int>(readVarint(next));
+                tf = static_cast<int>(readVarint(next));
+            } else {
+                doc = (*deltaDocs)[position - packed];
+                tf = (*deltaFreqs)[position - packed];
+            }
+        }
+
+        void advanceTo(int target) {
+            if (doc >= target) return;
+            if (position < packed) {
+                int block = position / POSTING_BLOCK;
+                int lastBlock = (packed - 1) / POSTING_BLOCK;
+                int skipTo = block;
+                while (skipTo <= lastBlock && index->blockLastDoc[firstBlock + skipTo] < target) skipTo++;
+                if (skipTo > lastBlock) {
+                    position = packed - 1;      // past the compressed postings
+                } else if (skipTo != block) {
+                    // Deltas restart from the previous block's last job
+                    next = &index->postingBytes[0] + index->blockOffset[firstBlock + skipTo];
+                    doc = index->blockLastDoc[firstBlock + skipTo - 1];
+                    position = skipTo * POSTING_BLOCK - 1;
+                }
+            }
+            if (position >= packed - 1 && position + 1 < count) {
+                // Binary search the delta postings
+                int low = position + 1 - packed;
+                int high = count - packed;
+                while (low < high) {
+                    int mid = low + (high - low) / 2;
+                    if ((*deltaDocs)[mid] < target) low = mid + 1;
+                    else high = mid;
+                }
+                position = packed + low - 1;
+            }
+            advance();
+            while (doc < target) advance();
+        }
+    };
+
+    double lengthNorm(int doc) const {
+        return BM25_K1 * (1.0 - BM25_B + BM25_B * documentLength[doc] / (averageLength > 0 ? averageLength : 1.0));
+    }
+
+    double contribution(double idf, int tf, int doc) const {
+        return idf * (tf * (BM25_K1 + 1.0)) / (tf + lengthNorm(doc));
+    }
+
+    double termIdf(int t) const {
+        double df = documentFrequency[t];
+        return log(1.0 + (documents - df + 0.5) / (df + 0.5));
+    }
+
+    // Highest contribution the term can make to any job
+    double termUpperBound(int t, double idf) const {
+        double bound = packedBound[t];
+        if (averageLength > packedAverageLength && packedAverageLength > 0) bound *= averageLength / packedAverageLength;
+        if (deltaDocs[t].size() > 0) {
+            double norm = BM25_K1 * (1.0 - BM25_B + BM25_B * deltaMinLength[t] / (averageLength > 0 ? averageLength : 1.0));
+            bound = max(bound, deltaMaxFreq[t] * (BM25_K1 + 1.0) / (deltaMaxFreq[t] + norm));
+        }
+        return idf * bound;
+    }
+
+    int addTerm(const CustomString& term) {
+        int t = documentFrequency.size();
+        termIds.insert(term, t);
+        int postingEnd = postingStart[t];       // push_back may move the arrays
+        int blockEnd = blockStart[t];
+        postingStart.push_back(postingEnd);
+        blockStart.push_back(blockEnd);
+        documentFrequency.push_back(0);
+        packedCount.push_back(0);
+        packedBound.push_back(0.0);
+        deltaDocs.push_back(CustomArray<int>());
+        deltaFreqs.push_back(CustomArray<int>());
+        deltaMaxFreq.push_back(0);
+        deltaMinLength.push_back(INT_MAX);
+        return t;
+    }
+
+    // Tokenise job as document doc into the delta postings
+    void addDocument(const Job& job, int doc, CustomArray<char>& buffer, CustomArray<int>& docTerms,
+                     CustomArray<int>& docFreqs) {
+        docTerms.clear();
+        docFreqs.clear();
+        int length = 0;
+        forEachLowerWord(job.fullDescription, buffer, [&](const char* word, int len) {
+            length++;
+            CustomString term(word, len);
+            int* id = termIds.find(term);
+            int termId = id ? *id : addTerm(term);
+            for (int i = 0; i < docTerms.size(); i++) {
+                if (docTerms[i] == termId) {
+                    docFreqs[i]++;
+                    return;
+                }
+            }
+            docTerms.push_back(termId);
+            docFreqs.push_back(1);
+        });
+        for (int i = 0; i < docTerms.size(); i++) {
+            int t = docTerms[i];
+            deltaDocs[t].push_back(doc);
+            deltaFreqs[t].push_back(docFreqs[i]);
+            documentFrequency[t]++;
+            deltaMaxFreq[t] = max(deltaMaxFreq[t], docFreqs[i]);
+            deltaMinLength[t] = min(deltaMinLength[t], length);
+        }
+        deltaPostings += docTerms.size();
+        documentLength.push_back(length);
+        totalLength += length;
+    }
+
+    // Compress the delta postings behind each term's compressed ones
+    void compress() {
+        CustomArray<int> oldPostingStart = postingStart;
+        CustomArray<unsigned char> oldBytes = move(postingBytes);
+        blockLastDoc.clear();
+        blockOffset.clear();
+        postingBytes.reserve(oldBytes.size() + deltaPostings * 2);
+        for (int t = 0; t < documentFrequency.size(); t++) {
+            postingStart[t] = postingBytes.size();
+            blockStart[t] = blockLastDoc.size();
+            double bound = 0.0;
+            int previous = 0;
+            int written = 0;
+            auto put = [&](int doc, int tf) {
+                if (written % POSTING_BLOCK == 0) blockOffset.push_back(postingBytes.size());
+                if (written % POSTING_BLOCK == POSTING_BLOCK - 1 || written == documentFrequency[t] - 1)
+                    blockLastDoc.push_back(doc);
+                appendVarint(postingBytes, static_cast<unsigned int>(doc - previous));
+                appendVarint(postingBytes, static_cast<unsigned int>(tf));
+                previous = doc;
+                written++;
+                bound = max(bound, tf * (BM25_K1 + 1.0) / (tf + lengthNorm(doc)));
+            };
+            const unsigned char* p = oldBytes.size() > 0 ? &oldBytes[0] + oldPostingStart[t] : nullptr;
+            int doc = 0;
+            for (int i = 0; i < packedCount[t]; i++) {
+                doc += static_cast<int>(readVarint(p));
+                int tf = static_cast<int>(readVarint(p));
+                put(doc, tf);
+            }
+            for (int i = 0; i < deltaDocs[t].size(); i++) put(deltaDocs[t][i], deltaFreqs[t][i]);
+            packedCount[t] = documentFrequency[t];
+            packedBound[t] = bound;
+            deltaDocs[t].clear();
+            deltaFreqs[t].clear();
+            deltaMaxFreq[t] = 0;
+            deltaMinLength[t] = INT_MAX;
+        }
+        postingStart[documentFrequency.size()] = postingBytes.size();
+        blockStart[documentFrequency.size()] = blockLastDoc.size();
+        packedPostings += deltaPostings;
+        deltaPostings = 0;
+        packedAverageLength = averageLength;
+    }
+
+    // Packed postings and skip entries of term t, and its delta postings, are
+    // in range and ascending; what restore checks before a cursor trusts them
+    bool validTerm(int t) const {
+        int packed = packedCount[t];
+        int count = documentFrequency[t];
+        int firstBlock = blockStart[t];
+        if (packed < 0 || packed > count || count - packed != deltaDocs[t].size()) return false;
+        if (blockStart[t + 1] - firstBlock != (packed + POSTING_BLOCK - 1) / POSTING_BLOCK) return false;
+        const unsigned char* base = postingBytes.size() > 0 ? &postingBytes[0] : nullptr;
+        const unsigned char* p = base ? base + postingStart[t] : nullptr;
+        const unsigned char* end = base ? base + postingStart[t + 1] : nullptr;
+        long long doc = 0;
+        for (int i = 0; i < packed; i++) {
+            if (i % POSTING_BLOCK == 0 && blockOffset[firstBlock + i / POSTING_BLOCK] != p - base) return false;
+            unsigned int delta, tf;
+            if (!readVarintChecked(p, end, delta) || !readVarintChecked(p, end, tf)) return false;
+            if ((i > 0 && delta == 0) || tf == 0 || tf > INT_MAX) return false;
+            doc += delta;
+            if (doc >= documents) return false;
+            if ((i % POSTING_BLOCK == POSTING_BLOCK - 1 || i == packed - 1) && blockLastDoc[firstBlock + i / POSTING_BLOCK] != doc)
+                return false;
+        }
+        if (p != end) return false;
+        for (int i = 0; i < deltaDocs[t].size(); i++) {
+            int next = deltaDocs[t][i];
+            if (next >= documents || (packed + i > 0 && next <= doc) || next < 0 || deltaFreqs[t][i] <= 0) return false;
+            doc = next;
+        }
+        return true;
+    }
+
+    // Distinct known terms of the resume's description
+    void queryTerms(const Resume& resume, CustomArray<int>& terms) const {
+        terms.clear();
+        CustomArray<char> buffer;
+        forEachLowerWord(resume.fullDescription, buffer, [&](const char* word, int len) {
+            const int* id = termIds.find(CustomString(word, len));
+            if (id == nullptr) return;
+            for (int i = 0; i < terms.size(); i++) {
+                if (terms[i] == *id) return;
+            }
+            terms.push_back(*id);
+        });
+    }
+
+    // Insert (doc, score) into the top-k list, best first, earlier job first on ties
+    static void offerTop(QueryResult& out, int k, int doc, double score) {
+        int pos;
+        if (out.indices.size() < k) {
+            out.indices.push_back(doc);
+            out.scores.push_back(score);
+            pos = out.indices.size() - 1;
+        } else if (score > out.scores[k - 1]) {
+            pos = k - 1;
+        } else {
+            return;
+        }
+        while (pos > 0 && out.scores[pos - 1] < score) {
+            out.indices[pos] = out.indices[pos - 1];
+            out.scores[pos] = out.scores[pos - 1];
+            pos--;
+        }
+        out.indices[pos] = doc;
+        out.scores[pos] = score;
+    }
+
+public:
+    DescriptionIndex() : packedPostings(0), deltaPostings(0), documents(0), totalLength(0), averageLength(0.0), packedAverageLength(0.0) {
+        postingStart.push_back(0);
+        blockStart.push_back(0);
+    }
+
+    void clear() {
+        termIds.clear();
+        postingStart.clear();
+        postingStart.push_back(0);
+        blockStart.clear();
+        blockStart.push_back(0);
+        blockLastDoc.clear();
+        blockOffset.clear();
+        documentFrequency.clear();
+        packedCount.clear();
+        packedBound.clear();
+        postingBytes.clear();
+        deltaDocs.clear();
+        deltaFreqs.clear();
+        deltaMaxFreq.clear();
+        deltaMinLength.clear();
+        documentLength.clear();
+        packedPostings = 0;
+        deltaPostings = 0;
+        documents = 0;
+        totalLength = 0;
+        averageLength = 0.0;
+        packedAverageLength = 0.0;
+    }
+
+    void build(const CustomArrayV2<Job>& jobs) {
+        clear();
+        documentLength.reserve(jobs.getSize());
+        append(jobs);
+    }
+
+    // Index the jobs past the last indexed position, appended since
+    void append(const CustomArrayV2<Job>& jobs) {
+        CustomArray<char> buffer;
+        CustomArray<int> docTerms;
+        CustomArray<int> docFreqs;
+        for (int d = documents; d < jobs.getSize(); d++) addDocument(jobs[d], d, buffer, docTerms, docFreqs);
+        documents = jobs.getSize();
+        averageLength = documents > 0 ? static_cast<double>(totalLength) / documents : 0.0;
+        if (deltaPostings > packedPostings / 4) compress();
+    }
+
+    // Snapshot section: the terms by id and every array as is; the delta
+    // postings go back to back
+    void save(SnapshotSectionWriter& out) const {
+        int terms = documentFrequency.size();
+        CustomArray<const CustomString*> byId;
+        byId.resize(terms);
+        termIds.forEach([&](const CustomString& term, int id) { byId[id] = &term; });
+        CustomArray<int> deltaStart;
+        CustomArray<int> allDeltaDocs;
+        CustomArray<int> allDeltaFreqs;
+        deltaStart.resize(terms + 1);
+        allDeltaDocs.reserve(deltaPostings);
+        allDeltaFreqs.reserve(deltaPostings);
+        for (int t = 0; t < terms; t++) {
+            deltaStart[t] = allDeltaDocs.size();
+            for (int i = 0; i < deltaDocs[t].size(); i++) {
+                allDeltaDocs.push_back(deltaDocs[t][i]);
+                allDeltaFreqs.push_back(deltaFreqs[t][i]);
+            }
+        }
+        deltaStart[terms] = allDeltaDocs.size();
+        out.putStrings(terms, [&](int i) -> const CustomString& { return *byId[i]; });
+        out.putArray(postingStart);
+        out.putArray(blockStart);
+        out.putArray(blockLastDoc);
+        out.putArray(blockOffset);
+        out.putArray(documentFrequency);
+        out.putArray(packedCount);
+        out.putArray(packedBound);
+        out.putArray(postingBytes);
+        out.putArray(deltaStart);
+        out.putArray(allDeltaDocs);
+        out.putArray(allDeltaFreqs);
+        out.putArray(deltaMaxFreq);
+        out.putArray(deltaMinLength);
+        out.putArray(documentLength);
+        out.putValue(packedAverageLength);
+    }
+
+    // Load a saved section over storeSize jobs. Every posting is decoded once
+    // to check it, which is far cheaper than tokenising the descriptions
+    // again. On false the index is left empty.
+    bool restore(SnapshotSectionReader& in, int storeSize) {
+        clear();
+        CustomArray<CustomString> terms;
+        CustomArray<int> deltaStart;
+        CustomArray<int> allDeltaDocs;
+        CustomArray<int> allDeltaFreqs;
+        bool ok = in.getStrings(terms) && in.getArray(postingStart) && in.getArray(blockStart)
+               && in.getArray(blockLastDoc) && in.getArray(blockOffset) && in.getArray(documentFrequency)
+               && in.getArray(packedCount) && in.getArray(packedBound) && in.getArray(postingBytes)
+               && in.getArray(deltaStart) && in.getArray(allDeltaDocs) && in.getArray(allDeltaFreqs)
+               && in.getArray(deltaMaxFreq) && in.getArray(deltaMinLength) && in.getArray(documentLength)
+               && in.getValue(packedAverageLength);
+        int count = terms.size();
+        ok = ok && postingStart.size() == count + 1 && blockStart.size() == count + 1 && deltaStart.size() == count + 1
+                && documentFrequency.size() == count && packedCount.size() == count && packedBound.size() == count
+                && deltaMaxFreq.size() == count && deltaMinLength.size() == count
+                && blockOffset.size() == blockLastDoc.size() && allDeltaFreqs.size() == allDeltaDocs.size()
+                && postingStart[0] == 0 && blockStart[0] == 0 && deltaStart[0] == 0
+                && postingStart[count] == postingBytes.size() && blockStart[count] == blockLastDoc.size()
+                && deltaStart[count] == allDeltaDocs.size() && documentLength.size() == storeSize;
+        for (int t = 0; ok && t < count; t++) {
+            ok = postingStart[t + 1] >= postingStart[t] && blockStart[t + 1] >= blockStart[t]
+              && deltaStart[t + 1] >= deltaStart[t] && blockStart[t + 1] <= blockLastDoc.size()
+              && postingStart[t + 1] <= postingBytes.size() && deltaStart[t + 1] <= allDeltaDocs.size();
+        }
+        documents = storeSize;
+        for (int d = 0; ok && d < documents; d++) {
+            ok = documentLength[d] >= 0;
+            totalLength += documentLength[d];
+        }
+        if (ok) {
+            deltaDocs.resize(count);
+            deltaFreqs.resize(count);
+            termIds.reserve(count);
+        }
+        for (int t = 0; ok && t < count; t++) {
+            for (int i = deltaStart[t]; i < deltaStart[t + 1]; i++) {
+                deltaDocs[t].push_back(allDeltaDocs[i]);
+                deltaFreqs[t].push_back(allDeltaFreqs[i]);
+            }
+            ok = !termIds.contains(terms[t]) && validTerm(t);
+            termIds.insert(terms[t], t);
+            packedPostings += packedCount[t];
+            deltaPostings += deltaDocs[t].size();
+        }
+        if (!ok) {
+            clear();
+            return in.fail();
+        }
+        averageLength = documents > 0 ? static_cast<double>(totalLength) / documents : 0.0;
+        return true;
+    }
+
+    int getDocumentCount() const { return documents; }
+    int getTermCount() const { return documentFrequency.size(); }
+    int getPostingBytes() const { return postingBytes.size() + deltaPostings * 2 * sizeof(int); }
+
+    // Top k jobs by BM25 of the resume's description words, via MaxScore.
+    // Returns the number of jobs that were fully scored.
+    int search(const Resume& resume, int k, QueryResult& out) const {
+        out.clear();
+        if (k <= 0 || documents == 0) return 0;
+        CustomArray<int> terms;
+        queryTerms(resume, terms);
+
+        int count = terms.size();
+        CustomArray<Cursor> cursors;
+        CustomArray<int> byBound;            // cursor indices, lowest upper bound first
+        CustomArray<double> boundPrefix;     // summed upper bounds of byBound[0..i]
+        cursors.resize(count);
+        byBound.resize(count);
+        boundPrefix.resize(count);
+        for (int i = 0; i < count; i++) {
+            int t = terms[i];
+            Cursor& c = cursors[i];
+            c.index = this;
+            c.next = postingBytes.size() > 0 ? &postingBytes[0] + postingStart[t] : nullptr;
+            c.firstBlock = blockStart[t];
+            c.position = -1;
+            c.packed = packedCount[t];
+            c.count = documentFrequency[t];
+            c.deltaDocs = &deltaDocs[t];
+            c.deltaFreqs = &deltaFreqs[t];
+            c.doc = 0;
+            c.tf = 0;
+            c.term = i;
+            c.idf = termIdf(t);
+            c.upperBound = termUpperBound(t, c.idf);
+            c.advance();
+
+            int j = i;
+            while (j > 0 && cursors[byBound[j - 1]].upperBound > c.upperBound) {
+                byBound[j] = byBound[j - 1];
+                j--;
+            }
+            byBound[j] = i;
+        }
+        double summed = 0.0;
+        CustomArray<int> rankDoc;            // cursors[byBound[i]].doc, scanned without touching cursors
+        rankDoc.resize(count);
+        for (int i = 0; i < count; i++) {
+            summed += cursors[byBound[i]].upperBound;
+            boundPrefix[i] = summed;
+            rankDoc[i] = cursors[byBound[i]].doc;
+        }
+
+        // Terms below firstEssential can't lift a job past the k-th score on
+        // their own: jobs are only enumerated from the essential terms' postings
+        // and the others are probed (with block skips) while it can still matter.
+        // Bounds get a little slack so summation order never prunes a real hit.
+        const double slack = 1.0 + 1e-9;
+        int firstEssential = 0;
+        int scored = 0;
+        CustomArray<int> matched;            // query terms present in the job being scored
+        CustomArray<double> matchedScores;   // their contributions
+        while (true) {
+            int doc = INT_MAX;
+            for (int i = firstEssential; i < count; i++) doc = min(doc, rankDoc[i]);
+            if (doc == INT_MAX) break;
+
+            double threshold = out.indices.size() < k ? 0.0 : out.scores[k - 1];
+            double estimate = 0.0;
+            matched.clear();
+            matchedScores.clear();
+            for (int i = firstEssential; i < count; i++) {
+                if (rankDoc[i] != doc) continue;
+                Cursor& c = cursors[byBound[i]];
+                double part = contribution(c.idf, c.tf, doc);
+                estimate += part;
+                matched.push_back(c.term);
+                matchedScores.push_back(part);
+                c.advance();
+                rankDoc[i] = c.doc;
+            }
+            bool pruned = false;
+            for (int i = firstEssential - 1; i >= 0; i--) {
+                if ((estimate + boundPrefix[i]) * slack <= threshold) {
+                    pruned = true;
+                    break;
+                }
+                Cursor& c = cursors[byBound[i]];
+                c.advanceTo(doc);
+                rankDoc[i] = c.doc;
+                if (c.doc == doc) {
+                    double part = contribution(c.idf, c.tf, doc);
+                    estimate += part;
+                    matched.push_back(c.term);
+                    matchedScores.push_back(part);
+                }
+            }
+            if (pruned || estimate * slack <= threshold) continue;
+
+            // Exact score, adding the terms in query order like searchExhaustive
+            for (int i = 1; i < matched.size(); i++) {
+                int term = matched[i];
+                double part = matchedScores[i];
+                int j = i;
+                while (j > 0 && matched[j - 1] > term) {
+                    matched[j] = matched[j - 1];
+                    matchedScores[j] = matchedScores[j - 1];
+                    j--;
+                }
+                matched[j] = term;
+                matchedScores[j] = part;
+            }
+            double score = 0.0;
+            for (int i = 0; i < matchedScores.size(); i++) score += matchedScores[i];
+            offerTop(out, k, doc, score);
+            scored++;
+
+            if (out.indices.size() == k) {
+                threshold = out.scores[k - 1];
+                while (firstEssential < count && boundPrefix[firstEssential] * slack <= threshold) firstEssential++;
+            }
+        }
+        return scored;
+    }
+
+    // Reference ranking: score every posting of every query term
+    void searchExhaustive(const Resume& resume, int k, QueryResult& out) const {
+        out.clear();
+        CustomArray<int> terms;
+        queryTerms(resume, terms);
+        out.scratch.resize(documents);
+        for (int d = 0; d < documents; d++) out.scratch[d] = 0.0;
+        for (int i = 0; i < terms.size(); i++) {
+            int t = terms[i];
+            double idf = termIdf(t);
+            if (packedCount[t] > 0) {
+                const unsigned char* p = &postingBytes[0] + postingStart[t];
+                int doc = 0;
+                for (int k = 0; k < packedCount[t]; k++) {
+                    doc += static_cast<int>(readVarint(p));
+                    int tf = static_cast<int>(readVarint(p));
+                    out.scratch[doc] += contribution(idf, tf, doc);
+                }
+            }
+            for (int k = 0; k < deltaDocs[t].size(); k++)
+                out.scratch[deltaDocs[t][k]] += contribution(idf, deltaFreqs[t][k], deltaDocs[t][k]);
+        }
+        selectTopScores(out.scratch, k, true, out.indices);
+        copyTopScores(out.scratch, out.indices, out.scores);
+    }
+};
@@ -0,0 +1,419 @@
+#pragma once
+#include "model.hpp"
+#include "array.hpp"
+#include "index_keys.hpp"
+#include "sorting.hpp"
+
+using namespace std;
+
+// B+-tree secondary index of (key, row) pairs over an array of records.
+//
+// Nodes are wide (BPLUS_NODE_CAPACITY entries, about 1 KB with pointer keys)
+// so a lookup touches a handful of nodes and a leaf is scanned with binary
+// search inside a few cache lines. All entries live in the leaves, which are
+// chained in order, so a range scan is one descent plus a walk along the
+// chain. Entries are ordered by (key, row), which makes duplicate keys (a
+// category, a priority) distinct and returns them in row order.
+//
+// bulkLoad builds the tree bottom-up from sorted entries with nearly full nodes.
+// insert splits full nodes up to the root. remove deletes the entry and frees
+// a leaf only once it is empty (no merging of half-full nodes), so a tree
+// under heavy deletion can be rebuilt with bulkLoad to repack it.
+//
+// Rows are positions in the indexed array: reordering the array invalidates
+// the index (the storage rebuilds it), appending to it does not.
+
+const int BPLUS_NODE_CAPACITY = 64;
+
+template<typename KeyTraits>
+class BPlusTreeIndex {
+public:
+    typedef typename KeyTraits::Key Key;
+
+    struct Entry {
+        Key key;
+        int row;
+    };
+
+private:
+    struct Node {
+        bool leaf;
+        int count;      // entries in a leaf, separators in an inner node
+
+        explicit Node(bool isLeaf) : leaf(isLeaf), count(0) {}
+    };
+
+    struct Leaf : Node {
+        Entry entries[BPLUS_NODE_CAPACITY];
+        Leaf* next;
+        Leaf* prev;
+
+        Leaf() : Node(true), next(nullptr), prev(nullptr) {}
+    };
+
+    // children[i] holds the entries below separators[i]; separators[i] is the
+    // first entry of children[i + 1] when it was split off or built
+    struct Inner : Node {
+        Entry separators[BPLUS_NODE_CAPACITY];
+        Node* children[BPLUS_NODE_CAPACITY + 1];
+
+        Inner() : Node(false) {}
+    };
+
+    struct PathStep {
+        Inner* node;
+        int child;
+    };
+
+    static const int MAX_HEIGHT = 16;
+
+    Node* root;
+    Leaf* firstLeaf;
+    int size;
+    int height;         // levels, 1 = a single leaf
+    int nodeCount;
+
+    static int compareEntry(const Entry& entry, Key key, int row) {
+        int cmp = KeyTraits::compare(entry.key, key);
+        if (cmp != 0) return cmp;
+        return entry.row < row ? -1 : (entry.row > row ? 1 : 0);
+    }
+
+    // Children to the left of (key, row): separators <= (key, row)
+    static int childIndex(const Inner* inner, Key key, int row) {
+        int low = 0, high = inner->count;
+        while (low < high) {
+            int mid = low + (high - low) / 2;
+            if (compareEntry(inner->separators[mid], key, row) <= 0) low = mid + 1;
+            else high = mid;
+        }
+        return low;
+    }
+
+    // First position in leaf not before (key, row)
+    static int leafLowerBound(const Leaf* leaf, Key key, int row) {
+        int low = 0, high = leaf->count;
+        while (low < high) {
+            int mid = low + (high - low) / 2;
+            if (compareEntry(leaf->entries[mid], key, row) < 0) low = mid + 1;
+            else high = mid;
+        }
+        return low;
+    }
+
+    // Leaf that would hold (key, row); path, when given, records the inner
+    // nodes on the way and depth their number
+    Leaf* descend(Key key, int row, PathStep* path = nullptr, int* depth = nullptr) const {
+        Node* current = root;
+        int levels = 0;
+        while (!current->leaf) {
+            Inner* inner = static_cast<Inner*>(current);
+            int child = childIndex(inner, key, row);
+            if (path != nullptr) path[levels] = {inner, child};
+            levels++;
+            current = inner->children[child];
+        }
+        INSTRUMENT_COUNT(COUNTER_NODE_HOPS, levels);
+        if (depth != nullptr) *depth = levels;
+        return static_cast<Leaf*>(current);
+    }
+
+    void freeNode(Node* node) {
+        if (!node->leaf) {
+            Inner* inner = static_cast<Inner*>(node);
+            for (int i = 0; i <= inner->count; i++) freeNode(inner->children[i]);
+            delete inner;
+        } else {
+            delete static_cast<Leaf*>(node);
+        }
+    }
+
+    // Hang right (first entry separator) next to the node at path[depth]
+    void insertIntoParent(PathStep* path, int depth, Node* left, const Entry& separator, Node* right) {
+        if (depth == 0) {
+            Inner* newRoot = new Inner();
+            nodeCount++;
+            newRoot->count = 1;
+            newRoot->separators[0] = separator;
+            newRoot->children[0] = left;
+            newRoot->children[1] = right;
+            root = newRoot;
+            height++;
+            return;
+        }
+        Inner* parent = path[depth - 1].node;
+        int position = path[depth - 1].child;
+        if (parent->count < BPLUS_NODE_CAPACITY) {
+            for (int i = parent->count; i > position; i--) {
+                parent->separators[i] = parent->separators[i - 1];
+                parent->children[i + 1] = parent->children[i];
+            }
+            parent->separators[position] = separator;
+            parent->children[position + 1] = right;
+            parent->count++;
+            return;
+        }
+
+        // Split the full parent around its middle separator, which moves up
+        Entry separators[BPLUS_NODE_CAPACITY + 1];
+        Node* children[BPLUS_NODE_CAPACITY + 2];
+        for (int i = 0, j = 0; i <= BPLUS_NODE_CAPACITY; i++) {
+            if (i == position) separators[i] = separator;
+            else separators[i] = parent->separators[j++];
+        }
+        for (int i = 0, j = 0; i <= BPLUS_NODE_CAPACITY + 1; i++) {
+            if (i == position + 1) children[i] = right;
+            else children[i] = parent->children[j++];
+        }
+        int middle = (BPLUS_NODE_CAPACITY + 1) / 2;
+        Inner* sibling = new Inner();
+        nodeCount++;
+        parent->count = middle;
+        for (int i = 0; i < middle; i++) parent->separators[i] = separators[i];
+        for (int i = 0; i <= middle; i++) parent->children[i] = children[i];
+        sibling->count = BPLUS_NODE_CAPACITY - middle;
+        for (int i = 0; i < sibling->count; i++) sibling->separators[i] = separators[middle + 1 + i];
+        for (int i = 0; i <= sibling->count; i++) sibling->children[i] = children[middle + 1 + i];
+        insertIntoParent(path, depth - 1, parent, separators[middle], sibling);
+    }
+
+    void reset() {
+        Leaf* leaf = new Leaf();
+        root = leaf;
+        firstLeaf = leaf;
+        size = 0;
+        height = 1;
+        nodeCount = 1;
+    }
+
+public:
+    // Position in the leaf chain; valid() is false past the last entry
+    class Cursor {
+    private:
+        const Leaf* leaf;
+        int position;
+
+    public:
+        Cursor(const Leaf* start, int index) : leaf(start), position(index) {
+            while (leaf != nullptr && position >= leaf->count) {
+                leaf = leaf->next;
+                position = 0;
+            }
+        }
+
+        bool valid() const { return leaf != nullptr; }
+        const Entry& entry() const { return leaf->entries[position]; }
+        int row() const { return leaf->entries[position].row; }
+
+        void next() {
+            if (++position >= leaf->count) {
+                do {
+                    leaf = leaf->next;
+                } while (leaf != nullptr && leaf->count == 0);
+                position = 0;
+            }
+        }
+    };
+
+    BPlusTreeIndex() {
+        reset();
+    }
+
+    ~BPlusTreeIndex() {
+        freeNode(root);
+    }
+
+    BPlusTreeIndex(const BPlusTreeIndex&) = delete;
+    BPlusTreeIndex& operator=(const BPlusTreeIndex&) = delete;
+
+    void clear() {
+        freeNode(root);
+        reset();
+    }
+
+    // Build from entries already sorted by (key, row)
+    void bulkLoad(const CustomArray<Entry>& sorted) {
+        clear();
+        if (sorted.size() == 0) return;
+        delete static_cast<Leaf*>(root);
+        nodeCount = 0;
+
+        // Leaves, spread evenly so none is nearly empty
+        int leaves = (sorted.size() + BPLUS_NODE_CAPACITY - 1) / BPLUS_NODE_CAPACITY;
+        CustomArray<Node*> level;
+        CustomArray<Entry> firstEntries;   // smallest entry below each node of level
+        Leaf* previous = nullptr;
+        for (int l = 0, begin = 0; l < leaves; l++) {
+            int end = static_cast<int>(static_cast<long long>(sorted.size()) * (l + 1) / leaves);
+            Leaf* leaf = new Leaf();
+            nodeCount++;
+            for (int i = begin; i < end; i++) leaf->entries[i - begin] = sorted[i];
+            leaf->count = end - begin;
+            leaf->prev = previous;
+            if (previous != nullptr) previous->next = leaf;
+            else firstLeaf = leaf;
+            previous = leaf;
+            level.push_back(leaf);
+            firstEntries.push_back(sorted[begin]);
+            begin = end;
+        }
+        height = 1;
+
+        // Inner levels until a single root remains
+        while (level.size() > 1) {
+            int parents = (level.size() + BPLUS_NODE_CAPACITY) / (BPLUS_NODE_CAPACITY + 1);
+            CustomArray<Node*> upper;
+            CustomArray<Entry> upperFirst;
+            for (int p = 0, begin = 0; p < parents; p++) {
+                int end = static_cast<int>(static_cast<long long>(level.size()) * (p + 1) / parents);
+                Inner* inner = new Inner();
+                nodeCount++;
+                for (int i = begin; i < end; i++) {
+                    inner->children[i - begin] = level[i];
+                    if (i > begin) inner->separators[i - begin - 1] = firstEntries[i];
+                }
+                inner->count = end - begin - 1;
+                upper.push_back(inner);
+                upperFirst.push_back(firstEntries[begin]);
+                begin = end;
+            }
+            level = upper;
+            firstEntries = upperFirst;
+            height++;
+        }
+        root = level[0];
+        size = sorted.size();
+    }
+
+    // Add (key, row); false if it is already present
+    bool insert(Key key, int row) {
+        PathStep path[MAX_HEIGHT];
+        int depth;
+        Leaf* leaf = descend(key, row, path, &depth);
+        int position = leafLowerBound(leaf, key, row);
+        if (position < leaf->count && compareEntry(leaf->entries[position], key, row) == 0) return false;
+        size++;
+
+        if (leaf->count < BPLUS_NODE_CAPACITY) {
+            for (int i = leaf->count; i > position; i--) leaf->entries[i] = leaf->entries[i - 1];
+            leaf->entries[position] = {key, row};
+            leaf->count++;
+            return true;
+        }
+
+        // Split the full leaf in half and insert into the half that owns the position
+        Leaf* right = new Leaf();
+        nodeCount++;
+        INSTRUMENT_COUNT(COUNTER_ALLOCATIONS, 1);
+        int keep = BPLUS_NODE_CAPACITY / 2;
+        for (int i = keep; i < BPLUS_NODE_CAPACITY; i++) right->entries[i - keep] = leaf->entries[i];
+        right->count = BPLUS_NODE_CAPACITY - keep;
+        leaf->count = keep;
+        right->next = leaf->next;
+        right->prev = leaf;
+        if (leaf->next != nullptr) leaf->next->prev = right;
+        leaf->next = right;
+
+        Leaf* target = position <= keep ? leaf : right;
+        if (target == right) position -= keep;
+        for (int i = target->count; i > position; i--) target->entries[i] = target->entries[i - 1];
+        target->entries[position] = {key, row};
+        target->count++;
+        insertIntoParent(path, depth, leaf, right->entries[0], right);
+        return true;
+    }
+
+    // Remove (key, row); false if it is not present
+    bool remove(Key key, int row) {
+        PathStep path[MAX_HEIGHT];
+        int depth;
+        Leaf* leaf = descend(key, row, path, &depth);
+        int position = leafLowerBound(leaf, key, row);
+        if (position >= leaf->count || compareEntry(leaf->entries[position], key, row) != 0) return false;
+        for (int i = position; i < leaf->count - 1; i++) leaf->entries[i] = leaf->entries[i + 1];
+        leaf->count--;
+        size--;
+        if (leaf->count > 0 || depth == 0) return true;
+
+        // Unlink the empty leaf, then drop it from its parent; a parent left
+        // without children goes as well
+        if (leaf->prev != nullptr) leaf->prev->next = leaf->next;
+        else firstLeaf = leaf->next;
+        if (leaf->next != nullptr) leaf->next->prev = leaf->prev;
+        delete leaf;
+        nodeCount--;
+        while (depth > 0) {
+            Inner* parent = path[depth - 1].node;
+            int child = path[depth - 1].child;
+            if (parent->count > 0) {
+                int separator = child > 0 ? child - 1 : 0;
+                for (int i = separator; i < parent->count - 1; i++) parent->separators[i] = parent->separators[i + 1];
+                for (int i = child; i < parent->count; i++) parent->children[i] = parent->children[i + 1];
+                parent->count--;
+                break;
+            }
+            delete parent;
+            nodeCount--;
+            depth--;
+        }
+        if (depth == 0) {
+            reset();   // every level had a single child: the tree is empty
+            return true;
+        }
+
+        // A root left with one child hands the root over to it
+        while (!root->leaf && static_cast<Inner*>(root)->count == 0) {
+            Inner* oldRoot = static_cast<Inner*>(root);
+            root = oldRoot->children[0];
+            delete oldRoot;
+            nodeCount--;
+            height--;
+        }
+        return true;
+    }
+
+    // First entry with a key >= key
+    Cursor lowerBound(Key key) const {
+        Leaf* leaf = descend(key, -2147483647 - 1);
+        return Cursor(leaf, leafLowerBound(leaf, key, -2147483647 - 1));
+    }
+
+    Cursor begin() const { return Cursor(firstLeaf, 0); }
+
+    // Rows with exactly key, ascending
+    void find(Key key, CustomArray<int>& rows) const {
+        rows.clear();
+        for (Cursor cursor = lowerBound(key); cursor.valid() && KeyTraits::compare(cursor.entry().key, key) == 0; cursor.next()) {
+            rows.push_back(cursor.row());
+        }
+    }
+
+    // Rows with low <= key <= high, in (key, row) order
+    void range(Key low, Key high, CustomArray<int>& rows) const {
+        rows.clear();
+        for (Cursor cursor = lowerBound(low); cursor.valid() && KeyTraits::compare(cursor.entry().key, high) <= 0; cursor.next()) {
+            rows.push_back(cursor.row());
+        }
+    }
+
+    int getSize() const { return size; }
+    int getHeight() const { return height; }
+    int getNodeCount() const { return nodeCount; }
+    size_t getMemoryBytes() const { return static_cast<size_t>(nodeCount) * sizeof(Leaf); }
+};
+
+// Index every record of records under KeyTraits, rows in array order
+template<typename KeyTraits, typename T>
+void bulkLoadIndex(BPlusTreeIndex<KeyTraits>& index, const CustomArrayV2<T>& records) {
+    typedef typename BPlusTreeIndex<KeyTraits>::Entry Entry;
+    CustomArray<Entry> entries;
+    entries.resize(records.getSize());
+    for (int i = 0; i < records.getSize(); i++) entries[i] = {KeyTraits::of(records[i]), i};
+    if (entries.size() > 1) {
+        parallelIntroSort(&entries[0], entries.size(), [](const Entry& a, const Entry& b) {
+            int cmp = KeyTraits::compare(a.key, b.key);
+            return cmp < 0 || (cmp == 0 && a.row < b.row);
+        }, "index.bplus.bulkLoad");
+    }
+    index.bulkLoad(entries);
+}
@@ -0,0 +1,198 @@
+#pragma once
+#include "model.hpp"
+#include <cstring>
+
+using namespace std;
+
+// Hash functions for the key types used across the project
+inline unsigned int hashKey(int key) {
+    unsigned int x = static_cast<unsigned int>(key);
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+// FNV-1a over the raw bytes of a string
+inline unsigned int hashBytes(const char* str, int len) {
+    unsigned int h = 2166136261U;
+    for (int i = 0; i < len; i++) {
+        h ^= static_cast<unsigned char>(str[i]);
+        h *= 16777619U;
+    }
+    return h;
+}
+
+inline unsigned int hashKey(const CustomString& key) {
+    if (key.c_str() == nullptr) return 0;
+    return hashBytes(key.c_str(), key.size());
+}
+
+inline bool keyEquals(int a, int b) {
+    return a == b;
+}
+
+inline bool keyEquals(const CustomString& a, const CustomString& b) {
+    if (a.c_str() == nullptr || b.c_str() == nullptr) return a.c_str() == b.c_str();
+    return a.size() == b.size() && memcmp(a.c_str(), b.c_str(), a.size()) == 0;
+}
+
+// Custom Hash Map class (open addressing with linear probing)
+template<typename K, typename V>
+class CustomHashMap {
+private:
+    K* keys;
+    V* values;
+    bool* used;
+    int capacity;
+    int count;
+
+    int slotFor(const K& key) const {
+        int mask = capacity - 1;
+        int slot = static_cast<int>(hashKey(key)) & mask;
+        while (used[slot] && !keyEquals(keys[slot], key)) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    void rehash(int newCapacity) {
+        K* oldKeys = keys;
+        V* oldValues = values;
+        bool* oldUsed = used;
+        int oldCapacity = capacity;
+
+        keys = new K[newCapacity];
+        values = new V[newCapacity];
+        used = new bool[newCapacity];
+        for (int i = 0; i < newCapacity; i++) used[i] = false;
+        capacity = newCapacity;
+
+        for (int i = 0; i < oldCapacity; i++) {
+            if (oldUsed[i]) {
+                int slot = slotFor(oldKeys[i]);
+                keys[slot] = oldKeys[i];
+                values[slot] = oldValues[i];
+                used[slot] = true;
+            }
+        }
+
+        delete[] oldKeys;
+        delete[] oldValues;
+        delete[] oldUsed;
+    }
+
+    void copyFrom(const CustomHashMap& other) {
+        for (int i = 0; i < other.capacity; i++) {
+            if (other.used[i]) insert(other.keys[i], other.values[i]);
+        }
+    }
+
+public:
+    CustomHashMap() : keys(nullptr), values(nullptr), used(nullptr), capacity(0), count(0) {}
+
+    CustomHashMap(const CustomHashMap& other) : keys(nullptr), values(nullptr), used(nullptr), capacity(0), count(0) {
+        copyFrom(other);
+    }
+
+    CustomHashMap& operator=(const CustomHashMap& other) {
+        if (this != &other) {
+            clear();
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    ~CustomHashMap() {
+        clear();
+    }
+
+    // Pre-size the table so that n entries fit without rehashing
+    void reserve(int n) {
+        int needed = 16;
+        while (needed * 3 < n * 4) needed *= 2;
+        if (needed > capacity) rehash(needed);
+    }
+
+    // Insert or overwrite; returns a reference to the stored value
+    V& insert(const K& key, const V& value) {
+        if ((count + 1) * 4 > capacity * 3) {
+            rehash(capacity == 0 ? 16 : capacity * 2);
+        }
+        int slot = slotFor(key);
+        if (!used[slot]) {
+            keys[slot] = key;
+            used[slot] = true;
+            count++;
+        }
+        values[slot] = value;
+        return values[slot];
+    }
+
+    V* find(const K& key) {
+        if (count == 0) return nullptr;
+        int slot = slotFor(key);
+        return used[slot] ? &values[slot] : nullptr;
+    }
+
+    const V* find(const K& key) const {
+        if (count == 0) return nullptr;
+        int slot = slotFor(key);
+        return used[slot] ? &values[slot] : nullptr;
+    }
+
+    bool contains(const K& key) const {
+        return find(key) != nullptr;
+    }
+
+    // Remove using backward-shift deletion so probe chains stay intact
+    bool remove(const K& key) {
+        if (count == 0) return false;
+        int mask = capacity - 1;
+        int slot = slotFor(key);
+        if (!used[slot]) return false;
+
+        used[slot] = false;
+        count--;
+        int next = (slot + 1) & mask;
+        while (used[next]) {
+            int home = static_cast<int>(hashKey(keys[next])) & mask;
+            // Move the entry back if its home slot is not within (slot, next]
+            bool between = (slot < next) ? (home > slot && home <= next)
+                                         : (home > slot || home <= next);
+            if (!between) {
+                keys[slot] = keys[next];
+                values[slot] = values[next];
+                used[slot] = true;
+                used[next] = false;
+                slot = next;
+            }
+            next = (next + 1) & mask;
+        }
+        return true;
+    }
+
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    void clear() {
+        delete[] keys;
+        delete[] values;
+        delete[] used;
+        keys = nullptr;
+        values = nullptr;
+        used = nullptr;
+        capacity = 0;
+        count = 0;
+    }
+
+    // Iterate over every stored entry
+    template<typename Fn>
+    void forEach(Fn fn) const {
+        for (int i = 0; i < capacity; i++) {
+            if (used[i]) fn(keys[i], values[i]);
+        }
+    }
+};
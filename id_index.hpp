@@ -0,0 +1,135 @@
+#pragma once
+#include "model.hpp"
+#include "hashmap.hpp"
+#include "snapshot_section.hpp"
+
+using namespace std;
+
+// id -> Value map for record ids (array positions, list nodes).
+//
+// Ids come from a counter starting at 1, so they are dense: an id indexes a
+// slot array directly and a lookup is one bounds check and one load. An id far
+// beyond the ids seen so far (more than twice the entry count plus
+// ID_INDEX_SLACK) would waste slots and goes to a hash map instead. The API
+// follows CustomHashMap: find returns nullptr for a missing id.
+
+const int ID_INDEX_SLACK = 1024;
+
+template<typename Value>
+class DenseIdIndex {
+private:
+    CustomArray<Value> slots;
+    CustomArray<unsigned char> present;
+    CustomHashMap<int, Value> sparse;    // ids too large for the slot array
+    int count;
+
+    bool fitsDense(int id) const {
+        return id >= 0 && (id < slots.size() || id <= 2 * count + ID_INDEX_SLACK);
+    }
+
+public:
+    DenseIdIndex() : count(0) {}
+
+    // Room for ids up to n without growing
+    void reserve(int n) {
+        if (n + 1 > slots.size()) {
+            slots.resize(n + 1);
+            present.resize(n + 1);
+        }
+    }
+
+    // Set the value of id, replacing any previous one
+    void insert(int id, const Value& value) {
+        if (!fitsDense(id)) {
+            if (!sparse.contains(id)) count++;
+            sparse.insert(id, value);
+            return;
+        }
+        if (id >= slots.size()) {
+            int grown = slots.size() * 2 > id + 1 ? slots.size() * 2 : id + 1;
+            slots.resize(grown);
+            present.resize(grown);
+        }
+        if (!present[id]) {
+            if (sparse.size() > 0 && sparse.remove(id)) count--;
+            present[id] = 1;
+            count++;
+        }
+        slots[id] = value;
+    }
+
+    const Value* find(int id) const {
+        if (id >= 0 && id < slots.size() && present[id]) return &slots[id];
+        return sparse.size() > 0 ? sparse.find(id) : nullptr;
+    }
+
+    Value* find(int id) {
+        if (id >= 0 && id < slots.size() && present[id]) return &slots[id];
+        return sparse.size() > 0 ? sparse.find(id) : nullptr;
+    }
+
+    bool contains(int id) const { return find(id) != nullptr; }
+
+    bool remove(int id) {
+        if (id >= 0 && id < slots.size() && present[id]) {
+            present[id] = 0;
+            slots[id] = Value();
+            count--;
+            return true;
+        }
+        if (sparse.size() > 0 && sparse.remove(id)) {
+            count--;
+            return true;
+        }
+        return false;
+    }
+
+    // Drops every entry but keeps the slot array for the next rebuild
+    void clear() {
+        for (int i = 0; i < present.size(); i++) present[i] = 0;
+        sparse.clear();
+        count = 0;
+    }
+
+    int size() const { return count; }
+
+    // Snapshot section; Value must be plain data (positions, not node pointers)
+    void save(SnapshotSectionWriter& out) const {
+        CustomArray<int> sparseIds;
+        CustomArray<Value> sparseValues;
+        sparse.forEach([&](int id, const Value& value) {
+            sparseIds.push_back(id);
+            sparseValues.push_back(value);
+        });
+        out.putArray(slots);
+        out.putArray(present);
+        out.putArray(sparseIds);
+        out.putArray(sparseValues);
+    }
+
+    // Load a saved section; valid(id, value) must accept every entry. On
+    // false the index is left empty.
+    template<typename Valid>
+    bool restore(SnapshotSectionReader& in, Valid valid) {
+        clear();
+        CustomArray<int> sparseIds;
+        CustomArray<Value> sparseValues;
+        bool ok = in.getArray(slots) && in.getArray(present) && in.getArray(sparseIds) && in.getArray(sparseValues)
+               && slots.size() == present.size() && sparseIds.size() == sparseValues.size();
+        for (int id = 0; ok && id < slots.size(); id++) {
+            if (present[id] > 1) ok = false;
+            else if (present[id]) ok = valid(id, slots[id]);
+            count += present[id];
+        }
+        for (int i = 0; ok && i < sparseIds.size(); i++) {
+            ok = valid(sparseIds[i], sparseValues[i]) && !contains(sparseIds[i]);
+            sparse.insert(sparseIds[i], sparseValues[i]);
+            count++;
+        }
+        if (!ok) {
+            clear();
+            return in.fail();
+        }
+        return true;
+    }
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include "model.hpp"
+#include <cstring>
+
+using namespace std;
+
+// Key traits shared by the ordered job indexes (skip_list.hpp, bplus_tree.hpp):
+//   typedef ... Key;   static Key of(const Job&);   static int compare(Key, Key);
+// String keys point into the record, so the record's field must stay
+// unchanged (and the record alive) while it is indexed. An empty string field
+// is indexed as "".
+
+inline int compareIndexInts(int a, int b) {
+    return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+struct JobTitleKey {
+    typedef const char* Key;
+    static Key of(const Job& job) { return job.jobTitle.c_str() ? job.jobTitle.c_str() : ""; }
+    static int compare(Key a, Key b) { return strcmp(a, b); }
+};
+
+// Category codes sort like the category names
+struct JobCategoryKey {
+    typedef int Key;
+    static Key of(const Job& job) { return job.categoryCode; }
+    static int compare(Key a, Key b) { return compareIndexInts(a, b); }
+};
+
+struct JobSkillCountKey {
+    typedef int Key;
+    static Key of(const Job& job) { return job.skillCount; }
+    static int compare(Key a, Key b) { return compareIndexInts(a, b); }
+};
+
+struct JobPriorityKey {
+    typedef int Key;
+    static Key of(const Job& job) { return job.priority; }
+    static int compare(Key a, Key b) { return compareIndexInts(a, b); }
+};
+
+struct JobIdKey {
+    typedef int Key;
+    static Key of(const Job& job) { return job.id; }
+    static int compare(Key a, Key b) { return compareIndexInts(a, b); }
+};
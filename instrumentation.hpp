@@ -0,0 +1,344 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+
+using namespace std;
+
+// Hot-path instrumentation: event counters, scoped timers, Chrome trace.
+//
+// Counters (comparisons, swaps, allocations, strcmp calls, list node hops) are
+// per thread: a thread only ever writes its own block with relaxed stores, so a
+// count costs a thread_local add. Readers sum all live blocks plus the totals
+// left by finished threads. Hot loops count into a local and add once.
+//
+// INSTRUMENT_SCOPE(name) times the enclosing scope into a log2 histogram per
+// name (name must be a string literal or otherwise outlive the program) and,
+// while tracing is on, records a Chrome trace event ("ph":"X").
+//
+// Build with -DNO_INSTRUMENTATION to compile every hook out; the report
+// functions still exist and report nothing.
+
+enum InstrumentCounter {
+    COUNTER_COMPARISONS,
+    COUNTER_SWAPS,
+    COUNTER_ALLOCATIONS,
+    COUNTER_STRCMP,
+    COUNTER_NODE_HOPS,
+    COUNTER_KINDS
+};
+
+inline const char* instrumentCounterName(int counter) {
+    static const char* const names[COUNTER_KINDS] = {"comparisons", "swaps", "allocations", "strcmp", "node_hops"};
+    return names[counter];
+}
+
+struct CounterSnapshot {
+    long long values[COUNTER_KINDS];
+
+    CounterSnapshot() {
+        for (int i = 0; i < COUNTER_KINDS; i++) values[i] = 0;
+    }
+
+    CounterSnapshot operator-(const CounterSnapshot& earlier) const {
+        CounterSnapshot delta;
+        for (int i = 0; i < COUNTER_KINDS; i++) delta.values[i] = values[i] - earlier.values[i];
+        return delta;
+    }
+};
+
+const int TIMER_SLOTS = 128;
+const int TIMER_BUCKETS = 40;           // bucket b holds durations in [2^b, 2^(b+1)) ns
+const int TRACE_CAPACITY = 1 << 20;
+
+struct TimerHistogram {
+    const char* name;
+    long long count;
+    long long totalNanos;
+    long long minNanos;
+    long long maxNanos;
+    long long buckets[TIMER_BUCKETS];
+};
+
+struct TraceEvent {
+    const char* name;
+    int thread;
+    long long startMicros;
+    long long durationMicros;
+};
+
+struct ThreadCounters;
+
+// Process-wide instrumentation state
+struct InstrumentRegistry {
+    mutex lock;
+    ThreadCounters* threads;             // live per-thread blocks
+    long long retired[COUNTER_KINDS];    // counts of finished threads
+    long long baseline[COUNTER_KINDS];   // totals at the last reset
+    int nextThread;
+
+    TimerHistogram timers[TIMER_SLOTS];
+    int timerCount;
+
+    TraceEvent* trace;
+    int traceSize;
+    long long traceDropped;
+    atomic<bool> tracing;
+    chrono::steady_clock::time_point epoch;
+
+    InstrumentRegistry() : threads(nullptr), nextThread(0), timerCount(0), trace(nullptr), traceSize(0),
+                           traceDropped(0), tracing(false), epoch(chrono::steady_clock::now()) {
+        for (int i = 0; i < COUNTER_KINDS; i++) retired[i] = baseline[i] = 0;
+    }
+};
+
+// Never destroyed: pool threads still report while statics are torn down
+inline InstrumentRegistry& instrumentRegistry() {
+    static InstrumentRegistry* registry = new InstrumentRegistry();
+    return *registry;
+}
+
+struct ThreadCounters {
+    atomic<long long> values[COUNTER_KINDS];
+    int thread;
+    ThreadCounters* next;
+
+    ThreadCounters() {
+        for (int i = 0; i < COUNTER_KINDS; i++) values[i].store(0, memory_order_relaxed);
+        InstrumentRegistry& registry = instrumentRegistry();
+        lock_guard<mutex> guard(registry.lock);
+        thread = registry.nextThread++;
+        next = registry.threads;
+        registry.threads = this;
+    }
+
+    ~ThreadCounters() {
+        InstrumentRegistry& registry = instrumentRegistry();
+        lock_guard<mutex> guard(registry.lock);
+        for (int i = 0; i < COUNTER_KINDS; i++) registry.retired[i] += values[i].load(memory_order_relaxed);
+        for (ThreadCounters** link = &registry.threads; *link != nullptr; link = &(*link)->next) {
+            if (*link == this) {
+                *link = next;
+                break;
+            }
+        }
+    }
+};
+
+inline ThreadCounters& threadCounters() {
+    thread_local ThreadCounters counters;
+    return counters;
+}
+
+inline void instrumentCount(InstrumentCounter counter, long long n) {
+    atomic<long long>& value = threadCounters().values[counter];
+    value.store(value.load(memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+// Totals over all threads since the start; call with the registry locked
+inline CounterSnapshot rawInstrumentCounters(const InstrumentRegistry& registry) {
+    CounterSnapshot snapshot;
+    for (int i = 0; i < COUNTER_KINDS; i++) snapshot.values[i] = registry.retired[i];
+    for (ThreadCounters* t = registry.threads; t != nullptr; t = t->next) {
+        for (int i = 0; i < COUNTER_KINDS; i++) snapshot.values[i] += t->values[i].load(memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+// Totals over all threads since the last reset
+inline CounterSnapshot instrumentCounters() {
+    InstrumentRegistry& registry = instrumentRegistry();
+    lock_guard<mutex> guard(registry.lock);
+    CounterSnapshot snapshot = rawInstrumentCounters(registry);
+    for (int i = 0; i < COUNTER_KINDS; i++) snapshot.values[i] -= registry.baseline[i];
+    return snapshot;
+}
+
+inline int timerBucket(long long nanos) {
+    int bucket = 0;
+    while (nanos > 1 && bucket < TIMER_BUCKETS - 1) {
+        nanos >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+inline void recordTimer(const char* name, chrono::steady_clock::time_point start, chrono::steady_clock::time_point end) {
+    InstrumentRegistry& registry = instrumentRegistry();
+    long long nanos = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+    int thread = registry.tracing.load(memory_order_relaxed) ? threadCounters().thread : 0;
+    lock_guard<mutex> guard(registry.lock);
+
+    TimerHistogram* timer = nullptr;
+    for (int i = 0; i < registry.timerCount && timer == nullptr; i++) {
+        if (registry.timers[i].name == name || strcmp(registry.timers[i].name, name) == 0) timer = &registry.timers[i];
+    }
+    if (timer == nullptr && registry.timerCount < TIMER_SLOTS) {
+        timer = &registry.timers[registry.timerCount++];
+        memset(timer, 0, sizeof(TimerHistogram));
+        timer->name = name;
+        timer->minNanos = nanos;
+    }
+    if (timer != nullptr) {
+        timer->count++;
+        timer->totalNanos += nanos;
+        timer->minNanos = min(timer->minNanos, nanos);
+        timer->maxNanos = max(timer->maxNanos, nanos);
+        timer->buckets[timerBucket(nanos)]++;
+    }
+
+    if (registry.tracing.load(memory_order_relaxed) && registry.trace != nullptr) {
+        if (registry.traceSize < TRACE_CAPACITY) {
+            TraceEvent& event = registry.trace[registry.traceSize++];
+            event.name = name;
+            event.thread = thread;
+            event.startMicros = chrono::duration_cast<chrono::microseconds>(start - registry.epoch).count();
+            event.durationMicros = chrono::duration_cast<chrono::microseconds>(end - start).count();
+        } else {
+            registry.traceDropped++;
+        }
+    }
+}
+
+class ScopedTimer {
+private:
+    const char* name;
+    chrono::steady_clock::time_point start;
+
+public:
+    explicit ScopedTimer(const char* timerName) : name(timerName), start(chrono::steady_clock::now()) {}
+    ~ScopedTimer() { recordTimer(name, start, chrono::steady_clock::now()); }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+#if !defined(NO_INSTRUMENTATION)
+#define INSTRUMENTATION_ENABLED 1
+#define INSTRUMENT_CONCAT_INNER(a, b) a##b
+#define INSTRUMENT_CONCAT(a, b) INSTRUMENT_CONCAT_INNER(a, b)
+#define INSTRUMENT_SCOPE(name) ScopedTimer INSTRUMENT_CONCAT(scopedTimer, __LINE__)(name)
+#define INSTRUMENT_COUNT(counter, n) instrumentCount(counter, n)
+#else
+#define INSTRUMENTATION_ENABLED 0
+#define INSTRUMENT_SCOPE(name) ((void)0)
+#define INSTRUMENT_COUNT(counter, n) ((void)0)
+#endif
+
+// Start or stop collecting trace events; starting clears the previous trace
+inline void setTracing(bool enabled) {
+    InstrumentRegistry& registry = instrumentRegistry();
+    lock_guard<mutex> guard(registry.lock);
+    if (enabled) {
+        if (registry.trace == nullptr) registry.trace = new TraceEvent[TRACE_CAPACITY];
+        registry.traceSize = 0;
+        registry.traceDropped = 0;
+    }
+    registry.tracing.store(enabled);
+}
+
+// Clear counters, timers and trace
+inline void resetInstrumentation() {
+    InstrumentRegistry& registry = instrumentRegistry();
+    lock_guard<mutex> guard(registry.lock);
+    CounterSnapshot raw = rawInstrumentCounters(registry);
+    for (int i = 0; i < COUNTER_KINDS; i++) registry.baseline[i] = raw.values[i];
+    registry.timerCount = 0;
+    registry.traceSize = 0;
+    registry.traceDropped = 0;
+}
+
+inline void printInstrumentationSummary(ostream& out) {
+    CounterSnapshot counters = instrumentCounters();
+    InstrumentRegistry& registry = instrumentRegistry();
+    out << "\n=== Instrumentation" << (INSTRUMENTATION_ENABLED ? "" : " (compiled out)") << " ===" << endl;
+    for (int i = 0; i < COUNTER_KINDS; i++) {
+        out << left << setw(12) << instrumentCounterName(i) << right << " " << counters.values[i] << endl;
+    }
+    lock_guard<mutex> guard(registry.lock);
+    if (registry.timerCount == 0) return;
+    out << "\nTimer                          | Calls    | Total ms   | Mean us    | Min us     | Max us" << endl;
+    for (int i = 0; i < registry.timerCount; i++) {
+        const TimerHistogram& t = registry.timers[i];
+        out << left << setw(30) << t.name << right << " | " << setw(8) << t.count << " | "
+            << setw(10) << fixed << setprecision(2) << t.totalNanos / 1e6 << " | "
+            << setw(10) << t.totalNanos / 1e3 / t.count << " | " << setw(10) << t.minNanos / 1e3 << " | "
+            << setw(10) << t.maxNanos / 1e3 << endl;
+    }
+}
+
+inline void writeJsonString(ostream& out, const char* text) {
+    out << '"';
+    for (const char* p = text; *p; p++) {
+        if (*p == '"' || *p == '\\') out << '\\' << *p;
+        else if (static_cast<unsigned char>(*p) < 0x20) out << ' ';
+        else out << *p;
+    }
+    out << '"';
+}
+
+// {"counters": {...}, "timers": {name: {count, total_ns, min_ns, max_ns, histogram: [[upper_ns, count], ...]}}}
+inline void writeInstrumentationJson(ostream& out) {
+    CounterSnapshot counters = instrumentCounters();
+    InstrumentRegistry& registry = instrumentRegistry();
+    out << "{\n  \"enabled\": " << (INSTRUMENTATION_ENABLED ? "true" : "false") << ",\n  \"counters\": {";
+    for (int i = 0; i < COUNTER_KINDS; i++) {
+        out << (i ? ", " : "") << '"' << instrumentCounterName(i) << "\": " << counters.values[i];
+    }
+    out << "},\n  \"timers\": {";
+    lock_guard<mutex> guard(registry.lock);
+    for (int i = 0; i < registry.timerCount; i++) {
+        const TimerHistogram& t = registry.timers[i];
+        out << (i ? ",\n    " : "\n    ");
+        writeJsonString(out, t.name);
+        out << ": {\"count\": " << t.count << ", \"total_ns\": " << t.totalNanos << ", \"min_ns\": " << t.minNanos
+            << ", \"max_ns\": " << t.maxNanos << ", \"histogram\": [";
+        bool first = true;
+        for (int b = 0; b < TIMER_BUCKETS; b++) {
+            if (t.buckets[b] == 0) continue;
+            out << (first ? "" : ", ") << "[" << (2LL << b) << ", " << t.buckets[b] << "]";
+            first = false;
+        }
+        out << "]}";
+    }
+    out << "\n  }\n}" << endl;
+}
+
+// Chrome trace event format, loadable in chrome://tracing or Perfetto
+inline void writeChromeTrace(ostream& out) {
+    InstrumentRegistry& registry = instrumentRegistry();
+    lock_guard<mutex> guard(registry.lock);
+    out << "{\"traceEvents\": [";
+    for (int i = 0; i < registry.traceSize; i++) {
+        const TraceEvent& e = registry.trace[i];
+        out << (i ? ",\n" : "\n") << "{\"name\": ";
+        writeJsonString(out, e.name);
+        out << ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << e.thread << ", \"ts\": " << e.startMicros
+            << ", \"dur\": " << e.durationMicros << "}";
+    }
+    out << "\n], \"otherData\": {\"dropped_events\": " << registry.traceDropped << "}}" << endl;
+}
+
+inline bool saveInstrumentationJson(const char* filename) {
+    ofstream out(filename, ios::trunc);
+    if (!out.is_open()) {
+        cerr << "Error: Could not create " << filename << endl;
+        return false;
+    }
+    writeInstrumentationJson(out);
+    return out.good();
+}
+
+inline bool saveChromeTrace(const char* filename) {
+    ofstream out(filename, ios::trunc);
+    if (!out.is_open()) {
+        cerr << "Error: Could not create " << filename << endl;
+        return false;
+    }
+    writeChromeTrace(out);
+    return out.good();
+}
@@ -0,0 +1,184 @@
+#pragma once
+#include "model.hpp"
+#include "array.hpp"
+#include "snapshot_section.hpp"
+
+using namespace std;
+
+// Jobs grouped by (category, priority), so filtered queries such as "top 10
+// scientist jobs for a resume" or "priority-3 jobs with python" score or scan
+// only the jobs of the matching buckets.
+//
+// A bucket is picked by the category code and the priority (1-3; any other
+// priority goes to slot 0 of its category), so choosing buckets is array
+// arithmetic. Each bucket holds its handles in store order together with the
+// store position of every handle. select() returns one bucket as is and
+// merges several by position, so a filtered result lists jobs in the same
+// order as a filtered full scan and ties in a ranking break the same way.
+//
+// Handle is whatever the storage hands out: array positions or record
+// pointers. Ingested jobs are appended to their bucket; positions go stale
+// when the jobs are reordered, and the storages rebuild the buckets then.
+
+const int JOB_FILTER_ANY = -1;
+const int JOB_PRIORITY_SLOTS = 4;    // slot 0 for out-of-range priorities, then 1-3
+const int JOB_BUCKET_COUNT = JOB_CATEGORY_COUNT * JOB_PRIORITY_SLOTS;
+
+// Category and priority a job query is restricted to
+struct JobFilter {
+    int category;    // JobCategory code or JOB_FILTER_ANY
+    int priority;    // 1-3 or JOB_FILTER_ANY
+
+    JobFilter() : category(JOB_FILTER_ANY), priority(JOB_FILTER_ANY) {}
+    JobFilter(int jobCategory, int jobPriority) : category(jobCategory), priority(jobPriority) {}
+
+    bool isAny() const { return category == JOB_FILTER_ANY && priority == JOB_FILTER_ANY; }
+};
+
+inline int jobPrioritySlot(int priority) {
+    return priority >= 1 && priority < JOB_PRIORITY_SLOTS ? priority : 0;
+}
+
+template<typename Handle>
+class JobBuckets {
+private:
+    CustomArray<Handle> handles[JOB_BUCKET_COUNT];
+    CustomArray<int> positions[JOB_BUCKET_COUNT];     // store position of each handle, ascending
+    int jobCount;
+
+    static int bucketOf(int category, int slot) {
+        return category * JOB_PRIORITY_SLOTS + slot;
+    }
+
+    static int bucketOf(const Job& job) {
+        return bucketOf(job.categoryCode, jobPrioritySlot(job.priority));
+    }
+
+    // Buckets selected by filter, in bucket order
+    static void selectedBuckets(const JobFilter& filter, CustomArray<int>& buckets) {
+        buckets.clear();
+        int firstCategory = filter.category == JOB_FILTER_ANY ? 0 : filter.category;
+        int lastCategory = filter.category == JOB_FILTER_ANY ? JOB_CATEGORY_COUNT - 1 : filter.category;
+        if (firstCategory < 0 || lastCategory >= JOB_CATEGORY_COUNT) return;
+        for (int category = firstCategory; category <= lastCategory; category++) {
+            if (filter.priority == JOB_FILTER_ANY) {
+                for (int slot = 0; slot < JOB_PRIORITY_SLOTS; slot++) buckets.push_back(bucketOf(category, slot));
+            } else if (jobPrioritySlot(filter.priority) != 0) {
+                buckets.push_back(bucketOf(category, filter.priority));
+            }
+        }
+    }
+
+public:
+    JobBuckets() : jobCount(0) {}
+
+    void clear() {
+        for (int i = 0; i < JOB_BUCKET_COUNT; i++) {
+            handles[i].clear();
+            positions[i].clear();
+        }
+        jobCount = 0;
+    }
+
+    // forEachJob(visit) must call visit(job, handle) for every job in store
+    // order; it runs twice, to size the buckets and then to fill them
+    template<typename ForEachJob>
+    void build(ForEachJob forEachJob) {
+        clear();
+        int counts[JOB_BUCKET_COUNT] = {};
+        forEachJob([&](const Job& job, Handle) { counts[bucketOf(job)]++; });
+        for (int i = 0; i < JOB_BUCKET_COUNT; i++) {
+            handles[i].reserve(counts[i]);
+            positions[i].reserve(counts[i]);
+        }
+        forEachJob([&](const Job& job, Handle handle) { append(job, handle); });
+    }
+
+    // Add a job after the last store position
+    void append(const Job& job, Handle handle) {
+        int bucket = bucketOf(job);
+        handles[bucket].push_back(handle);
+        positions[bucket].push_back(jobCount++);
+    }
+
+    // Number of jobs filter selects
+    int count(const JobFilter& filter) const {
+        CustomArray<int> buckets;
+        selectedBuckets(filter, buckets);
+        int total = 0;
+        for (int i = 0; i < buckets.size(); i++) total += handles[buckets[i]].size();
+        return total;
+    }
+
+    // Handles of the jobs filter selects, in store order
+    void select(const JobFilter& filter, CustomArray<Handle>& out) const {
+        out.clear();
+        CustomArray<int> buckets;
+        selectedBuckets(filter, buckets);
+
+        // The non-empty buckets and a cursor into each; merge by taking the lowest position
+        CustomArray<int> live;
+        CustomArray<int> next;
+        for (int i = 0; i < buckets.size(); i++) {
+            if (handles[buckets[i]].size() == 0) continue;
+            live.push_back(buckets[i]);
+            next.push_back(0);
+        }
+        if (live.size() == 1) {
+            const CustomArray<Handle>& bucket = handles[live[0]];
+            for (int i = 0; i < bucket.size(); i++) out.push_back(bucket[i]);
+            return;
+        }
+        while (live.size() > 0) {
+            int lowest = 0;
+            for (int i = 1; i < live.size(); i++) {
+                if (positions[live[i]][next[i]] < positions[live[lowest]][next[lowest]]) lowest = i;
+            }
+            out.push_back(handles[live[lowest]][next[lowest]++]);
+            if (next[lowest] == handles[live[lowest]].size()) {
+                live[lowest] = live[live.size() - 1];
+                next[lowest] = next[next.size() - 1];
+                live.resize(live.size() - 1);
+                next.resize(next.size() - 1);
+            }
+        }
+    }
+
+    int getSize() const { return jobCount; }
+
+    // Snapshot section: the positions of every bucket
+    void save(SnapshotSectionWriter& out) const {
+        out.putValue(jobCount);
+        for (int i = 0; i < JOB_BUCKET_COUNT; i++) out.putArray(positions[i]);
+    }
+
+    // Load a saved section over the jobCount jobs of the store. jobAt(p) and
+    // handleAt(p) give the job and handle at position p; every position must
+    // be listed once, ascending, in its job's bucket. On false the buckets
+    // are left empty.
+    template<typename JobAt, typename HandleAt>
+    bool restore(SnapshotSectionReader& in, int storeSize, JobAt jobAt, HandleAt handleAt) {
+        clear();
+        int savedCount = 0;
+        bool ok = in.getValue(savedCount) && savedCount == storeSize;
+        int listed = 0;
+        for (int b = 0; ok && b < JOB_BUCKET_COUNT; b++) {
+            ok = in.getArray(positions[b]);
+            for (int k = 0; ok && k < positions[b].size(); k++) {
+                int p = positions[b][k];
+                ok = p >= 0 && p < storeSize && (k == 0 || p > positions[b][k - 1]) && bucketOf(jobAt(p)) == b;
+            }
+            listed += positions[b].size();
+        }
+        if (!ok || listed != storeSize) {
+            clear();
+            return in.fail();
+        }
+        for (int b = 0; b < JOB_BUCKET_COUNT; b++) {
+            handles[b].resize(positions[b].size());
+            for (int k = 0; k < positions[b].size(); k++) handles[b][k] = handleAt(positions[b][k]);
+        }
+        jobCount = storeSize;
+        return true;
+    }
+};
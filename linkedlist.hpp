@@ -12,6 +12,7 @@ public:
     ListNode<T>* prev;
     
     ListNode(const T& item) : data(item), next(nullptr), prev(nullptr) {}
+    ListNode(T&& item) : data(move(item)), next(nullptr), prev(nullptr) {}
     
     ~ListNode() {
         // Data will be cleaned up by its own destructor
@@ -24,6 +25,18 @@ private:
     ListNode<T>* head;
     ListNode<T>* tail;
     int size;
+
+    void linkTail(ListNode<T>* newNode) {
+        INSTRUMENT_COUNT(COUNTER_ALLOCATIONS, 1);
+        if (head == nullptr) {
+            head = tail = newNode;
+        } else {
+            tail->next = newNode;
+            newNode->prev = tail;
+            tail = newNode;
+        }
+        size++;
+    }
     
 public:
     CustomLinkedList() : head(nullptr), tail(nullptr), size(0) {}
@@ -56,16 +69,12 @@ public:
     
     // Essential for data loading
     void push_back(const T& item) {
-        ListNode<T>* newNode = new ListNode<T>(item);
-        
-        if (head == nullptr) {
-            head = tail = newNode;
-        } else {
-            tail->next = newNode;
-            newNode->prev = tail;
-            tail = newNode;
-        }
-        size++;
+        linkTail(new ListNode<T>(item));
+    }
+
+    // Take over a temporary's buffers instead of copying them
+    void push_back(T&& item) {
+        linkTail(new ListNode<T>(move(item)));
     }
     
     
@@ -106,6 +115,7 @@ public:
         for (int i = 0; i < index; ++i) {
             current = current->next;
         }
+        INSTRUMENT_COUNT(COUNTER_NODE_HOPS, index);
         return current;
     }
 
@@ -121,6 +131,7 @@ public:
         if (!nodeA || !nodeB || nodeA->next != nodeB) {
             return;
         }
+        INSTRUMENT_COUNT(COUNTER_SWAPS, 1);
 
         if (nodeA->prev) {
             nodeA->prev->next = nodeB;
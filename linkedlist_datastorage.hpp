@@ -2,6 +2,15 @@
 #include "readcsv.hpp"
 #include "linkedlist.hpp"
 #include "model.hpp"
+#include "snapshot.hpp"
+#include "query.hpp"
+#include "versioned_store.hpp"
+#include "minhash_lsh.hpp"
+#include "match_cache.hpp"
+#include "skip_list.hpp"
+#include "id_index.hpp"
+#include "skill_trie.hpp"
+#include "job_buckets.hpp"
 #include <chrono>
 
 using namespace std;
@@ -16,9 +25,160 @@ private:
     CustomLinkedList<Job> originalJobList;
     CustomLinkedList<Resume> originalResumeList;
     bool dataLoaded;
+
+    // Incremental ingestion state
+    CustomHashMap<CustomString, int> validSkillIndex;        // skill -> position in validSkills
+    PendingSkillMap pendingResumeSkills;                     // rejected resume skills -> resume ids
+    DenseIdIndex<ListNode<Resume>*> resumeNodesById;         // nodes survive swapNodes, so never stale
+    DenseIdIndex<ListNode<Resume>*> originalResumeNodesById;
+    DenseIdIndex<ListNode<Job>*> jobNodesById;
+    int nextJobId;
+    int nextResumeId;
+    long long jobFileOffset;                                 // CSV bytes already ingested
+    long long resumeFileOffset;
+    VersionedJobStore publishedStore;                        // immutable versions for concurrent readers
+    MinHashLshIndex lshIndex;                                // approximate Jaccard candidates, appended on ingest
+    bool lshIndexDirty;
+    mutable MatchCache<const Job*> matchCache;               // ranked handles per (resume, scorer, K)
+    bool matchCacheEnabled;
+    SkipListIndex<Job, JobTitleKey> jobTitleIndex;           // ordered jobList nodes, built on first use
+    SkipListIndex<Job, JobSkillCountKey> jobSkillCountIndex;
+    SkipListIndex<Job, JobPriorityKey> jobPriorityIndex;
+    bool jobIndexesBuilt;
+    bool jobsReordered;                                      // set by sorts, passed on to the store on publish
+    bool resumesReordered;
+    SkillTrie skillTrie;                                     // validSkills for completion, extended on ingest
+    JobBuckets<const Job*> jobBuckets;                       // jobList by (category, priority), rebuilt on reorder
+
+    // Build the ordered job indexes once per load; ingest keeps them current
+    void ensureJobIndexes() {
+        if (jobIndexesBuilt) return;
+        jobTitleIndex.build(jobList);
+        jobSkillCountIndex.build(jobList);
+        jobPriorityIndex.build(jobList);
+        jobIndexesBuilt = true;
+    }
+
+    void rebuildJobBuckets() {
+        jobBuckets.build([&](auto visit) {
+            for (const ListNode<Job>* node = jobList.getHead(); node != nullptr; node = node->next) visit(node->data, &node->data);
+        });
+    }
+
+    void rebuildIngestionState() {
+        validSkillIndex.clear();
+        for (int i = 0; i < validSkills.size(); i++) {
+            validSkillIndex.insert(validSkills[i], i);
+        }
+
+        resumeNodesById.clear();
+        originalResumeNodesById.clear();
+        jobNodesById.clear();
+        // jobList was replaced, so the job indexes point at freed nodes
+        jobTitleIndex.clear();
+        jobSkillCountIndex.clear();
+        jobPriorityIndex.clear();
+        jobIndexesBuilt = false;
+        nextJobId = 1;
+        nextResumeId = 1;
+        for (ListNode<Job>* current = jobList.getHead(); current != nullptr; current = current->next) {
+            jobNodesById.insert(current->data.id, current);
+            nextJobId = max(nextJobId, current->data.id + 1);
+        }
+        for (ListNode<Resume>* current = resumeList.getHead(); current != nullptr; current = current->next) {
+            resumeNodesById.insert(current->data.id, current);
+            nextResumeId = max(nextResumeId, current->data.id + 1);
+        }
+        for (ListNode<Resume>* current = originalResumeList.getHead(); current != nullptr; current = current->next) {
+            originalResumeNodesById.insert(current->data.id, current);
+        }
+
+        // The lists were replaced, so the store starts over from them
+        publishedStore.resetRecords();
+        for (ListNode<Job>* current = jobList.getHead(); current != nullptr; current = current->next)
+            publishedStore.appendJob(current->data);
+        for (ListNode<Resume>* current = resumeList.getHead(); current != nullptr; current = current->next)
+            publishedStore.appendResume(current->data);
+        for (int i = 0; i < validSkills.size(); i++) publishedStore.appendSkill(validSkills[i]);
+        jobsReordered = false;
+        resumesReordered = false;
+    }
+
+    void rebuildJobIndexes() {
+        skillTrie.build(validSkills);
+        rebuildJobBuckets();
+        lshIndexDirty = true;
+    }
+
+    // True while jobList still holds the jobs in file order, the order a
+    // snapshot stores them in
+    bool jobListInFileOrder() const {
+        const ListNode<Job>* node = jobList.getHead();
+        const ListNode<Job>* original = originalJobList.getHead();
+        for (; node != nullptr && original != nullptr; node = node->next, original = original->next) {
+            if (node->data.id != original->data.id) return false;
+        }
+        return node == nullptr && original == nullptr;
+    }
+
+    // Restore the job indexes saved with a snapshot over the lists just
+    // read; false if the trie or buckets are missing or invalid. The LSH
+    // index is built lazily anyway, so it is restored only if saved.
+    bool restoreJobIndexes(const SnapshotReader& reader) {
+        CustomArray<const Job*> byPosition;
+        byPosition.reserve(jobList.getSize());
+        for (const ListNode<Job>* node = jobList.getHead(); node != nullptr; node = node->next) byPosition.push_back(&node->data);
+        auto restored = [&](uint32_t kind, auto restore) {
+            SnapshotSectionReader section;
+            return reader.openIndex(kind, section) && restore(section) && section.finished();
+        };
+        bool ok = restored(SNAPSHOT_INDEX_SKILL_TRIE, [&](SnapshotSectionReader& in) { return skillTrie.restore(in, validSkills.size()); })
+               && restored(SNAPSHOT_INDEX_JOB_BUCKETS, [&](SnapshotSectionReader& in) {
+                      return jobBuckets.restore(in, byPosition.size(), [&](int p) -> const Job& { return *byPosition[p]; },
+                                                [&](int p) { return byPosition[p]; });
+                  });
+        if (ok) {
+            lshIndexDirty = !restored(SNAPSHOT_INDEX_LSH, [&](SnapshotSectionReader& in) { return lshIndex.restore(in, byPosition); });
+        }
+        return ok;
+    }
+
+    // Re-filter only the resumes that listed a skill which just became valid
+    int refilterResumesForNewSkills(const CustomArray<CustomString>& newSkills) {
+        CustomArray<int> affected = takeAffectedResumes(pendingResumeSkills, newSkills);
+        for (int i = 0; i < affected.size(); i++) {
+            ListNode<Resume>** node = resumeNodesById.find(affected[i]);
+            ListNode<Resume>** originalNode = originalResumeNodesById.find(affected[i]);
+            if (node == nullptr) continue;
+            Resume& resume = (*node)->data;
+            resume = preprocessResumeDescription(resume.fullDescription, resume.id, validSkillIndex, nullptr);
+            if (originalNode) (*originalNode)->data = resume;
+            publishedStore.replaceResume(resume);
+        }
+        return affected.size();
+    }
+
+    // True if resume is the data of one of the stored resume nodes
+    bool isStoredResume(const Resume& resume) const {
+        ListNode<Resume>* const* node = resumeNodesById.find(resume.id);
+        if (node != nullptr && &(*node)->data == &resume) return true;
+        node = originalResumeNodesById.find(resume.id);
+        return node != nullptr && &(*node)->data == &resume;
+    }
+
+    // Copy the records behind query handles into a standalone list
+    template<typename T>
+    static CustomLinkedList<T> copyHandles(const HandleQueryResult<T>& matches) {
+        CustomLinkedList<T> results;
+        for (int i = 0; i < matches.size(); i++) results.push_back(*matches.items[i]);
+        return results;
+    }
     
 public:
-    LinkedListDataStorage() : dataLoaded(false) {}
+    LinkedListDataStorage() : dataLoaded(false), nextJobId(1), nextResumeId(1),
+                              jobFileOffset(0), resumeFileOffset(0), lshIndexDirty(true),
+                              matchCacheEnabled(true), jobIndexesBuilt(false), jobsReordered(false),
+                              resumesReordered(false) {}
     
     ~LinkedListDataStorage() {
         // Linked lists will automatically clean up via their destructors
@@ -32,23 +192,31 @@ public:
             
             // Load jobs into linked list
             cout << "Loading jobs into linked list from " << jobFile << "..." << endl;
-            jobList = loadJobsAsLinkedList(jobFile);
+            pendingResumeSkills.clear();
+            jobList = loadJobsAsLinkedList(jobFile, &jobFileOffset);
             
             // Build valid skillset from job descriptions
             cout << "Building valid skillset..." << endl;
             validSkills = buildValidSkillset(jobList);
+            validSkillIndex.clear();
+            for (int i = 0; i < validSkills.size(); i++) {
+                validSkillIndex.insert(validSkills[i], i);
+            }
             
             // Load resumes into linked list with skillset filtering
             cout << "Loading resumes into linked list from " << resumeFile << "..." << endl;
-            resumeList = loadResumesAsLinkedList(resumeFile, validSkills);
+            resumeList = loadResumesAsLinkedList(resumeFile, validSkillIndex, &pendingResumeSkills, &resumeFileOffset);
 
             originalJobList = jobList;
             originalResumeList = resumeList;
+            rebuildIngestionState();
+            rebuildJobIndexes();
             
             dataLoaded = true;
             cout << "=== Linked List Data Loading Complete ===" << endl;
             cout << "Jobs loaded: " << jobList.getSize() << " (linked list)" << endl;
             cout << "Resumes loaded: " << resumeList.getSize() << " (linked list)" << endl;
+            publishSnapshot();
             return true;
             
         } catch (const exception& e) {
@@ -57,6 +225,170 @@ public:
         }
     }
     
+    // Write the preprocessed lists and skillset to a binary snapshot (file order)
+    bool saveSnapshot(const char* snapshotFile) const {
+        if (!dataLoaded) {
+            cout << "Linked list data not loaded!" << endl;
+            return false;
+        }
+        SnapshotWriter writer;
+        writer.setKeywordMatcher(publishedStore.getKeywordMatcher());
+        for (ListNode<Job>* current = originalJobList.getHead(); current != nullptr; current = current->next)
+            writer.addJob(current->data);
+        for (ListNode<Resume>* current = originalResumeList.getHead(); current != nullptr; current = current->next)
+            writer.addResume(current->data);
+        writer.setValidSkills(validSkills);
+        writer.setPendingSkills(pendingResumeSkills);
+        writer.setSourceOffsets(jobFileOffset, resumeFileOffset);
+        // Buckets and LSH entries follow jobList, so only a file-order list matches the records
+        writer.addIndex(SNAPSHOT_INDEX_SKILL_TRIE, skillTrie);
+        if (jobListInFileOrder()) {
+            writer.addIndex(SNAPSHOT_INDEX_JOB_BUCKETS, jobBuckets);
+            if (!lshIndexDirty) writer.addIndex(SNAPSHOT_INDEX_LSH, lshIndex);
+        }
+        return writer.write(snapshotFile);
+    }
+
+    // Warm start: restore the linked lists and job indexes from a snapshot
+    // instead of the CSV files
+    bool loadFromSnapshot(const char* snapshotFile) {
+        SnapshotReader reader;
+        if (!reader.open(snapshotFile))
+            return false;
+
+        auto start = chrono::high_resolution_clock::now();
+
+        // Masks saved for the store's keywords spare its publish the scan
+        const KeywordMatcher& keywordMatcher = publishedStore.getKeywordMatcher();
+        jobList.clear();
+        resumeList.clear();
+        for (int i = 0; i < reader.getJobCount(); i++)
+            jobList.push_back(reader.readJob(i, &keywordMatcher));
+        for (int i = 0; i < reader.getResumeCount(); i++)
+            resumeList.push_back(reader.readResume(i, &keywordMatcher));
+        validSkills = reader.readValidSkills();
+        reader.readPendingSkills(pendingResumeSkills);
+        jobFileOffset = reader.getJobSourceOffset();
+        resumeFileOffset = reader.getResumeSourceOffset();
+
+        originalJobList = jobList;
+        originalResumeList = resumeList;
+        rebuildIngestionState();
+        if (!restoreJobIndexes(reader)) rebuildJobIndexes();
+        dataLoaded = true;
+
+        auto end = chrono::high_resolution_clock::now();
+        auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
+
+        cout << "Jobs loaded: " << jobList.getSize() << " (linked list, snapshot)" << endl;
+        cout << "Resumes loaded: " << resumeList.getSize() << " (linked list, snapshot)" << endl;
+        cout << "Snapshot restored in " << duration.count() << " ms" << endl;
+        publishSnapshot();
+        return true;
+    }
+
+    // Incremental ingestion: preprocess and append new job rows to both the working
+    // and the file-order lists. New skills extend the skillset and only the resumes
+    // that listed them are re-filtered. The id index, skip lists, buckets, skill
+    // trie, LSH index and store take the new rows as they come, so the cost
+    // follows the new rows rather than the size of the lists.
+    int ingestJobLines(const CustomArray<CustomString>& lines) {
+        CustomArray<CustomString> newSkills;
+        int firstSkill = validSkills.size();
+        for (int i = 0; i < lines.size(); i++) {
+            Job job = preprocessJobDescription(lines[i], nextJobId++);
+            extendValidSkillset(job, validSkills, validSkillIndex, &newSkills);
+            jobList.push_back(job);
+            originalJobList.push_back(job);
+            jobNodesById.insert(job.id, jobList.getTailNode());
+            if (jobIndexesBuilt) {
+                jobTitleIndex.insert(jobList.getTailNode());
+                jobSkillCountIndex.insert(jobList.getTailNode());
+                jobPriorityIndex.insert(jobList.getTailNode());
+            }
+            jobBuckets.append(job, &jobList.getTailNode()->data);
+            if (!lshIndexDirty) lshIndex.append(jobList.getTailNode()->data);
+            publishedStore.appendJob(job);
+        }
+        for (int i = firstSkill; i < validSkills.size(); i++) {
+            publishedStore.appendSkill(validSkills[i]);
+            skillTrie.insert(validSkills[i], i);
+        }
+        int refiltered = refilterResumesForNewSkills(newSkills);
+        dataLoaded = dataLoaded || lines.size() > 0;
+        cout << "Ingested " << lines.size() << " jobs (" << newSkills.size() << " new skills, "
+             << refiltered << " resumes re-filtered)." << endl;
+        publishSnapshot();
+        return lines.size();
+    }
+
+    int ingestResumeLines(const CustomArray<CustomString>& lines) {
+        for (int i = 0; i < lines.size(); i++) {
+            CustomArray<CustomString> rejected;
+            Resume resume = preprocessResumeDescription(lines[i], nextResumeId++, validSkillIndex, &rejected);
+            recordRejectedSkills(pendingResumeSkills, rejected, resume.id);
+            resumeList.push_back(resume);
+            originalResumeList.push_back(resume);
+            resumeNodesById.insert(resume.id, resumeList.getTailNode());
+            originalResumeNodesById.insert(resume.id, originalResumeList.getTailNode());
+            publishedStore.appendResume(resume);
+        }
+        dataLoaded = dataLoaded || lines.size() > 0;
+        cout << "Ingested " << lines.size() << " resumes." << endl;
+        publishSnapshot();
+        return lines.size();
+    }
+
+    // Ingest rows from an in-memory CSV block (one row per line, no header)
+    int ingestJobBuffer(const char* buffer) {
+        return ingestJobLines(splitCSVBuffer(buffer));
+    }
+
+    int ingestResumeBuffer(const char* buffer) {
+        return ingestResumeLines(splitCSVBuffer(buffer));
+    }
+
+    // Ingest rows appended to the CSV files since the last load or ingest
+    int ingestNewRows(const char* jobFile = "csv/job_description.csv",
+                      const char* resumeFile = "csv/resume.csv") {
+        CSVReader jobReader(jobFile);
+        CustomArray<CustomString> jobLines = jobReader.readLinesFrom(jobFileOffset, jobFileOffset);
+        CSVReader resumeReader(resumeFile);
+        CustomArray<CustomString> resumeLines = resumeReader.readLinesFrom(resumeFileOffset, resumeFileOffset);
+
+        // Jobs first so new resumes are filtered against the extended skillset
+        int ingested = 0;
+        if (jobLines.size() > 0) ingested += ingestJobLines(jobLines);
+        if (resumeLines.size() > 0) ingested += ingestResumeLines(resumeLines);
+        if (ingested == 0) cout << "No new rows to ingest." << endl;
+        return ingested;
+    }
+
+    // Publish the working lists as a new immutable version for concurrent
+    // readers. Called after every load, ingest and sort; loads and ingests have
+    // already handed their rows to the store and the job indexes, a sort
+    // passes on the new order, rebuilds the buckets, which follow list order,
+    // and leaves the LSH index to be rebuilt on next use.
+    unsigned long long publishSnapshot() {
+        if (jobsReordered) {
+            publishedStore.reorderJobs([&](auto visit) {
+                for (const ListNode<Job>* node = jobList.getHead(); node != nullptr; node = node->next) visit(node->data);
+            });
+            rebuildJobBuckets();
+            lshIndexDirty = true;
+            jobsReordered = false;
+        }
+        if (resumesReordered) {
+            publishedStore.reorderResumes([&](auto visit) {
+                for (const ListNode<Resume>* node = resumeList.getHead(); node != nullptr; node = node->next) visit(node->data);
+            });
+            resumesReordered = false;
+        }
+        return publishedStore.publish();
+    }
+
+    VersionedJobStore& getPublishedStore() { return publishedStore; }
+
     // Getters for accessing the data
     CustomLinkedList<Job>& getJobList() { return jobList; }
     CustomLinkedList<Resume>& getResumeList() { return resumeList; }
@@ -122,145 +454,311 @@ public:
 
 // Richard's code for searching algorithms
     CustomLinkedList<Job> linearSearchJobsByTitle(const CustomString& title){
-        CustomLinkedList<Job> searchJobTitleList;
-        
-        if (!dataLoaded || jobList.empty()){
-            return searchJobTitleList;
-        }
+        HandleQueryResult<Job> matches;
+        queryJobsByTitle(title, matches);
+        return copyHandles(matches);
+    }
 
-        ListNode<Job>* current = jobList.getHead();
+    CustomLinkedList<Job> linearSearchJobsBySkills(const CustomString& skill){
+        HandleQueryResult<Job> matches;
+        queryJobsBySkill(skill, matches);
+        return copyHandles(matches);
+    }
 
-        while (current != nullptr){
-            if (strcmp(current->data.jobTitle.c_str(), title.c_str()) == 0 ){
-                searchJobTitleList.push_back(current->data);
-            }
-            current = current->next;
+    CustomLinkedList<Resume> linearSearchResumesBySkills(const CustomString& skill){
+        HandleQueryResult<Resume> matches;
+        queryResumesBySkill(skill, matches);
+        return copyHandles(matches);
+    }
+
+    // Constant-time lookups by id; the nodes stay put through sorts
+    Job* findJobById(int id) {
+        ListNode<Job>** node = jobNodesById.find(id);
+        return node ? &(*node)->data : nullptr;
+    }
+
+    Resume* findResumeById(int id) {
+        ListNode<Resume>** node = resumeNodesById.find(id);
+        return node ? &(*node)->data : nullptr;
+    }
+
+    // Read-only versions of the searches above: handles point into the stored
+    // nodes instead of copying every match, and stay valid across sorts
+    void queryJobsByTitle(const CustomString& title, HandleQueryResult<Job>& out) const {
+        out.clear();
+        if (!dataLoaded) return;
+        queryJobListByTitle(jobList, title, out);
+    }
+
+    void queryJobsBySkill(const CustomString& skill, HandleQueryResult<Job>& out) const {
+        out.clear();
+        if (!dataLoaded) return;
+        queryJobListBySkill(jobList, skill, out);
+    }
+
+    void queryResumesBySkill(const CustomString& skill, HandleQueryResult<Resume>& out) const {
+        out.clear();
+        if (!dataLoaded) return;
+        queryResumeListBySkill(resumeList, skill, out);
+    }
+
+    // === Filtered queries ===
+    // Only the jobs of the (category, priority) buckets filter selects are
+    // scanned or scored, in list order as a filtered full scan would give.
+    void queryJobsInBuckets(const JobFilter& filter, HandleQueryResult<Job>& out) const {
+        out.clear();
+        jobBuckets.select(filter, out.items);
+    }
+
+    void queryJobsBySkillFiltered(const CustomString& skill, const JobFilter& filter, HandleQueryResult<Job>& out) const {
+        if (filter.isAny()) {
+            queryJobsBySkill(skill, out);
+            return;
+        }
+        out.clear();
+        if (!dataLoaded || skill.c_str() == nullptr) return;
+        jobBuckets.select(filter, out.scratchItems);
+        for (int i = 0; i < out.scratchItems.size(); i++) {
+            if (hasExactSkill(out.scratchItems[i]->skills, skill)) out.items.push_back(out.scratchItems[i]);
         }
-        return searchJobTitleList;
     }
 
-    CustomLinkedList<Job> linearSearchJobsBySkills(const CustomString& skill){
-        CustomLinkedList<Job> searchJobSkillList;
-        
-        if (!dataLoaded || jobList.empty()){
-            return searchJobSkillList;
+    // Jobs with a positive score, like queryTopMatchesWith
+    template<typename Scorer>
+    void queryTopMatchesFiltered(const Resume& resume, Scorer& scorer, const JobFilter& filter, int topN,
+                                 HandleQueryResult<Job>& out) const {
+        if (filter.isAny()) {
+            queryTopMatchesWith(resume, scorer, topN, out);
+            return;
         }
+        out.clear();
+        if (!dataLoaded) return;
+        jobBuckets.select(filter, out.scratchItems);
+        rankJobHandles(resume, scorer, topN, true, out);
+    }
 
-        ListNode<Job>* current = jobList.getHead();
+    int countJobsInBuckets(const JobFilter& filter) const { return jobBuckets.count(filter); }
 
-        while (current != nullptr){
-            for (int i = 0; i < current->data.skills.size(); ++i){
-                if (strcmp(current->data.skills[i].c_str(), skill.c_str()) == 0 ){
-                    searchJobSkillList.push_back(current->data);
-                    break;
-                }
-            }
-            current = current->next;
-        }
-        return searchJobSkillList;
+    // Skills of the valid skillset are stored in the same spelling, so the
+    // exact list searches above find them
+    void queryJobsBySkillId(int skillId, HandleQueryResult<Job>& out) const {
+        queryJobsBySkill(validSkills[skillId], out);
     }
 
-    CustomLinkedList<Resume> linearSearchResumesBySkills(const CustomString& skill){
-        CustomLinkedList<Resume> searchResumeSkillList;
-        
-        if (!dataLoaded || resumeList.empty()){
-            return searchResumeSkillList;
+    void queryResumesBySkillId(int skillId, HandleQueryResult<Resume>& out) const {
+        queryResumesBySkill(validSkills[skillId], out);
+    }
+
+    // === Skill lookup ===
+    // Ids are positions in the valid skillset. Resolving takes the exact skill
+    // ignoring case, else the closest one within skillEditBound edits.
+    int resolveSkillId(const CustomString& text) const {
+        return skillTrie.resolve(text, skillEditBound(text.size()));
+    }
+
+    // Up to limit skill ids starting with prefix, in lexicographic order
+    void completeSkill(const CustomString& prefix, int limit, CustomArray<int>& ids) const {
+        skillTrie.complete(prefix, limit, ids);
+    }
+
+    const CustomString& getSkillName(int skillId) const { return validSkills[skillId]; }
+    const SkillTrie& getSkillTrie() const { return skillTrie; }
+
+    // Top jobs by Jaccard score; scores stay in out, jobList is left untouched.
+    // Rankings of stored resumes are cached until the next publish.
+    void queryTopMatches(const Resume& resume, int topN, HandleQueryResult<Job>& out) const {
+        out.clear();
+        if (!dataLoaded) return;
+        if (!matchCacheEnabled || !isStoredResume(resume)) {
+            queryTopJobListByJaccard(jobList, resume, topN, out);
+            return;
         }
+        MatchCacheKey key(resume.id, JaccardScorer::label(), topN);
+        unsigned long long version = publishedStore.getVersion();
+        if (matchCache.lookup(key, version, out.items, out.scores)) return;
+        queryTopJobListByJaccard(jobList, resume, topN, out);
+        matchCache.store(key, version, out.items, out.scores);
+    }
 
-        ListNode<Resume>* current = resumeList.getHead();
+    MatchCacheStats getMatchCacheStats() const { return matchCache.getStats(); }
+    void setMatchCacheEnabled(bool enabled) { matchCacheEnabled = enabled; }
 
-        while (current != nullptr){
-            for (int i = 0; i < current->data.resumeSkills.size(); ++i){
-                if (strcmp(current->data.resumeSkills[i].c_str(), skill.c_str()) == 0 ){
-                    searchResumeSkillList.push_back(current->data);
-                    break;
-                }
-            }
-            current = current->next;
+    // Top jobs under any scoring policy from scoring.hpp, positive scores only
+    template<typename Scorer>
+    void queryTopMatchesWith(const Resume& resume, Scorer& scorer, int topN, HandleQueryResult<Job>& out) const {
+        out.clear();
+        if (!dataLoaded) return;
+        queryTopJobList(jobList, resume, scorer, topN, true, out);
+    }
+
+    // MinHash LSH index over jobList, built on first use after a load or sort
+    const MinHashLshIndex& getLshIndex() {
+        if (lshIndexDirty) {
+            lshIndex.build(jobList);
+            lshIndexDirty = false;
         }
-        return searchResumeSkillList;
+        return lshIndex;
+    }
+
+    void configureLsh(const LshConfig& config) {
+        lshIndex.configure(config);
+        lshIndexDirty = true;
+    }
+
+    // Approximate queryTopMatches: exact Jaccard scores over the LSH
+    // candidates only. Returns the number of jobs scored.
+    int queryApproximateTopMatches(const Resume& resume, int topN, HandleQueryResult<Job>& out) {
+        out.clear();
+        if (!dataLoaded) return 0;
+        return getLshIndex().search(resume, topN, out);
+    }
+
+    // Skip-list versions of the job searches: O(log N) to the first match,
+    // then matches in key order (ties by id) instead of list order
+    void queryJobsByTitleIndexed(const CustomString& title, HandleQueryResult<Job>& out) {
+        out.clear();
+        if (!dataLoaded || title.c_str() == nullptr) return;
+        ensureJobIndexes();
+        jobTitleIndex.find(title.c_str(), out);
+    }
+
+    void queryJobsBySkillCountRange(int low, int high, HandleQueryResult<Job>& out) {
+        out.clear();
+        if (!dataLoaded) return;
+        ensureJobIndexes();
+        jobSkillCountIndex.range(low, high, out);
+    }
+
+    void queryJobsByPriorityRange(int low, int high, HandleQueryResult<Job>& out) {
+        out.clear();
+        if (!dataLoaded) return;
+        ensureJobIndexes();
+        jobPriorityIndex.range(low, high, out);
+    }
+
+    const SkipListIndex<Job, JobTitleKey>& getJobTitleIndex() {
+        ensureJobIndexes();
+        return jobTitleIndex;
     }
 
 //Leon Kin's code - Bubble Sort and Job matching and performance testing.
     void bubbleSortJobsByTitle() {
         if (!dataLoaded || jobList.getSize() < 2) return;
+        INSTRUMENT_SCOPE("sort.jobs.title.bubble");
         cout << "Sorting jobs by title (A-Z)..." << endl;
+        jobsReordered = true;
+        long long comparisons = 0, swaps = 0;
         bool swapped;
         do {
             swapped = false;
             ListNode<Job>* current = jobList.getHead();
             while (current && current->next) {
+                comparisons++;
                 if (strcmp(current->data.jobTitle.c_str(), current->next->data.jobTitle.c_str()) > 0) {
                     jobList.swapNodes(current, current->next);
                     swapped = true;
+                    swaps++;
                 }
                 current = current->next;
             }
         } while (swapped);
+        INSTRUMENT_COUNT(COUNTER_COMPARISONS, comparisons);
+        INSTRUMENT_COUNT(COUNTER_STRCMP, comparisons);
+        INSTRUMENT_COUNT(COUNTER_NODE_HOPS, comparisons);
+        INSTRUMENT_COUNT(COUNTER_SWAPS, swaps);
         cout << "Jobs sorted by title." << endl;
+        publishSnapshot();
     }
 
     void bubbleSortJobsBySkillCount() {
         if (!dataLoaded || jobList.getSize() < 2) return;
+        INSTRUMENT_SCOPE("sort.jobs.skillCount.bubble");
         cout << "Sorting jobs by skill count..." << endl;
+        jobsReordered = true;
+        long long comparisons = 0, swaps = 0;
         bool swapped;
         do {
             swapped = false;
             ListNode<Job>* current = jobList.getHead();
             while (current && current->next) {
+                comparisons++;
                 if (current->data.skillCount > current->next->data.skillCount) {
                     jobList.swapNodes(current, current->next);
                     swapped = true;
+                    swaps++;
                 }
                 current = current->next;
             }
         } while (swapped);
+        INSTRUMENT_COUNT(COUNTER_COMPARISONS, comparisons);
+        INSTRUMENT_COUNT(COUNTER_NODE_HOPS, comparisons);
+        INSTRUMENT_COUNT(COUNTER_SWAPS, swaps);
         cout << "Jobs sorted by skill count." << endl;
+        publishSnapshot();
     }
 
     void bubbleSortResumesBySkillCount() {
         if (!dataLoaded || resumeList.getSize() < 2) return;
+        INSTRUMENT_SCOPE("sort.resumes.skillCount.bubble");
         cout << "Sorting resumes by skill count..." << endl;
+        resumesReordered = true;
+        long long comparisons = 0, swaps = 0;
         bool swapped;
         do {
             swapped = false;
             ListNode<Resume>* current = resumeList.getHead();
             while (current && current->next) {
+                comparisons++;
                 if (current->data.skillCount > current->next->data.skillCount) {
                     resumeList.swapNodes(current, current->next);
                     swapped = true;
+                    swaps++;
                 }
                 current = current->next;
             }
         } while (swapped);
+        INSTRUMENT_COUNT(COUNTER_COMPARISONS, comparisons);
+        INSTRUMENT_COUNT(COUNTER_NODE_HOPS, comparisons);
+        INSTRUMENT_COUNT(COUNTER_SWAPS, swaps);
         cout << "Resumes sorted by skill count." << endl;
+        publishSnapshot();
     }
 
     void bubbleSortJobsByMatchScore() {
         if (!dataLoaded || jobList.getSize() < 2) return;
+        INSTRUMENT_SCOPE("sort.jobs.matchScore.bubble");
         cout << "Sorting jobs by match score..." << endl;
+        jobsReordered = true;
+        long long comparisons = 0, swaps = 0;
         bool swapped;
         do {
             swapped = false;
             ListNode<Job>* current = jobList.getHead();
             while (current && current->next) {
+                comparisons++;
                 if (current->data.matchScore < current->next->data.matchScore) { // Descending
                     jobList.swapNodes(current, current->next);
                     swapped = true;
+                    swaps++;
                 }
                 current = current->next;
             }
         } while (swapped);
+        INSTRUMENT_COUNT(COUNTER_COMPARISONS, comparisons);
+        INSTRUMENT_COUNT(COUNTER_NODE_HOPS, comparisons);
+        INSTRUMENT_COUNT(COUNTER_SWAPS, swaps);
         cout << "Jobs sorted by match score." << endl;
+        publishSnapshot();
     }
 
-    void findAndDisplayTopMatches(int resumeIndex) {
+    void findAndDisplayTopMatches(int resumeIndex) const {
+        INSTRUMENT_SCOPE("query.findAndDisplayTopMatches");
         if (resumeIndex < 0 || originalResumeList.getSize() <= resumeIndex) {
             cout << "Invalid resume index." << endl;
             return;
         }
 
-        Resume& selectedResume = originalResumeList[resumeIndex];
+        const Resume& selectedResume = originalResumeList[resumeIndex];
         
         cout << "\nFinding job matches for Resume ID: " << selectedResume.id << endl;
         cout << "Resume Skills (" << selectedResume.skillCount << "): ";
@@ -269,33 +767,13 @@ public:
         }
         cout << endl;
 
-        for (int i = 0; i < jobList.getSize(); ++i) {
-            Job& currentJob = jobList[i];
-            
-            int matchingSkills = 0;
-            for (int j = 0; j < selectedResume.lowerCaseSkills.size(); ++j) {
-                for (int k = 0; k < currentJob.lowerCaseSkills.size(); ++k) {
-                    if (strcmp(selectedResume.lowerCaseSkills[j].c_str(), currentJob.lowerCaseSkills[k].c_str()) == 0) {
-                        matchingSkills++;
-                        break;
-                    }
-                }
-            }
-            
-            int unionSize = selectedResume.skillCount + currentJob.skillCount - matchingSkills;
-            currentJob.matchScore = (unionSize > 0) ? static_cast<double>(matchingSkills) / unionSize : 0.0;
-        }
-
-        bubbleSortJobsByMatchScore();
+        HandleQueryResult<Job> matches;
+        queryTopMatches(selectedResume, 5, matches);
 
         cout << "\n--- Top 5 Job Matches ---" << endl;
-        int count = 0;
-        for (int i = 0; i < jobList.getSize() && count < 5; ++i) {
-            if (jobList[i].matchScore > 0) {
-                cout << "Match Score: " << (jobList[i].matchScore * 100) << "%" << endl;
-                jobList[i].display();
-                count++;
-            }
+        for (int i = 0; i < matches.size(); ++i) {
+            cout << "Match Score: " << (matches.scores[i] * 100) << "%" << endl;
+            matches.items[i]->display();
         }
     }
 
@@ -311,6 +789,7 @@ public:
     }
 
     void runPerformanceTests() {
+        INSTRUMENT_SCOPE("bench.linkedlist.performanceTests");
         if (!dataLoaded) {
             cout << "Please load data first." << endl;
             return;
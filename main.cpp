@@ -8,18 +8,45 @@ using namespace std;
 // Include the array menu implementation directly to avoid separate linkage
 #include "test_array.cpp"
 #include "test_linkedlist.cpp"
+#include "workload.hpp"
 
 void displayTopLevelMenu(){
     cout << "\n=== Job Matching System - Main Menu ===" << endl;
     cout << "Select a data structure to test:" << endl;
     cout << "1. Linked List Implementation" << endl;
     cout << "2. Array Implementation" << endl;
+    cout << "3. Thread Pool Settings & Timing" << endl;
     cout << "0. Exit Program" << endl;
     cout << "=========================================" << endl;
     cout << "Enter your choice: ";
 }
 
-int main() {
+// Show per-worker and per-region timing, optionally change the worker count
+void runThreadPoolMenu() {
+    threadPool().printStats();
+    printInstrumentationSummary(cout);
+    cout << "\nEnter new worker count (0 to keep " << threadPool().getWorkerCount()
+         << ", -1 to reset timing): ";
+    int workers;
+    if (!(cin >> workers)) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        return;
+    }
+    if (workers > 0) {
+        setThreadPoolWorkers(workers);
+        cout << "Thread pool now uses " << threadPool().getWorkerCount() << " workers." << endl;
+    } else if (workers < 0) {
+        threadPool().resetStats();
+        resetInstrumentation();
+        cout << "Timing counters reset." << endl;
+    }
+}
+
+// With options (see workload.hpp) runs them without prompts, otherwise the menu
+int main(int argc, char** argv) {
+    if (argc > 1) return runCommandLine(argc, argv);
+
     cout << "=== Job Description & Resume Data Structures Project ===" << endl;
     cout << "================================================" << endl;
     int choice;
@@ -48,6 +75,9 @@ int main() {
                 cin.clear();
                 cin.ignore(numeric_limits<streamsize>::max(), '\n');
                 break;
+            case 3:
+                runThreadPoolMenu();
+                break;
             case 0:
                 cout << "Exiting program." << endl;
                 break;
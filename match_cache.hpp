@@ -0,0 +1,163 @@
+#pragma once
+#include "model.hpp"
+#include "array.hpp"
+#include "hashmap.hpp"
+#include <cstring>
+#include <mutex>
+
+using namespace std;
+
+// LRU cache of ranked match results per (resume id, scorer, K).
+//
+// Item is what a ranking returns: an array position (int) or a list handle
+// (const Job*). Every lookup and store carries the store version the ranking
+// was computed against; when the version moves (load, ingest, sort - anything
+// that publishes) the whole cache is dropped, so a hit is always a ranking of
+// the current jobs. Entries live in a fixed slot array linked in recency order,
+// the map only holds slot numbers. One mutex guards everything; a hit costs a
+// hash lookup and a copy of K entries.
+
+struct MatchCacheKey {
+    int resumeId;
+    const char* scorer;   // scorer label, compared by content
+    int k;
+
+    MatchCacheKey() : resumeId(0), scorer(""), k(0) {}
+    MatchCacheKey(int id, const char* scorerLabel, int topK) : resumeId(id), scorer(scorerLabel), k(topK) {}
+};
+
+inline unsigned int hashKey(const MatchCacheKey& key) {
+    unsigned int h = hashKey(key.resumeId);
+    h = h * 31 + hashBytes(key.scorer, static_cast<int>(strlen(key.scorer)));
+    return h * 31 + hashKey(key.k);
+}
+
+inline bool keyEquals(const MatchCacheKey& a, const MatchCacheKey& b) {
+    return a.resumeId == b.resumeId && a.k == b.k && strcmp(a.scorer, b.scorer) == 0;
+}
+
+struct MatchCacheStats {
+    long long hits;
+    long long misses;
+    long long evictions;
+    long long invalidations;   // whole-cache drops on a version change
+    int entries;
+    int capacity;
+};
+
+template<typename Item>
+class MatchCache {
+private:
+    struct Entry {
+        MatchCacheKey key;
+        CustomArray<Item> items;
+        CustomArray<double> scores;
+        int prev;
+        int next;
+    };
+
+    Entry* slots;
+    int capacity;
+    int used;
+    int head;                                   // most recently used, -1 when empty
+    int tail;                                   // least recently used
+    CustomHashMap<MatchCacheKey, int> slotOf;
+    unsigned long long version;
+    MatchCacheStats stats;
+    mutable mutex lock;
+
+    void unlink(int slot) {
+        Entry& e = slots[slot];
+        if (e.prev >= 0) slots[e.prev].next = e.next;
+        else head = e.next;
+        if (e.next >= 0) slots[e.next].prev = e.prev;
+        else tail = e.prev;
+    }
+
+    void pushFront(int slot) {
+        slots[slot].prev = -1;
+        slots[slot].next = head;
+        if (head >= 0) slots[head].prev = slot;
+        head = slot;
+        if (tail < 0) tail = slot;
+    }
+
+    // Drop everything computed against another version
+    void syncVersion(unsigned long long storeVersion) {
+        if (storeVersion == version) return;
+        if (used > 0) stats.invalidations++;
+        slotOf.clear();
+        used = 0;
+        head = tail = -1;
+        version = storeVersion;
+    }
+
+public:
+    explicit MatchCache(int maxEntries = 1024)
+        : capacity(maxEntries > 0 ? maxEntries : 1), used(0), head(-1), tail(-1), version(0) {
+        slots = new Entry[capacity];
+        stats = {0, 0, 0, 0, 0, capacity};
+    }
+
+    ~MatchCache() { delete[] slots; }
+
+    MatchCache(const MatchCache&) = delete;
+    MatchCache& operator=(const MatchCache&) = delete;
+
+    // Copy the cached ranking for key into items/scores; false on a miss
+    bool lookup(const MatchCacheKey& key, unsigned long long storeVersion,
+                CustomArray<Item>& items, CustomArray<double>& scores) {
+        lock_guard<mutex> guard(lock);
+        syncVersion(storeVersion);
+        const int* slot = slotOf.find(key);
+        if (slot == nullptr) {
+            stats.misses++;
+            return false;
+        }
+        stats.hits++;
+        unlink(*slot);
+        pushFront(*slot);
+        items = slots[*slot].items;
+        scores = slots[*slot].scores;
+        return true;
+    }
+
+    void store(const MatchCacheKey& key, unsigned long long storeVersion,
+               const CustomArray<Item>& items, const CustomArray<double>& scores) {
+        lock_guard<mutex> guard(lock);
+        syncVersion(storeVersion);
+        const int* existing = slotOf.find(key);
+        int slot;
+        if (existing != nullptr) {
+            slot = *existing;
+            unlink(slot);
+        } else if (used < capacity) {
+            slot = used++;
+        } else {
+            slot = tail;
+            unlink(slot);
+            slotOf.remove(slots[slot].key);
+            stats.evictions++;
+        }
+        Entry& e = slots[slot];
+        e.key = key;
+        e.items = items;
+        e.scores = scores;
+        if (existing == nullptr) slotOf.insert(key, slot);
+        pushFront(slot);
+    }
+
+    void clear() {
+        lock_guard<mutex> guard(lock);
+        slotOf.clear();
+        used = 0;
+        head = tail = -1;
+    }
+
+    MatchCacheStats getStats() const {
+        lock_guard<mutex> guard(lock);
+        MatchCacheStats current = stats;
+        current.entries = used;
+        return current;
+    }
+};
@@ -0,0 +1,244 @@
+#pragma once
+#include "array.hpp"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+using namespace std;
+
+// Buffered, asynchronous output of batch match results.
+//
+// Producers (the batch loop) append fixed-size MatchRecords to a pending
+// batch under a short lock. A writer thread swaps the whole batch out, encodes
+// it as CSV or binary into a MATCH_OUTPUT_BUFFER byte buffer and writes that in
+// one call, so formatting and I/O overlap with scoring. When the writer falls
+// more than maxPendingRows behind, producers wait (the wait is reported as
+// stall time).
+//
+// CSV:    resume_id,job_id,rank,score   one row per line, score with 6 decimals
+// Binary: MatchFileHeader then MatchRecord[rowCount], native endianness
+
+enum MatchOutputFormat {
+    MATCH_OUTPUT_CSV,
+    MATCH_OUTPUT_BINARY
+};
+
+const char MATCH_FILE_MAGIC[8] = {'J', 'M', 'M', 'A', 'T', 'C', 'H', '\0'};
+const uint32_t MATCH_FILE_VERSION = 1;
+const int MATCH_OUTPUT_BUFFER = 1 << 20;
+
+struct MatchRecord {
+    int32_t resumeId;
+    int32_t jobId;
+    int32_t rank;        // 1 = best match
+    int32_t reserved;
+    double score;
+};
+
+struct MatchFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t rowCount;   // filled in on close
+};
+
+// Decimal digits of value into out, returns the length
+inline int formatUnsigned(unsigned long long value, char* out) {
+    char digits[20];
+    int n = 0;
+    do {
+        digits[n++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    for (int i = 0; i < n; i++) out[i] = digits[n - 1 - i];
+    return n;
+}
+
+// value with 6 decimals (like "%.6f" for |value| < 9e12), returns the length
+inline int formatFixed6(double value, char* out) {
+    int n = 0;
+    if (value != value) {
+        memcpy(out, "nan", 3);
+        return 3;
+    }
+    if (value < 0) {
+        out[n++] = '-';
+        value = -value;
+    }
+    unsigned long long scaled = static_cast<unsigned long long>(llround(value * 1e6));
+    n += formatUnsigned(scaled / 1000000, out + n);
+    out[n++] = '.';
+    unsigned long long fraction = scaled % 1000000;
+    for (int i = 5; i >= 0; i--) {
+        out[n + i] = static_cast<char>('0' + fraction % 10);
+        fraction /= 10;
+    }
+    return n + 6;
+}
+
+inline int formatInt(int value, char* out) {
+    if (value < 0) {
+        out[0] = '-';
+        return 1 + formatUnsigned(static_cast<unsigned long long>(-static_cast<long long>(value)), out + 1);
+    }
+    return formatUnsigned(static_cast<unsigned long long>(value), out);
+}
+
+class MatchOutputWriter {
+private:
+    ofstream out;
+    MatchOutputFormat format;
+    int batchRows;
+    int maxPendingRows;
+
+    thread worker;
+    mutex lock;
+    condition_variable batchReady;       // worker waits for a full batch or close
+    condition_variable batchTaken;       // producers wait while too far ahead
+    CustomArray<MatchRecord> pending;
+    bool closing;
+    bool failed;
+
+    CustomArray<char> buffer;
+    int bufferUsed;
+    long long rowsWritten;
+    long long bytesWritten;
+    long long stallNanos;
+
+    void flushBuffer() {
+        if (bufferUsed == 0) return;
+        out.write(&buffer[0], bufferUsed);
+        if (!out.good()) failed = true;
+        bytesWritten += bufferUsed;
+        bufferUsed = 0;
+    }
+
+    void encode(const MatchRecord& row) {
+        const int maxRowBytes = format == MATCH_OUTPUT_CSV ? 80 : static_cast<int>(sizeof(MatchRecord));
+        if (bufferUsed + maxRowBytes > buffer.size()) flushBuffer();
+        char* p = &buffer[bufferUsed];
+        if (format == MATCH_OUTPUT_BINARY) {
+            memcpy(p, &row, sizeof(MatchRecord));
+            bufferUsed += sizeof(MatchRecord);
+            return;
+        }
+        int n = formatInt(row.resumeId, p);
+        p[n++] = ',';
+        n += formatInt(row.jobId, p + n);
+        p[n++] = ',';
+        n += formatInt(row.rank, p + n);
+        p[n++] = ',';
+        n += formatFixed6(row.score, p + n);
+        p[n++] = '\n';
+        bufferUsed += n;
+    }
+
+    void run() {
+        CustomArray<MatchRecord> writing;
+        while (true) {
+            {
+                unique_lock<mutex> guard(lock);
+                batchReady.wait(guard, [this] { return closing || pending.size() >= batchRows; });
+                if (pending.empty() && closing) break;
+                swap(writing, pending);
+            }
+            batchTaken.notify_all();
+            for (int i = 0; i < writing.size(); i++) encode(writing[i]);
+            rowsWritten += writing.size();
+            writing.clear();
+            flushBuffer();
+        }
+    }
+
+public:
+    MatchOutputWriter() : format(MATCH_OUTPUT_CSV), batchRows(0), maxPendingRows(0), closing(false), failed(false),
+                          bufferUsed(0), rowsWritten(0), bytesWritten(0), stallNanos(0) {}
+
+    ~MatchOutputWriter() { close(); }
+
+    MatchOutputWriter(const MatchOutputWriter&) = delete;
+    MatchOutputWriter& operator=(const MatchOutputWriter&) = delete;
+
+    // Start writing filename; rows are handed to the writer thread batchRows at a time
+    bool open(const char* filename, MatchOutputFormat outputFormat, int rowsPerBatch = 16384) {
+        close();
+        out.open(filename, ios::binary | ios::trunc);
+        if (!out.is_open()) {
+            cerr << "Error: Could not create match output " << filename << endl;
+            return false;
+        }
+        format = outputFormat;
+        batchRows = rowsPerBatch > 0 ? rowsPerBatch : 1;
+        maxPendingRows = batchRows * 8;
+        closing = false;
+        failed = false;
+        buffer.resize(MATCH_OUTPUT_BUFFER);
+        bufferUsed = 0;
+        rowsWritten = 0;
+        bytesWritten = 0;
+        stallNanos = 0;
+
+        if (format == MATCH_OUTPUT_BINARY) {
+            MatchFileHeader header;
+            memset(&header, 0, sizeof(header));
+            memcpy(header.magic, MATCH_FILE_MAGIC, sizeof(header.magic));
+            header.version = MATCH_FILE_VERSION;
+            header.recordSize = sizeof(MatchRecord);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            bytesWritten += sizeof(header);
+        } else {
+            const char* columns = "resume_id,job_id,rank,score\n";
+            out.write(columns, strlen(columns));
+            bytesWritten += strlen(columns);
+        }
+        worker = thread([this] { run(); });
+        return true;
+    }
+
+    bool isOpen() const { return out.is_open(); }
+
+    // Queue rows; safe to call from several threads
+    void append(const MatchRecord* rows, int count) {
+        if (count <= 0) return;
+        unique_lock<mutex> guard(lock);
+        if (pending.size() >= maxPendingRows) {
+            auto start = chrono::steady_clock::now();
+            batchTaken.wait(guard, [this] { return pending.size() < maxPendingRows; });
+            stallNanos += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+        }
+        for (int i = 0; i < count; i++) pending.push_back(rows[i]);
+        if (pending.size() >= batchRows) batchReady.notify_one();
+    }
+
+    // Drain, finish the file and stop the writer thread; true if every write succeeded
+    bool close() {
+        if (!out.is_open()) return !failed;
+        {
+            lock_guard<mutex> guard(lock);
+            closing = true;
+        }
+        batchReady.notify_one();
+        if (worker.joinable()) worker.join();
+
+        if (format == MATCH_OUTPUT_BINARY) {
+            uint64_t rowCount = static_cast<uint64_t>(rowsWritten);
+            out.seekp(offsetof(MatchFileHeader, rowCount));
+            out.write(reinterpret_cast<const char*>(&rowCount), sizeof(rowCount));
+        }
+        out.close();
+        if (out.fail()) failed = true;
+        buffer = CustomArray<char>();
+        return !failed;
+    }
+
+    long long getRowsWritten() const { return rowsWritten; }
+    long long getBytesWritten() const { return bytesWritten; }
+    double getStallMs() const { return stallNanos / 1e6; }
+};
@@ -1,5 +1,7 @@
 #pragma once
 #include "model.hpp"
+#include "array.hpp"
+#include "thread_pool.hpp"
 #include <cstring>
 
 using namespace std;
@@ -34,20 +36,303 @@ inline int calculateMatchScore(const CustomString& jobDesc,
     return score;
 }
 
-// Efficient multiple comparisons: pre-lowercased inputs recommended by preprocessor
+inline int countKeywordBits(unsigned long long mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(mask);
+#else
+    int n = 0;
+    while (mask) { mask &= mask - 1; n++; }
+    return n;
+#endif
+}
+
+// Aho-Corasick automaton over the keyword list. One scan of a text yields a
+// bitmask with bit i set when keyword i occurs in it (same byte-exact semantics
+// as containsKeyword). The keyword score of a pair is then the popcount of the
+// AND of both masks, so each description is scanned once instead of once per
+// keyword per pair.
+class KeywordMatcher {
+public:
+    static constexpr int MAX_KEYWORDS = 64;
+
+private:
+    int* transitions;                 // dense DFA: state * 256 + byte -> next state
+    unsigned long long* outputs;      // keywords recognised on entering each state
+    int stateCount;
+    int keywordCount;
+    unsigned long long allKeywords;
+    unsigned long long emptyKeywords; // empty keywords match any non-null text
+    unsigned long long fingerprint;   // of the keyword list, equal lists give equal masks
+    int matcherId;
+
+    static int nextMatcherId() {
+        static int counter = 0;
+        return ++counter;
+    }
+
+    void build(const CustomArray<CustomString>& keywords) {
+        keywordCount = min(keywords.size(), MAX_KEYWORDS);
+        if (keywords.size() > MAX_KEYWORDS) {
+            cerr << "Warning: KeywordMatcher uses the first " << MAX_KEYWORDS << " of "
+                 << keywords.size() << " keywords" << endl;
+        }
+
+        // FNV-1a over each keyword's length and bytes
+        fingerprint = 14695981039346656037ULL;
+        auto mix = [&](unsigned char byte) {
+            fingerprint ^= byte;
+            fingerprint *= 1099511628211ULL;
+        };
+        int maxStates = 1;
+        for (int k = 0; k < keywordCount; k++) {
+            int length = keywords[k].c_str() ? keywords[k].size() : -1;
+            for (int b = 0; b < 4; b++) mix(static_cast<unsigned char>(length >> (8 * b)));
+            for (int i = 0; i < length; i++) mix(static_cast<unsigned char>(keywords[k].c_str()[i]));
+            if (keywords[k].c_str()) maxStates += keywords[k].size();
+        }
+        transitions = new int[maxStates * 256];
+        outputs = new unsigned long long[maxStates];
+        for (int i = 0; i < maxStates * 256; i++) transitions[i] = -1;
+        for (int i = 0; i < maxStates; i++) outputs[i] = 0;
+        stateCount = 1;
+
+        // Trie of all keywords
+        for (int k = 0; k < keywordCount; k++) {
+            unsigned long long bit = 1ULL << k;
+            allKeywords |= bit;
+            const char* word = keywords[k].c_str();
+            if (word == nullptr) continue;
+            if (word[0] == '\0') {
+                emptyKeywords |= bit;
+                continue;
+            }
+            int state = 0;
+            for (int i = 0; word[i] != '\0'; i++) {
+                int c = static_cast<unsigned char>(word[i]);
+                if (transitions[state * 256 + c] < 0) {
+                    transitions[state * 256 + c] = stateCount++;
+                }
+                state = transitions[state * 256 + c];
+            }
+            outputs[state] |= bit;
+        }
+
+        // Breadth-first pass turns the trie into a full DFA (failure links folded in)
+        int* failure = new int[stateCount];
+        int* queue = new int[stateCount];
+        int head = 0, tail = 0;
+        for (int c = 0; c < 256; c++) {
+            int next = transitions[c];
+            if (next < 0) {
+                transitions[c] = 0;
+            } else {
+                failure[next] = 0;
+                queue[tail++] = next;
+            }
+        }
+        while (head < tail) {
+            int state = queue[head++];
+            outputs[state] |= outputs[failure[state]];
+            for (int c = 0; c < 256; c++) {
+                int next = transitions[state * 256 + c];
+                if (next < 0) {
+                    transitions[state * 256 + c] = transitions[failure[state] * 256 + c];
+                } else {
+                    failure[next] = transitions[failure[state] * 256 + c];
+                    queue[tail++] = next;
+                }
+            }
+        }
+        delete[] failure;
+        delete[] queue;
+    }
+
+public:
+    KeywordMatcher(const CustomArray<CustomString>& keywords = buildDefaultKeywords())
+        : transitions(nullptr), outputs(nullptr), stateCount(0), keywordCount(0),
+          allKeywords(0), emptyKeywords(0), fingerprint(0), matcherId(nextMatcherId()) {
+        build(keywords);
+    }
+
+    ~KeywordMatcher() {
+        delete[] transitions;
+        delete[] outputs;
+    }
+
+    // The automaton owns raw tables; matchers are built once and passed by reference
+    KeywordMatcher(const KeywordMatcher&) = delete;
+    KeywordMatcher& operator=(const KeywordMatcher&) = delete;
+
+    int getId() const { return matcherId; }
+    int getKeywordCount() const { return keywordCount; }
+    unsigned long long getFingerprint() const { return fingerprint; }
+
+    // Bitmask of the keywords occurring in text
+    unsigned long long scan(const CustomString& text) const {
+        const char* p = text.c_str();
+        if (p == nullptr) return 0;
+        unsigned long long found = emptyKeywords;
+        int state = 0;
+        for (; *p != '\0'; p++) {
+            state = transitions[state * 256 + static_cast<unsigned char>(*p)];
+            found |= outputs[state];
+            if (found == allKeywords) break; // Nothing left to find
+        }
+        return found;
+    }
+
+    // Cached per-document masks; recomputed only if another matcher filled the cache
+    unsigned long long maskFor(Job& job) const {
+        if (job.keywordMaskOwner != matcherId) {
+            job.keywordMask = scan(job.fullDescription);
+            job.keywordMaskOwner = matcherId;
+        }
+        return job.keywordMask;
+    }
+
+    unsigned long long maskFor(Resume& resume) const {
+        if (resume.keywordMaskOwner != matcherId) {
+            resume.keywordMask = scan(resume.fullDescription);
+            resume.keywordMaskOwner = matcherId;
+        }
+        return resume.keywordMask;
+    }
+
+    // Take a mask computed for the same keyword list, e.g. saved in a snapshot
+    void adoptMask(Job& job, unsigned long long mask) const {
+        job.keywordMask = mask;
+        job.keywordMaskOwner = matcherId;
+    }
+
+    void adoptMask(Resume& resume, unsigned long long mask) const {
+        resume.keywordMask = mask;
+        resume.keywordMaskOwner = matcherId;
+    }
+
+    // Read-only variants: use the cache when valid, otherwise scan without storing
+    unsigned long long maskFor(const Job& job) const {
+        return job.keywordMaskOwner == matcherId ? job.keywordMask : scan(job.fullDescription);
+    }
+
+    unsigned long long maskFor(const Resume& resume) const {
+        return resume.keywordMaskOwner == matcherId ? resume.keywordMask : scan(resume.fullDescription);
+    }
+
+    // Pair score from two masks: number of keywords present in both texts
+    static int score(unsigned long long jobMask, unsigned long long resumeMask) {
+        return countKeywordBits(jobMask & resumeMask);
+    }
+};
+
+// Efficient multiple comparisons: one automaton scan per description, then a
+// popcount per job x resume pair
 inline void computeScoresForAllPairs(const CustomArrayV2<Job>& jobs,
                                      const CustomArrayV2<Resume>& resumes,
                                      CustomArrayV2<Job>& outJobsWithScores,
                                      const CustomArray<CustomString>& keywords = buildDefaultKeywords()) {
-    // Copy jobs then assign matchScore as the max keyword overlap against any resume
+    KeywordMatcher matcher(keywords);
+
+    unsigned long long* resumeMasks = new unsigned long long[resumes.getSize() > 0 ? resumes.getSize() : 1];
+    parallelFor(0, resumes.getSize(), 0, [&](int begin, int end) {
+        for (int r = begin; r < end; r++) resumeMasks[r] = matcher.maskFor(resumes[r]);
+    }, "match.allPairs.masks");
+
+    // matchScore of each job is its max keyword overlap against any resume
+    int* bestScores = new int[jobs.getSize() > 0 ? jobs.getSize() : 1];
+    parallelFor(0, jobs.getSize(), 0, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            unsigned long long jobMask = matcher.maskFor(jobs[i]);
+            int bestPossible = countKeywordBits(jobMask);
+            int bestScore = 0;
+            for (int r = 0; r < resumes.getSize() && bestScore < bestPossible; r++) {
+                int score = KeywordMatcher::score(jobMask, resumeMasks[r]);
+                if (score > bestScore) bestScore = score;
+            }
+            bestScores[i] = bestScore;
+        }
+    }, "match.allPairs");
+
+    // Copy jobs with their scores in input order
     for (int i = 0; i < jobs.getSize(); i++) {
         Job j = jobs[i];
-        int bestScore = 0;
-        for (int r = 0; r < resumes.getSize(); r++) {
-            int score = calculateMatchScore(j.fullDescription, resumes[r].fullDescription, keywords);
-            if (score > bestScore) bestScore = score;
-        }
-        j.matchScore = static_cast<double>(bestScore);
+        j.matchScore = static_cast<double>(bestScores[i]);
         outJobsWithScores.push_back(j);
     }
+
+    delete[] resumeMasks;
+    delete[] bestScores;
+}
+
+// Weighted skill score used by the array storage's job matching
+inline double calculateWeightedMatchScore(const Job& job, const Resume& resume) {
+    int matchCount = 0;
+    int resumeSkillsUsed = 0;
+    long long compares = 0;
+    
+    // Count matching skills
+    for (int i = 0; i < job.skills.size(); i++) {
+        for (int j = 0; j < resume.resumeSkills.size(); j++) {
+            compares++;
+            if (strcmp(job.skills[i].c_str(), resume.resumeSkills[j].c_str()) == 0) {
+                matchCount++;
+                break; // Found match, move to next job skill
+            }
+        }
+    }
+    
+    // Count how many resume skills are utilized
+    for (int j = 0; j < resume.resumeSkills.size(); j++) {
+        for (int i = 0; i < job.skills.size(); i++) {
+            compares++;
+            if (strcmp(resume.resumeSkills[j].c_str(), job.skills[i].c_str()) == 0) {
+                resumeSkillsUsed++;
+                break; // Found match, move to next resume skill
+            }
+        }
+    }
+    INSTRUMENT_COUNT(COUNTER_STRCMP, compares);
+    
+    if (job.skills.size() == 0 || resume.resumeSkills.size() == 0)
+        return 0.0;
+    
+    // Calculate base score (job skill coverage)
+    double jobCoverage = (double)matchCount / job.skills.size();
+    
+    // Calculate resume utilization bonus
+    double resumeUtilization = (double)resumeSkillsUsed / resume.resumeSkills.size();
+    
+    // Calculate total matching skills bonus (more matches = higher score)
+    double matchBonus = (double)matchCount / max(job.skills.size(), resume.resumeSkills.size());
+    
+    // Calculate skill density bonus (jobs with more skills get slight bonus)
+    double skillDensityBonus = (double)job.skills.size() / 10.0; // Normalize to 0-1 range
+    
+    // Weighted combination: 40% job coverage + 25% resume utilization + 20% match bonus + 15% skill density
+    double finalScore = (0.4 * jobCoverage) + (0.25 * resumeUtilization) + (0.2 * matchBonus) + (0.15 * skillDensityBonus);
+    
+    // Add tiny tie-breaker based on job ID to ensure different scores
+    double tieBreaker = (double)job.id / 100000.0; // Very small adjustment
+    finalScore += tieBreaker;
+    
+    return finalScore;
+}
+
+// Jaccard similarity of lower-cased skill sets, as used by the linked list storage.
+// The union uses the resume's raw skill count (before skillset filtering).
+inline double calculateJaccardMatchScore(const Job& job, const Resume& resume) {
+    int matchingSkills = 0;
+    long long compares = 0;
+    for (int j = 0; j < resume.lowerCaseSkills.size(); ++j) {
+        for (int k = 0; k < job.lowerCaseSkills.size(); ++k) {
+            compares++;
+            if (strcmp(resume.lowerCaseSkills[j].c_str(), job.lowerCaseSkills[k].c_str()) == 0) {
+                matchingSkills++;
+                break;
+            }
+        }
+    }
+    INSTRUMENT_COUNT(COUNTER_STRCMP, compares);
+    
+    int unionSize = resume.skillCount + job.skillCount - matchingSkills;
+    return (unionSize > 0) ? static_cast<double>(matchingSkills) / unionSize : 0.0;
 }
@@ -0,0 +1,414 @@
+#pragma once
+#include "model.hpp"
+#include "array.hpp"
+#include "linkedlist.hpp"
+#include "hashmap.hpp"
+#include "matching.hpp"
+#include "query.hpp"
+#include "sorting.hpp"
+#include "snapshot_section.hpp"
+#include <chrono>
+
+using namespace std;
+
+// Approximate Jaccard matching with MinHash signatures and LSH banding.
+//
+// Each job's lower-cased skill set gets bands * rows min-hashes; two sets agree
+// on one min-hash with probability equal to their Jaccard similarity s. The
+// signature is cut into bands of rows values and each band is hashed to a
+// bucket key, so a job becomes a candidate for a resume when any band key
+// matches, with probability 1 - (1 - s^rows)^bands. More bands raise recall,
+// more rows cut the candidates of low-similarity jobs. A band's keys are kept
+// sorted, so a lookup is a binary search and only the matching run is read.
+//
+// Candidates are re-scored with calculateJaccardMatchScore, the formula of
+// queryTopMatches / findAndDisplayTopMatches, so every returned score is exact;
+// only jobs never proposed can be missed. Jobs without skills score 0 and are
+// not indexed. Ties keep the lower item position (list or array order).
+//
+// Jobs appended after a build go to one hash map per band, band key -> items,
+// and are looked up there next to the sorted entries; once they outnumber a
+// quarter of the sorted entries the index is rebuilt, so an append costs
+// amortised O(bands) plus the signature.
+
+struct LshConfig {
+    int bands;
+    int rows;
+
+    LshConfig(int bandCount = 16, int rowCount = 4) : bands(bandCount), rows(rowCount) {}
+
+    int hashes() const { return bands * rows; }
+};
+
+struct LshBucketEntry {
+    unsigned long long key;
+    int item;
+};
+
+struct LshBucketEntryLess {
+    bool operator()(const LshBucketEntry& a, const LshBucketEntry& b) const {
+        return a.key < b.key || (a.key == b.key && a.item < b.item);
+    }
+};
+
+inline unsigned long long mixHash64(unsigned long long x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+class MinHashLshIndex {
+private:
+    LshConfig config;
+    CustomArray<unsigned long long> hashMultipliers;   // one odd multiplier per min-hash
+    CustomArray<unsigned long long> hashOffsets;
+    CustomArray<const Job*> items;                     // indexed jobs in list/array order
+    CustomArray<LshBucketEntry> entries;               // band-major, each band sorted by key
+    int indexedItems;                                  // jobs with skills, entries per band
+    CustomArray<CustomHashMap<unsigned long long, CustomArray<int>>> tailBuckets;   // per band, appended items by key
+    int tailItems;                                     // appended jobs with skills
+
+    void seedHashes() {
+        hashMultipliers.clear();
+        hashOffsets.clear();
+        unsigned long long state = 0x6a09e667f3bcc909ULL;
+        for (int i = 0; i < config.hashes(); i++) {
+            state += 0x9e3779b97f4a7c15ULL;
+            hashMultipliers.push_back(mixHash64(state) | 1ULL);
+            state += 0x9e3779b97f4a7c15ULL;
+            hashOffsets.push_back(mixHash64(state));
+        }
+    }
+
+    // Key of band over signature[band * rows, (band + 1) * rows)
+    unsigned long long bandKey(const unsigned int* signature, int band) const {
+        unsigned long long key = static_cast<unsigned long long>(band) + 1;
+        for (int r = 0; r < config.rows; r++) key = mixHash64(key ^ signature[band * config.rows + r]);
+        return key;
+    }
+
+    void clearTail() {
+        tailBuckets.clear();
+        tailBuckets.resize(config.bands);
+        tailItems = 0;
+    }
+
+    void buildFromItems() {
+        clearTail();
+        indexedItems = 0;
+        CustomArray<int> slots;
+        slots.resize(items.size());
+        for (int i = 0; i < items.size(); i++) {
+            slots[i] = items[i]->lowerCaseSkills.size() > 0 ? indexedItems++ : -1;
+        }
+
+        entries.resize(config.bands * indexedItems);
+        parallelFor(0, items.size(), 0, [&](int begin, int end) {
+            CustomArray<unsigned int> signature;
+            signature.resize(config.hashes());
+            for (int i = begin; i < end; i++) {
+                if (slots[i] < 0) continue;
+                computeSignature(items[i]->lowerCaseSkills, &signature[0]);
+                for (int band = 0; band < config.bands; band++) {
+                    LshBucketEntry& entry = entries[band * indexedItems + slots[i]];
+                    entry.key = bandKey(&signature[0], band);
+                    entry.item = i;
+                }
+            }
+        }, "match.lsh.signatures");
+        for (int band = 0; band < config.bands && indexedItems > 0; band++) {
+            parallelIntroSort(&entries[band * indexedItems], indexedItems, LshBucketEntryLess(), "match.lsh.buckets");
+        }
+    }
+
+public:
+    explicit MinHashLshIndex(const LshConfig& lshConfig = LshConfig()) : config(lshConfig), indexedItems(0), tailItems(0) {
+        seedHashes();
+        clearTail();
+    }
+
+    // Takes effect at the next build
+    void configure(const LshConfig& lshConfig) {
+        config = lshConfig;
+        seedHashes();
+        items.clear();
+        entries.clear();
+        indexedItems = 0;
+        clearTail();
+    }
+
+    void build(const CustomArrayV2<Job>& jobs) {
+        items.clear();
+        items.reserve(jobs.getSize());
+        for (int i = 0; i < jobs.getSize(); i++) items.push_back(&jobs[i]);
+        buildFromItems();
+    }
+
+    void build(const CustomLinkedList<Job>& jobs) {
+        items.clear();
+        items.reserve(jobs.getSize());
+        for (const ListNode<Job>* node = jobs.getHead(); node != nullptr; node = node->next) items.push_back(&node->data);
+        buildFromItems();
+    }
+
+    // Index a job placed after every item of the last build or append
+    void append(const Job& job) {
+        items.push_back(&job);
+        if (job.lowerCaseSkills.size() == 0) return;
+        int item = items.size() - 1;
+        CustomArray<unsigned int> signature;
+        signature.resize(config.hashes());
+        computeSignature(job.lowerCaseSkills, &signature[0]);
+        for (int band = 0; band < config.bands; band++) {
+            unsigned long long key = bandKey(&signature[0], band);
+            CustomArray<int>* bucket = tailBuckets[band].find(key);
+            if (bucket == nullptr) bucket = &tailBuckets[band].insert(key, CustomArray<int>());
+            bucket->push_back(item);
+        }
+        if (++tailItems > indexedItems / 4) buildFromItems();
+    }
+
+    // bands * rows min-hashes of a skill set into signature
+    void computeSignature(const CustomArray<CustomString>& skills, unsigned int* signature) const {
+        int count = config.hashes();
+        for (int h = 0; h < count; h++) signature[h] = 0xFFFFFFFFU;
+        for (int k = 0; k < skills.size(); k++) {
+            unsigned long long x = mixHash64(hashKey(skills[k]));
+            for (int h = 0; h < count; h++) {
+                unsigned int value = static_cast<unsigned int>((hashMultipliers[h] * x + hashOffsets[h]) >> 32);
+                if (value < signature[h]) signature[h] = value;
+            }
+        }
+    }
+
+    // Item positions sharing at least one band with the resume, ascending
+    void candidates(const Resume& resume, CustomArray<int>& out) const {
+        out.clear();
+        if (indexedItems + tailItems == 0 || resume.lowerCaseSkills.size() == 0) return;
+        CustomArray<unsigned int> signature;
+        signature.resize(config.hashes());
+        computeSignature(resume.lowerCaseSkills, &signature[0]);
+
+        for (int band = 0; band < config.bands; band++) {
+            unsigned long long key = bandKey(&signature[0], band);
+            const LshBucketEntry* bucket = &entries[band * indexedItems];
+            int low = 0, high = indexedItems;
+            while (low < high) {
+                int mid = low + (high - low) / 2;
+                if (bucket[mid].key < key) low = mid + 1;
+                else high = mid;
+            }
+            for (int i = low; i < indexedItems && bucket[i].key == key; i++) out.push_back(bucket[i].item);
+            const CustomArray<int>* tail = tailBuckets[band].find(key);
+            for (int i = 0; tail != nullptr && i < tail->size(); i++) out.push_back((*tail)[i]);
+        }
+        if (out.size() < 2) return;
+        parallelIntroSort(&out[0], out.size(), [](int a, int b) { return a < b; }, "match.lsh.candidates");
+        int unique = 1;
+        for (int i = 1; i < out.size(); i++) {
+            if (out[i] != out[unique - 1]) out[unique++] = out[i];
+        }
+        out.resize(unique);
+    }
+
+    // Top k candidates by exact Jaccard score, positive scores only. indices
+    // are item positions (array positions for an array build). Returns the
+    // number of candidates scored.
+    int search(const Resume& resume, int k, QueryResult& out) const {
+        out.clear();
+        CustomArray<int> candidateItems;
+        candidates(resume, candidateItems);
+        out.scratch.resize(candidateItems.size());
+        parallelFor(0, candidateItems.size(), 0, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                out.scratch[i] = calculateJaccardMatchScore(*items[candidateItems[i]], resume);
+            }
+        }, "match.lsh.rescore");
+        selectTopScores(out.scratch, k, true, out.indices);
+        copyTopScores(out.scratch, out.indices, out.scores);
+        for (int i = 0; i < out.indices.size(); i++) out.indices[i] = candidateItems[out.indices[i]];
+        return candidateItems.size();
+    }
+
+    int search(const Resume& resume, int k, HandleQueryResult<Job>& out) const {
+        QueryResult ranked;
+        int scored = search(resume, k, ranked);
+        out.clear();
+        for (int i = 0; i < ranked.size(); i++) {
+            out.items.push_back(items[ranked.indices[i]]);
+            out.scores.push_back(ranked.scores[i]);
+        }
+        return scored;
+    }
+
+    // Exact ranking over every item, the reference for search
+    void searchExhaustive(const Resume& resume, int k, QueryResult& out) const {
+        out.clear();
+        out.scratch.resize(items.size());
+        JaccardScorer scorer;
+        scorer.prepare(resume);
+        parallelFor(0, items.size(), 0, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) out.scratch[i] = scorer.score(*items[i]);
+        }, JaccardScorer::label());
+        selectTopScores(out.scratch, k, true, out.indices);
+        copyTopScores(out.scratch, out.indices, out.scores);
+    }
+
+    // Snapshot section: the band entries as they are sorted and the appended
+    // items per band and key. Items go by position; the storage hands the
+    // jobs back on restore.
+    void save(SnapshotSectionWriter& out) const {
+        CustomArray<int> tailBands;
+        CustomArray<unsigned long long> tailKeys;
+        CustomArray<int> tailPositions;
+        for (int band = 0; band < config.bands; band++) {
+            tailBuckets[band].forEach([&](unsigned long long key, const CustomArray<int>& bucket) {
+                for (int i = 0; i < bucket.size(); i++) {
+                    tailBands.push_back(band);
+                    tailKeys.push_back(key);
+                    tailPositions.push_back(bucket[i]);
+                }
+            });
+        }
+        out.putValue(config.bands);
+        out.putValue(config.rows);
+        out.putValue(indexedItems);
+        out.putValue(tailItems);
+        out.putValue(items.size());
+        out.putArray(entries);
+        out.putArray(tailBands);
+        out.putArray(tailKeys);
+        out.putArray(tailPositions);
+    }
+
+    // Load a saved section over jobs, the items in position order. The
+    // section must be for the current config, and every entry must name a
+    // job with skills; band entries must be sorted for the binary search.
+    // On false the index is left empty.
+    bool restore(SnapshotSectionReader& in, const CustomArray<const Job*>& jobs) {
+        items.clear();
+        entries.clear();
+        indexedItems = 0;
+        clearTail();
+        LshConfig saved;
+        int savedItems = 0;
+        int savedTail = 0;
+        CustomArray<int> tailBands;
+        CustomArray<unsigned long long> tailKeys;
+        CustomArray<int> tailPositions;
+        bool ok = in.getValue(saved.bands) && in.getValue(saved.rows) && in.getValue(indexedItems)
+               && in.getValue(savedTail) && in.getValue(savedItems) && in.getArray(entries) && in.getArray(tailBands)
+               && in.getArray(tailKeys) && in.getArray(tailPositions)
+               && saved.bands == config.bands && saved.rows == config.rows && savedItems == jobs.size()
+               && indexedItems >= 0 && savedTail >= 0
+               && entries.size() == static_cast<long long>(config.bands) * indexedItems
+               && tailKeys.size() == tailBands.size() && tailPositions.size() == tailBands.size()
+               && tailPositions.size() == static_cast<long long>(config.bands) * savedTail;
+        int withSkills = 0;
+        for (int i = 0; ok && i < jobs.size(); i++) {
+            if (jobs[i]->lowerCaseSkills.size() > 0) withSkills++;
+        }
+        ok = ok && indexedItems + savedTail == withSkills;
+        auto validItem = [&](int item) {
+            return item >= 0 && item < jobs.size() && jobs[item]->lowerCaseSkills.size() > 0;
+        };
+        for (int i = 0; ok && i < entries.size(); i++) {
+            ok = validItem(entries[i].item)
+              && (i % indexedItems == 0 || !LshBucketEntryLess()(entries[i], entries[i - 1]));
+        }
+        for (int i = 0; ok && i < tailPositions.size(); i++) {
+            ok = tailBands[i] >= 0 && tailBands[i] < config.bands && validItem(tailPositions[i]);
+            if (!ok) break;
+            CustomArray<int>* bucket = tailBuckets[tailBands[i]].find(tailKeys[i]);
+            if (bucket == nullptr) bucket = &tailBuckets[tailBands[i]].insert(tailKeys[i], CustomArray<int>());
+            bucket->push_back(tailPositions[i]);
+        }
+        if (!ok) {
+            entries.clear();
+            indexedItems = 0;
+            clearTail();
+            return in.fail();
+        }
+        items = jobs;
+        tailItems = savedTail;
+        return true;
+    }
+
+    const Job& getItem(int position) const { return *items[position]; }
+    int getItemCount() const { return items.size(); }
+    int getIndexedCount() const { return indexedItems + tailItems; }
+    const LshConfig& getConfig() const { return config; }
+};
+
+// ---------------------------------------------------------------------------
+// recall@K against the exact Jaccard ranking
+// ---------------------------------------------------------------------------
+
+struct LshRecallReport {
+    int queries;               // sampled resumes with at least one positive exact match
+    int k;
+    double recall;             // mean recall@k
+    double averageCandidates;  // jobs re-scored per query
+    double exactMs;            // mean exact query time
+    double approximateMs;      // mean LSH query time
+};
+
+// A result counts as a hit when its score reaches the k-th exact score, so a
+// different job with a tied score is not a miss.
+inline LshRecallReport measureLshRecall(const MinHashLshIndex& index, const CustomArray<const Resume*>& resumes, int k) {
+    LshRecallReport report = {0, k, 0.0, 0.0, 0.0, 0.0};
+    QueryResult exact;
+    QueryResult approximate;
+    double recallSum = 0.0;
+    long long candidateSum = 0;
+    for (int q = 0; q < resumes.size(); q++) {
+        auto start = chrono::steady_clock::now();
+        index.searchExhaustive(*resumes[q], k, exact);
+        auto middle = chrono::steady_clock::now();
+        candidateSum += index.search(*resumes[q], k, approximate);
+        auto end = chrono::steady_clock::now();
+        report.exactMs += chrono::duration<double, milli>(middle - start).count();
+        report.approximateMs += chrono::duration<double, milli>(end - middle).count();
+        if (exact.empty()) continue;
+
+        double threshold = exact.scores[exact.size() - 1];
+        int hits = 0;
+        for (int i = 0; i < approximate.size(); i++) {
+            if (approximate.scores[i] >= threshold) hits++;
+        }
+        recallSum += static_cast<double>(min(hits, exact.size())) / exact.size();
+        report.queries++;
+    }
+    if (resumes.size() > 0) {
+        report.averageCandidates = static_cast<double>(candidateSum) / resumes.size();
+        report.exactMs /= resumes.size();
+        report.approximateMs /= resumes.size();
+    }
+    report.recall = report.queries > 0 ? recallSum / report.queries : 1.0;
+    return report;
+}
+
+// Up to sampleCount resumes spread evenly over the list
+inline CustomArray<const Resume*> sampleResumes(const CustomLinkedList<Resume>& resumes, int sampleCount) {
+    CustomArray<const Resume*> sample;
+    int total = resumes.getSize();
+    if (total == 0 || sampleCount <= 0) return sample;
+    int step = max(1, total / sampleCount);
+    int i = 0;
+    for (const ListNode<Resume>* node = resumes.getHead(); node != nullptr && sample.size() < sampleCount; node = node->next, i++) {
+        if (i % step == 0) sample.push_back(&node->data);
+    }
+    return sample;
+}
+
+inline CustomArray<const Resume*> sampleResumes(const CustomArrayV2<Resume>& resumes, int sampleCount) {
+    CustomArray<const Resume*> sample;
+    int total = resumes.getSize();
+    if (total == 0 || sampleCount <= 0) return sample;
+    int step = max(1, total / sampleCount);
+    for (int i = 0; i < total && sample.size() < sampleCount; i += step) sample.push_back(&resumes[i]);
+    return sample;
+}
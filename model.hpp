@@ -2,6 +2,8 @@
 #include <iostream>
 #include <cstring>
 #include <cstdlib>
+#include <utility>
+#include "instrumentation.hpp"
 
 
 using namespace std;
@@ -19,6 +21,7 @@ public:
         if (str) {
             length = strlen(str);
             data = new char[length + 1];
+            INSTRUMENT_COUNT(COUNTER_ALLOCATIONS, 1);
             strcpy(data, str);
         } else {
             data = nullptr;
@@ -26,10 +29,25 @@ public:
         }
     }
     
+    // Construct from a buffer that is not necessarily null-terminated
+    CustomString(const char* str, int len) {
+        if (str) {
+            length = len;
+            data = new char[length + 1];
+            INSTRUMENT_COUNT(COUNTER_ALLOCATIONS, 1);
+            memcpy(data, str, length);
+            data[length] = '\0';
+        } else {
+            data = nullptr;
+            length = 0;
+        }
+    }
+
     CustomString(const CustomString& other) {
         if (other.data) {
             length = other.length;
             data = new char[length + 1];
+            INSTRUMENT_COUNT(COUNTER_ALLOCATIONS, 1);
             strcpy(data, other.data);
         } else {
             data = nullptr;
@@ -37,6 +55,12 @@ public:
         }
     }
     
+    // Move: take over the buffer, leave other empty
+    CustomString(CustomString&& other) : data(other.data), length(other.length) {
+        other.data = nullptr;
+        other.length = 0;
+    }
+    
     ~CustomString() {
         delete[] data;
     }
@@ -47,6 +71,7 @@ public:
             if (other.data) {
                 length = other.length;
                 data = new char[length + 1];
+                INSTRUMENT_COUNT(COUNTER_ALLOCATIONS, 1);
                 strcpy(data, other.data);
             } else {
                 data = nullptr;
@@ -56,6 +81,17 @@ public:
         return *this;
     }
     
+    CustomString& operator=(CustomString&& other) {
+        if (this != &other) {
+            delete[] data;
+            data = other.data;
+            length = other.length;
+            other.data = nullptr;
+            other.length = 0;
+        }
+        return *this;
+    }
+    
     const char* c_str() const { return data; }
     int size() const { return length; }
     
@@ -98,6 +134,26 @@ public:
         return *this;
     }
     
+    // Move constructor / assignment: take over the buffer
+    CustomArray(CustomArray&& other) : data(other.data), capacity(other.capacity), currentSize(other.currentSize) {
+        other.data = nullptr;
+        other.capacity = 0;
+        other.currentSize = 0;
+    }
+    
+    CustomArray& operator=(CustomArray&& other) {
+        if (this != &other) {
+            delete[] data;
+            data = other.data;
+            capacity = other.capacity;
+            currentSize = other.currentSize;
+            other.data = nullptr;
+            other.capacity = 0;
+            other.currentSize = 0;
+        }
+        return *this;
+    }
+    
     ~CustomArray() {
         delete[] data;
     }
@@ -106,8 +162,9 @@ public:
         if (currentSize >= capacity) {
             int newCapacity = (capacity == 0) ? 1 : capacity * 2;
             T* newData = new T[newCapacity];
+            INSTRUMENT_COUNT(COUNTER_ALLOCATIONS, 1);
             for (int i = 0; i < currentSize; i++) {
-                newData[i] = data[i];
+                newData[i] = move(data[i]);
             }
             delete[] data;
             data = newData;
@@ -117,6 +174,19 @@ public:
         currentSize++;
     }
     
+    // Grow capacity up front to avoid repeated doubling
+    void reserve(int newCapacity) {
+        if (newCapacity <= capacity) return;
+        T* newData = new T[newCapacity];
+        INSTRUMENT_COUNT(COUNTER_ALLOCATIONS, 1);
+        for (int i = 0; i < currentSize; i++) {
+            newData[i] = move(data[i]);
+        }
+        delete[] data;
+        data = newData;
+        capacity = newCapacity;
+    }
+    
     T& operator[](int index) {
         return data[index];
     }
@@ -127,8 +197,47 @@ public:
     
     int size() const { return currentSize; }
     bool empty() const { return currentSize == 0; }
+    
+    // Drop all elements but keep the buffer, so scratch arrays can be reused
+    void clear() { currentSize = 0; }
+    
+    // Set the element count; new elements are default-valued
+    void resize(int newSize) {
+        reserve(newSize);
+        for (int i = currentSize; i < newSize; i++) data[i] = T();
+        currentSize = newSize;
+    }
 };
 
+// Job categories assigned by categorizeJob. Codes follow the alphabetical
+// order of the names, so ordering by code orders by category name.
+enum JobCategory {
+    JOB_CATEGORY_ANALYST,
+    JOB_CATEGORY_DESIGNER,
+    JOB_CATEGORY_DEVELOPER,
+    JOB_CATEGORY_ENGINEER,
+    JOB_CATEGORY_MANAGER,
+    JOB_CATEGORY_OTHER,
+    JOB_CATEGORY_SCIENTIST,
+    JOB_CATEGORY_UNKNOWN,
+    JOB_CATEGORY_COUNT
+};
+
+inline const char* jobCategoryName(int category) {
+    static const char* const names[JOB_CATEGORY_COUNT] = {
+        "analyst", "designer", "developer", "engineer", "manager", "other", "scientist", "unknown"};
+    return category >= 0 && category < JOB_CATEGORY_COUNT ? names[category] : "unknown";
+}
+
+// Code of a category name, -1 if name is not one
+inline int jobCategoryCode(const char* name) {
+    if (name == nullptr) return -1;
+    for (int i = 0; i < JOB_CATEGORY_COUNT; i++) {
+        if (strcmp(jobCategoryName(i), name) == 0) return i;
+    }
+    return -1;
+}
+
 struct Job {
     // Basic attributes
     int id;
@@ -147,15 +256,21 @@ struct Job {
     
     // Attributes for job matching
     CustomString jobCategory;
+    JobCategory categoryCode;   // jobCategory as a code, for bucketing
     int experienceLevel;
     double matchScore;
     
+    // Cached keyword-presence bitmask of fullDescription (see KeywordMatcher)
+    unsigned long long keywordMask;
+    int keywordMaskOwner;   // id of the matcher that computed keywordMask, 0 = not computed
+    
     // Constructors
-    Job() : id(0), skillCount(0), titleLength(0), priority(0), 
-            experienceLevel(0), matchScore(0.0) {}
+    Job() : id(0), skillCount(0), titleLength(0), priority(0), categoryCode(JOB_CATEGORY_UNKNOWN),
+            experienceLevel(0), matchScore(0.0), keywordMask(0), keywordMaskOwner(0) {}
     
     Job(int id, const CustomString& title) : id(id), jobTitle(title), skillCount(0), 
-            titleLength(0), priority(0), experienceLevel(0), matchScore(0.0) {}
+            titleLength(0), priority(0), categoryCode(JOB_CATEGORY_UNKNOWN), experienceLevel(0), matchScore(0.0),
+            keywordMask(0), keywordMaskOwner(0) {}
     
     // Display function for debugging
     void display() const {
@@ -188,11 +303,15 @@ struct Resume {
     // For matching with jobs
     double matchScore;
     
+    // Cached keyword-presence bitmask of fullDescription (see KeywordMatcher)
+    unsigned long long keywordMask;
+    int keywordMaskOwner;
+    
     // Constructors
-    Resume() : id(0), skillCount(0), matchScore(0.0) {}
+    Resume() : id(0), skillCount(0), matchScore(0.0), keywordMask(0), keywordMaskOwner(0) {}
     
     Resume(int id, const CustomString& desc) : id(id), fullDescription(desc), 
-            skillCount(0), matchScore(0.0) {}
+            skillCount(0), matchScore(0.0), keywordMask(0), keywordMaskOwner(0) {}
     
     // Display function for debugging
     void display() const {
@@ -0,0 +1,176 @@
+#pragma once
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// Hardware performance counters through Linux perf_event_open.
+//
+// Each event is opened on its own (not as a group), so a machine or VM that
+// lacks one event still reports the others. Counters count the calling thread
+// in user space only, which works at perf_event_paranoid <= 2; work handed to
+// pool workers is not included, so run with one worker (threads 1) to
+// attribute a whole step. Counts are scaled by time_enabled / time_running
+// when the kernel multiplexes events.
+//
+// Off Linux, or when no event can be opened, open() returns false and every
+// sample is empty; callers print wall times only.
+
+enum PerfEventKind {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_DTLB_MISSES,
+    PERF_EVENT_KINDS
+};
+
+inline const char* perfEventName(int kind) {
+    static const char* const names[PERF_EVENT_KINDS] = {
+        "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "dtlb_misses"};
+    return names[kind];
+}
+
+struct PerfSample {
+    long long values[PERF_EVENT_KINDS];
+    bool valid[PERF_EVENT_KINDS];
+
+    PerfSample() {
+        for (int i = 0; i < PERF_EVENT_KINDS; i++) {
+            values[i] = 0;
+            valid[i] = false;
+        }
+    }
+
+    PerfSample operator-(const PerfSample& earlier) const {
+        PerfSample delta;
+        for (int i = 0; i < PERF_EVENT_KINDS; i++) {
+            delta.valid[i] = valid[i] && earlier.valid[i];
+            delta.values[i] = delta.valid[i] ? values[i] - earlier.values[i] : 0;
+        }
+        return delta;
+    }
+
+    bool empty() const {
+        for (int i = 0; i < PERF_EVENT_KINDS; i++) {
+            if (valid[i]) return false;
+        }
+        return true;
+    }
+};
+
+class PerfCounters {
+private:
+    int fds[PERF_EVENT_KINDS];
+    int openErrno;                 // errno of the first failed open, for the message
+
+#if defined(__linux__)
+    static int openEvent(unsigned int type, unsigned long long config) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    static unsigned long long cacheMiss(unsigned long long cache) {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+#endif
+
+public:
+    PerfCounters() : openErrno(0) {
+        for (int i = 0; i < PERF_EVENT_KINDS; i++) fds[i] = -1;
+    }
+
+    ~PerfCounters() { close(); }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // Open and start every event this machine allows; false when none opened
+    bool open() {
+        close();
+#if defined(__linux__)
+        const unsigned int types[PERF_EVENT_KINDS] = {
+            PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+            PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE};
+        const unsigned long long configs[PERF_EVENT_KINDS] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, cacheMiss(PERF_COUNT_HW_CACHE_L1D),
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES, cacheMiss(PERF_COUNT_HW_CACHE_DTLB)};
+        for (int i = 0; i < PERF_EVENT_KINDS; i++) {
+            fds[i] = openEvent(types[i], configs[i]);
+            if (fds[i] < 0 && openErrno == 0) openErrno = errno;
+        }
+#else
+        openErrno = ENOSYS;
+#endif
+        return isAvailable();
+    }
+
+    void close() {
+#if defined(__linux__)
+        for (int i = 0; i < PERF_EVENT_KINDS; i++) {
+            if (fds[i] >= 0) ::close(fds[i]);
+            fds[i] = -1;
+        }
+#endif
+        openErrno = 0;
+    }
+
+    bool isAvailable() const {
+        for (int i = 0; i < PERF_EVENT_KINDS; i++) {
+            if (fds[i] >= 0) return true;
+        }
+        return false;
+    }
+
+    // Why events are missing, for the warning printed instead of counts
+    const char* unavailableReason() const {
+        if (openErrno == EACCES || openErrno == EPERM) return "permission denied (see /proc/sys/kernel/perf_event_paranoid)";
+        if (openErrno == ENOENT || openErrno == EOPNOTSUPP) return "event not supported by this CPU or VM";
+        if (openErrno == ENOSYS) return "perf_event_open not available on this system";
+        return openErrno != 0 ? strerror(openErrno) : "not opened";
+    }
+
+    // Running totals since open, scaled for multiplexing
+    PerfSample read() const {
+        PerfSample sample;
+#if defined(__linux__)
+        for (int i = 0; i < PERF_EVENT_KINDS; i++) {
+            if (fds[i] < 0) continue;
+            unsigned long long data[3];   // value, time_enabled, time_running
+            if (::read(fds[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) continue;
+            double value = static_cast<double>(data[0]);
+            if (data[2] < data[1]) value *= static_cast<double>(data[1]) / data[2];
+            sample.values[i] = static_cast<long long>(value);
+            sample.valid[i] = true;
+        }
+#endif
+        return sample;
+    }
+};
+
+// ", cycles N/run, instructions N/run, ipc X, ..." for the events in delta
+inline void printPerfSample(ostream& out, const PerfSample& delta, int runs) {
+    if (runs <= 0) runs = 1;
+    for (int i = 0; i < PERF_EVENT_KINDS; i++) {
+        if (delta.valid[i]) out << ", " << perfEventName(i) << " " << delta.values[i] / runs << "/run";
+    }
+    if (delta.valid[PERF_CYCLES] && delta.valid[PERF_INSTRUCTIONS] && delta.values[PERF_CYCLES] > 0) {
+        out << ", ipc " << static_cast<double>(delta.values[PERF_INSTRUCTIONS]) / delta.values[PERF_CYCLES];
+    }
+}
@@ -1,9 +1,17 @@
 #pragma once
 #include "model.hpp"
+#include "hashmap.hpp"
+#include "simd_text.hpp"
+#include "thread_pool.hpp"
 #include <cctype>
 
 using namespace std;
 
+// Same set as isspace() in the "C" locale, without the function call
+inline bool asciiSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
 // Convert string to lowercase
 CustomString convertToLowerCase(const CustomString& str) {
     if (str.c_str() == nullptr) {
@@ -13,12 +21,10 @@ CustomString convertToLowerCase(const CustomString& str) {
     int len = str.size();
     char* result = new char[len + 1];
     
-    for (int i = 0; i < len; i++) {
-        result[i] = tolower(str.c_str()[i]);
-    }
+    asciiLowerCopy(result, str.c_str(), len);
     result[len] = '\0';
     
-    CustomString lowerStr(result);
+    CustomString lowerStr(result, len);
     delete[] result;
     return lowerStr;
 }
@@ -29,22 +35,7 @@ int countWords(const CustomString& str) {
         return 0;
     }
     
-    int count = 0;
-    bool inWord = false;
-    const char* text = str.c_str();
-    
-    for (int i = 0; text[i] != '\0'; i++) {
-        if (isalpha(text[i])) {
-            if (!inWord) {
-                count++;
-                inWord = true;
-            }
-        } else {
-            inWord = false;
-        }
-    }
-    
-    return count;
+    return countAsciiWords(str.c_str(), str.size());
 }
 
 // Trim whitespace from string
@@ -55,32 +46,17 @@ CustomString trim(const CustomString& str) {
     
     const char* text = str.c_str();
     int start = 0;
-    int end = str.size() - 1;
+    int end = str.size();
     
-    // Find start of non-whitespace
-    while (start <= end && isspace(text[start])) {
+    // Find start and end of non-whitespace
+    while (start < end && asciiSpace(text[start])) {
         start++;
     }
-    
-    // Find end of non-whitespace
-    while (end >= start && isspace(text[end])) {
+    while (end > start && asciiSpace(text[end - 1])) {
         end--;
     }
     
-    if (start > end) {
-        return CustomString("");
-    }
-    
-    int len = end - start + 1;
-    char* result = new char[len + 1];
-    for (int i = 0; i < len; i++) {
-        result[i] = text[start + i];
-    }
-    result[len] = '\0';
-    
-    CustomString trimmed(result);
-    delete[] result;
-    return trimmed;
+    return CustomString(text + start, end - start);
 }
 
 // Extract job title from description
@@ -122,58 +98,8 @@ CustomString extractJobTitle(const CustomString& line) {
     return jobTitle;
 }
 
-// Extract skills from description
-CustomArray<CustomString> extractSkills(const CustomString& line) {
-    CustomArray<CustomString> skills;
-    
-    if (line.c_str() == nullptr) {
-        return skills;
-    }
-    
-    const char* text = line.c_str();
-    const char* startPattern = "needed with experience in";
-    const char* endPattern = ".";
-    
-    // Find start of skills section
-    const char* start = strstr(text, startPattern);
-    if (start == nullptr) {
-        return skills;
-    }
-    
-    // Move to after "needed with experience in"
-    start += strlen(startPattern);
-    
-    // Find end of skills section
-    const char* end = strstr(start, endPattern);
-    if (end == nullptr) {
-        return skills;
-    }
-    
-    // Extract skills text
-    int skillsLen = end - start;
-    if (skillsLen <= 0) {
-        return skills;
-    }
-    
-    char* skillsText = new char[skillsLen + 1];
-    for (int i = 0; i < skillsLen; i++) {
-        skillsText[i] = start[i];
-    }
-    skillsText[skillsLen] = '\0';
-    
-    // Split by commas
-    char* token = strtok(skillsText, ",");
-    while (token != nullptr) {
-        CustomString skill = trim(CustomString(token));
-        if (skill.size() > 0) {
-            skills.push_back(skill);
-        }
-        token = strtok(nullptr, ",");
-    }
-    
-    delete[] skillsText;
-    return skills;
-}
+CustomString categorizeLowerCaseTitle(const char* text);
+JobCategory categorizeLowerCaseTitleCode(const char* text);
 
 // Categorize job based on title
 CustomString categorizeJob(const CustomString& title) {
@@ -182,22 +108,34 @@ CustomString categorizeJob(const CustomString& title) {
     }
     
     CustomString lowerTitle = convertToLowerCase(title);
-    const char* text = lowerTitle.c_str();
+    return categorizeLowerCaseTitle(lowerTitle.c_str());
+}
+
+// Categorize an already lower-cased title (skips the extra lowercase copy)
+CustomString categorizeLowerCaseTitle(const char* text) {
+    return CustomString(jobCategoryName(categorizeLowerCaseTitleCode(text)));
+}
+
+// Category code of an already lower-cased title
+JobCategory categorizeLowerCaseTitleCode(const char* text) {
+    if (text == nullptr) {
+        return JOB_CATEGORY_UNKNOWN;
+    }
     
     if (strstr(text, "analyst")) {
-        return CustomString("analyst");
+        return JOB_CATEGORY_ANALYST;
     } else if (strstr(text, "engineer")) {
-        return CustomString("engineer");
+        return JOB_CATEGORY_ENGINEER;
     } else if (strstr(text, "manager")) {
-        return CustomString("manager");
+        return JOB_CATEGORY_MANAGER;
     } else if (strstr(text, "developer")) {
-        return CustomString("developer");
+        return JOB_CATEGORY_DEVELOPER;
     } else if (strstr(text, "scientist")) {
-        return CustomString("scientist");
+        return JOB_CATEGORY_SCIENTIST;
     } else if (strstr(text, "designer")) {
-        return CustomString("designer");
+        return JOB_CATEGORY_DESIGNER;
     } else {
-        return CustomString("other");
+        return JOB_CATEGORY_OTHER;
     }
 }
 
@@ -212,94 +150,215 @@ int calculatePriority(const Job& job) {
     }
     
     // Higher priority for certain categories
-    if (strcmp(job.jobCategory.c_str(), "engineer") == 0 ||
-        strcmp(job.jobCategory.c_str(), "scientist") == 0) {
+    if (job.categoryCode == JOB_CATEGORY_ENGINEER || job.categoryCode == JOB_CATEGORY_SCIENTIST) {
         priority += 1;
     }
     
     return priority;
 }
 
-// Extract skills from resume description
-CustomArray<CustomString> extractResumeSkills(const CustomString& line) {
-    CustomArray<CustomString> skills;
-    
-    if (line.c_str() == nullptr) {
-        return skills;
-    }
-    
-    const char* text = line.c_str();
-    const char* startPattern = "experienced professional skilled in";
-    const char* endPattern = ".";
-    
-    // Find start of skills section
-    const char* start = strstr(text, startPattern);
-    if (start == nullptr) {
-        return skills;
-    }
-    
-    // Move to after "experienced professional skilled in"
-    start += strlen(startPattern);
-    
-    // Find end of skills section
-    const char* end = strstr(start, endPattern);
-    if (end == nullptr) {
-        return skills;
+// Reusable per-thread buffers for the single-pass record scanner, so
+// preprocessing a record does not allocate any temporaries
+struct PreprocessScratch {
+    char* lower;          // lower-cased prefix of the record (up to the end of the skills)
+    int lowerCapacity;
+    int* spanStart;       // skill token boundaries inside lower
+    int* spanLength;
+    int spanCapacity;
+    
+    PreprocessScratch() : lower(nullptr), lowerCapacity(0), spanStart(nullptr), spanLength(nullptr), spanCapacity(0) {}
+    
+    ~PreprocessScratch() {
+        delete[] lower;
+        delete[] spanStart;
+        delete[] spanLength;
+    }
+    
+    void reserveText(int len) {
+        if (len <= lowerCapacity) return;
+        delete[] lower;
+        lowerCapacity = len * 2;
+        lower = new char[lowerCapacity];
+    }
+    
+    void addSpan(int index, int start, int length) {
+        if (index >= spanCapacity) {
+            int newCapacity = (spanCapacity == 0) ? 16 : spanCapacity * 2;
+            int* newStart = new int[newCapacity];
+            int* newLength = new int[newCapacity];
+            for (int i = 0; i < index; i++) {
+                newStart[i] = spanStart[i];
+                newLength[i] = spanLength[i];
+            }
+            delete[] spanStart;
+            delete[] spanLength;
+            spanStart = newStart;
+            spanLength = newLength;
+            spanCapacity = newCapacity;
+        }
+        spanStart[index] = start;
+        spanLength[index] = length;
     }
-    
-    // Extract skills text
-    int skillsLen = end - start;
-    if (skillsLen <= 0) {
-        return skills;
+};
+
+inline PreprocessScratch& preprocessScratch() {
+    thread_local PreprocessScratch scratch;
+    return scratch;
+}
+
+// Result of scanning one record: marker position and trimmed skill spans in scratch.lower
+struct RecordScan {
+    int markerPos;        // -1 when the marker is missing
+    int skillCount;       // 0 when the skill list is not terminated by '.'
+};
+
+// Single pass over a raw record: lower-cases into the scratch buffer block by
+// block while looking for the marker, then jumps between ','/'.' delimiters to
+// split and trim the skill list. Nothing past the terminating '.' is touched.
+RecordScan scanRecord(const CustomString& rawLine, const char* marker, PreprocessScratch& scratch) {
+    RecordScan scan;
+    scan.markerPos = -1;
+    scan.skillCount = 0;
+    
+    const char* text = rawLine.c_str();
+    if (text == nullptr) {
+        return scan;
+    }
+    
+    int len = rawLine.size();
+    int markerLen = strlen(marker);
+    scratch.reserveText(len + 1);
+    char* lower = scratch.lower;
+    
+    // Phase 1: lowercase 64-byte blocks and search the lowered prefix for the marker
+    const int blockSize = 64;
+    int lowered = 0;
+    int searchFrom = 0;
+    while (scan.markerPos < 0 && lowered < len) {
+        int blockEnd = min(len, lowered + blockSize);
+        asciiLowerCopy(lower + lowered, text + lowered, blockEnd - lowered);
+        lowered = blockEnd;
+        
+        int lastStart = lowered - markerLen;
+        while (searchFrom <= lastStart) {
+            int hit = findFirstOf(lower + searchFrom, lastStart - searchFrom + 1, marker[0], marker[0], marker[0]);
+            if (hit < 0) {
+                searchFrom = lastStart + 1;
+                break;
+            }
+            searchFrom += hit;
+            if (memcmp(lower + searchFrom, marker, markerLen) == 0) {
+                scan.markerPos = searchFrom;
+                break;
+            }
+            searchFrom++;
+        }
     }
-    
-    char* skillsText = new char[skillsLen + 1];
-    for (int i = 0; i < skillsLen; i++) {
-        skillsText[i] = start[i];
+    if (scan.markerPos < 0) {
+        return scan;
     }
-    skillsText[skillsLen] = '\0';
     
-    // Split by commas
-    char* token = strtok(skillsText, ",");
-    while (token != nullptr) {
-        CustomString skill = trim(CustomString(token));
-        if (skill.size() > 0) {
-            skills.push_back(skill);
+    // Phase 2: split the skill list on ',' until the first '.' (both are case-free,
+    // so the raw text is searched and only token bytes are lowered)
+    int pos = scan.markerPos + markerLen;
+    int count = 0;
+    while (pos <= len) {
+        int delim = findFirstOf(text + pos, len - pos, ',', '.', ',');
+        if (delim < 0) {
+            return scan; // Skill list is not terminated
+        }
+        int end = pos + delim;
+        if (end > lowered) {
+            asciiLowerCopy(lower + lowered, text + lowered, end - lowered);
+            lowered = end;
+        }
+        
+        int start = pos;
+        int tokenEnd = end;
+        while (start < tokenEnd && asciiSpace(lower[start])) start++;
+        while (tokenEnd > start && asciiSpace(lower[tokenEnd - 1])) tokenEnd--;
+        if (tokenEnd > start) {
+            scratch.addSpan(count++, start, tokenEnd - start);
         }
-        token = strtok(nullptr, ",");
+        
+        if (text[end] == '.') {
+            scan.skillCount = count;
+            return scan;
+        }
+        pos = end + 1;
     }
-    
-    delete[] skillsText;
+    return scan;
+}
+
+// Build the skill arrays straight from the scanned spans (skills are already lower-case)
+void buildSkillArrays(const RecordScan& scan, const PreprocessScratch& scratch,
+                      CustomArray<CustomString>& skills) {
+    skills.reserve(scan.skillCount);
+    for (int i = 0; i < scan.skillCount; i++) {
+        skills.push_back(CustomString(scratch.lower + scratch.spanStart[i], scratch.spanLength[i]));
+    }
+}
+
+// Extract skills from description (expects lower-cased input, as before)
+CustomArray<CustomString> extractSkills(const CustomString& line) {
+    CustomArray<CustomString> skills;
+    PreprocessScratch& scratch = preprocessScratch();
+    RecordScan scan = scanRecord(line, "needed with experience in", scratch);
+    buildSkillArrays(scan, scratch, skills);
+    return skills;
+}
+
+// Extract skills from resume description
+CustomArray<CustomString> extractResumeSkills(const CustomString& line) {
+    CustomArray<CustomString> skills;
+    PreprocessScratch& scratch = preprocessScratch();
+    RecordScan scan = scanRecord(line, "experienced professional skilled in", scratch);
+    buildSkillArrays(scan, scratch, skills);
     return skills;
 }
 
+void copySkillArray(const CustomArray<CustomString>& source, CustomArray<CustomString>& target) {
+    target.reserve(source.size());
+    for (int i = 0; i < source.size(); i++) {
+        target.push_back(source[i]);
+    }
+}
+
 // Main preprocessing function for jobs
 Job preprocessJobDescription(const CustomString& rawLine, int id) {
     Job job;
     job.id = id;
     job.fullDescription = rawLine;
     
-    // Step 1: Convert to lowercase for processing
-    CustomString lowerLine = convertToLowerCase(rawLine);
-    
-    // Step 2: Extract job title
-    job.jobTitle = extractJobTitle(lowerLine);
+    // Steps 1-3: one pass lowercases the record, finds the title and splits the skills
+    PreprocessScratch& scratch = preprocessScratch();
+    RecordScan scan = scanRecord(rawLine, "needed with experience in", scratch);
+    
+    if (scan.markerPos > 0) {
+        int start = 0;
+        int end = scan.markerPos;
+        while (start < end && asciiSpace(scratch.lower[start])) start++;
+        while (end > start && asciiSpace(scratch.lower[end - 1])) end--;
+        // Remove leading quote if present
+        if (end > start && scratch.lower[start] == '"') start++;
+        job.jobTitle = CustomString(scratch.lower + start, end - start);
+    } else {
+        job.jobTitle = CustomString("");
+    }
     job.lowerCaseTitle = job.jobTitle;
     
-    // Step 3: Extract skills
-    job.skills = extractSkills(lowerLine);
+    buildSkillArrays(scan, scratch, job.skills);
     job.skillCount = job.skills.size();
     
-    // Step 4: Create lowercase skills array
-    for (int i = 0; i < job.skills.size(); i++) {
-        job.lowerCaseSkills.push_back(convertToLowerCase(job.skills[i]));
-    }
+    // Step 4: lowercase skills (already lower-cased by the scan)
+    copySkillArray(job.skills, job.lowerCaseSkills);
     
     // Step 5: Calculate additional attributes
     job.titleLength = job.jobTitle.size();
     
     // Step 6: Categorize job
-    job.jobCategory = categorizeJob(job.jobTitle);
+    job.categoryCode = categorizeLowerCaseTitleCode(job.jobTitle.c_str());
+    job.jobCategory = CustomString(jobCategoryName(job.categoryCode));
     
     // Step 7: Set experience level (default to mid-level)
     job.experienceLevel = 2;
@@ -314,30 +373,44 @@ Job preprocessJobDescription(const CustomString& rawLine, int id) {
 }
 
 // Build valid skillset from job descriptions
-CustomArray<CustomString> buildValidSkillset(const CustomLinkedList<Job>& jobList) {
-    CustomArray<CustomString> validSkills;
-    
-    cout << "Building valid skillset from job descriptions..." << endl;
-    
-    // Traverse all jobs and collect unique skills
-    for (int i = 0; i < jobList.getSize(); i++) {
-        for (int j = 0; j < jobList[i].skills.size(); j++) {
-            CustomString skill = jobList[i].skills[j];
-            
-            // Check if skill already exists
-            bool exists = false;
-            for (int k = 0; k < validSkills.size(); k++) {
-                if (strcmp(skill.c_str(), validSkills[k].c_str()) == 0) {
-                    exists = true;
-                    break;
-                }
-            }
-            
-            if (!exists) {
-                validSkills.push_back(skill);
+// Append the skills of source that target doesn't have yet, keeping first-seen order
+void mergeUniqueSkills(CustomArray<CustomString>& target, const CustomArray<CustomString>& source) {
+    for (int i = 0; i < source.size(); i++) {
+        bool exists = false;
+        for (int k = 0; k < target.size(); k++) {
+            if (strcmp(source[i].c_str(), target[k].c_str()) == 0) {
+                exists = true;
+                break;
             }
         }
+        if (!exists) {
+            target.push_back(source[i]);
+        }
     }
+}
+
+CustomArray<CustomString> buildValidSkillset(const CustomLinkedList<Job>& jobList) {
+    cout << "Building valid skillset from job descriptions..." << endl;
+    
+    // Index the nodes once so chunks of jobs can be scanned in parallel
+    const Job** jobs = new const Job*[jobList.getSize() > 0 ? jobList.getSize() : 1];
+    int jobCount = 0;
+    for (const ListNode<Job>* node = jobList.getHead(); node != nullptr; node = node->next) {
+        jobs[jobCount++] = &node->data;
+    }
+    
+    // Unique skills per chunk, merged in chunk order (same order as a sequential scan)
+    CustomArray<CustomString> validSkills = parallelReduce(0, jobCount, 0, CustomArray<CustomString>(),
+        [&](int begin, int end) {
+            CustomArray<CustomString> chunkSkills;
+            for (int i = begin; i < end; i++) mergeUniqueSkills(chunkSkills, jobs[i]->skills);
+            return chunkSkills;
+        },
+        [](CustomArray<CustomString> acc, const CustomArray<CustomString>& chunkSkills) {
+            mergeUniqueSkills(acc, chunkSkills);
+            return acc;
+        }, "skillset.build");
+    delete[] jobs;
     
     cout << "Valid skillset built with " << validSkills.size() << " unique skills" << endl;
     return validSkills;
@@ -361,6 +434,74 @@ CustomArray<CustomString> filterResumeSkills(const CustomArray<CustomString>& re
     return filteredSkills;
 }
 
+// Filter resume skills against a hashed skillset; skills that are not valid (yet)
+// are reported through rejectedSkills so they can be re-checked when jobs are added
+CustomArray<CustomString> filterResumeSkills(const CustomArray<CustomString>& resumeSkills,
+                                            const CustomHashMap<CustomString, int>& validSkillIndex,
+                                            CustomArray<CustomString>* rejectedSkills) {
+    CustomArray<CustomString> filteredSkills;
+    
+    for (int i = 0; i < resumeSkills.size(); i++) {
+        if (validSkillIndex.contains(resumeSkills[i])) {
+            filteredSkills.push_back(resumeSkills[i]);
+        } else if (rejectedSkills) {
+            rejectedSkills->push_back(resumeSkills[i]);
+        }
+    }
+    
+    return filteredSkills;
+}
+
+// Skills seen in resumes but not (yet) in any job -> ids of the resumes that list them
+typedef CustomHashMap<CustomString, CustomArray<int> > PendingSkillMap;
+
+// Add a job's skills to the valid skillset, reporting skills seen for the first time
+int extendValidSkillset(const Job& job, CustomArray<CustomString>& validSkills,
+                        CustomHashMap<CustomString, int>& validSkillIndex,
+                        CustomArray<CustomString>* newSkills = nullptr) {
+    int added = 0;
+    for (int i = 0; i < job.skills.size(); i++) {
+        if (!validSkillIndex.contains(job.skills[i])) {
+            validSkillIndex.insert(job.skills[i], validSkills.size());
+            validSkills.push_back(job.skills[i]);
+            if (newSkills) newSkills->push_back(job.skills[i]);
+            added++;
+        }
+    }
+    return added;
+}
+
+// Remember which resume dropped which skills during filtering
+void recordRejectedSkills(PendingSkillMap& pendingSkills, const CustomArray<CustomString>& rejectedSkills,
+                          int resumeId) {
+    for (int i = 0; i < rejectedSkills.size(); i++) {
+        CustomArray<int>* ids = pendingSkills.find(rejectedSkills[i]);
+        if (ids == nullptr) {
+            ids = &pendingSkills.insert(rejectedSkills[i], CustomArray<int>());
+        }
+        ids->push_back(resumeId);
+    }
+}
+
+// Collect (unique) ids of resumes that listed any of the newly valid skills.
+// The skills are removed from the pending map since they are no longer rejected.
+CustomArray<int> takeAffectedResumes(PendingSkillMap& pendingSkills, const CustomArray<CustomString>& newSkills) {
+    CustomArray<int> affected;
+    CustomHashMap<int, bool> seen;
+    for (int i = 0; i < newSkills.size(); i++) {
+        CustomArray<int>* ids = pendingSkills.find(newSkills[i]);
+        if (ids == nullptr) continue;
+        for (int j = 0; j < ids->size(); j++) {
+            if (!seen.contains((*ids)[j])) {
+                seen.insert((*ids)[j], true);
+                affected.push_back((*ids)[j]);
+            }
+        }
+        pendingSkills.remove(newSkills[i]);
+    }
+    return affected;
+}
+
 // Main preprocessing function for resumes (with skillset filtering)
 Resume preprocessResumeDescription(const CustomString& rawLine, int id, 
                                   const CustomArray<CustomString>& validSkills) {
@@ -368,24 +509,58 @@ Resume preprocessResumeDescription(const CustomString& rawLine, int id,
     resume.id = id;
     resume.fullDescription = rawLine;
     
-    // Step 1: Convert to lowercase for processing
-    CustomString lowerLine = convertToLowerCase(rawLine);
+    // Steps 1-2: single pass to lowercase and extract raw skills
+    PreprocessScratch& scratch = preprocessScratch();
+    RecordScan scan = scanRecord(rawLine, "experienced professional skilled in", scratch);
+    resume.skillCount = scan.skillCount;
     
-    // Step 2: Extract raw skills
-    CustomArray<CustomString> rawSkills = extractResumeSkills(lowerLine);
-    
-    resume.skillCount = rawSkills.size();
     // Step 3: Filter against valid skillset
-    resume.resumeSkills = filterResumeSkills(rawSkills, validSkills);
-    
+    resume.resumeSkills.reserve(scan.skillCount);
+    for (int i = 0; i < scan.skillCount; i++) {
+        const char* skill = scratch.lower + scratch.spanStart[i];
+        int skillLen = scratch.spanLength[i];
+        for (int j = 0; j < validSkills.size(); j++) {
+            if (validSkills[j].size() == skillLen && memcmp(validSkills[j].c_str(), skill, skillLen) == 0) {
+                resume.resumeSkills.push_back(validSkills[j]);
+                break;
+            }
+        }
+    }
     
     // Step 4: Create lowercase skills array
-    for (int i = 0; i < resume.resumeSkills.size(); i++) {
-        resume.lowerCaseSkills.push_back(convertToLowerCase(resume.resumeSkills[i]));
-    }
+    copySkillArray(resume.resumeSkills, resume.lowerCaseSkills);
     
     // Step 5: Initialize match score
     resume.matchScore = 0.0;
     
     return resume;
 }
+
+// Resume preprocessing against a hashed skillset (used by incremental ingestion)
+Resume preprocessResumeDescription(const CustomString& rawLine, int id,
+                                  const CustomHashMap<CustomString, int>& validSkillIndex,
+                                  CustomArray<CustomString>* rejectedSkills) {
+    Resume resume;
+    resume.id = id;
+    resume.fullDescription = rawLine;
+    
+    PreprocessScratch& scratch = preprocessScratch();
+    RecordScan scan = scanRecord(rawLine, "experienced professional skilled in", scratch);
+    resume.skillCount = scan.skillCount;
+    
+    resume.resumeSkills.reserve(scan.skillCount);
+    for (int i = 0; i < scan.skillCount; i++) {
+        CustomString skill(scratch.lower + scratch.spanStart[i], scratch.spanLength[i]);
+        if (validSkillIndex.contains(skill)) {
+            resume.resumeSkills.push_back(skill);
+        } else if (rejectedSkills) {
+            rejectedSkills->push_back(skill);
+        }
+    }
+    
+    copySkillArray(resume.resumeSkills, resume.lowerCaseSkills);
+    
+    resume.matchScore = 0.0;
+    
+    return resume;
+}
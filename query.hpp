@@ -0,0 +1,301 @@
+#pragma once
+#include "model.hpp"
+#include "array.hpp"
+#include "linkedlist.hpp"
+#include "preprocessor.hpp"
+#include "matching.hpp"
+#include "thread_pool.hpp"
+#include "score_kernels.hpp"
+#include "scoring.hpp"
+#include <cstring>
+
+using namespace std;
+
+// Read-only query layer shared by both storages.
+//
+// Queries never copy records and never touch matchScore or the order of the
+// store. Array queries return positions into the queried CustomArrayV2, linked
+// list queries return pointers to the data held by list nodes (nodes keep their
+// data through swapNodes, so handles stay valid across sorts). Any per-record
+// scores live in the result object, so one store can serve several queries at
+// once as long as each caller passes its own result.
+
+// Positions of matching records, plus scores for ranking queries
+struct QueryResult {
+    CustomArray<int> indices;      // positions in the queried array, in result order
+    CustomArray<double> scores;    // score of each entry in indices (ranking queries only)
+    CustomArray<double> scratch;   // per-record scores, reused by the next ranking query
+
+    void clear() {
+        indices.clear();
+        scores.clear();
+    }
+
+    int size() const { return indices.size(); }
+    bool empty() const { return indices.empty(); }
+};
+
+// Node handles of matching records, plus scores for ranking queries
+template<typename T>
+struct HandleQueryResult {
+    CustomArray<const T*> items;        // records in result order
+    CustomArray<double> scores;         // score of each entry in items (ranking queries only)
+    CustomArray<const T*> scratchItems; // list order snapshot used while ranking
+    CustomArray<double> scratch;        // per-record scores used while ranking
+
+    void clear() {
+        items.clear();
+        scores.clear();
+    }
+
+    int size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+};
+
+// Positions of the k highest scores, best first. Ties keep the
+// lower position first, which matches the stable sorts the stores used before.
+inline void selectTopScores(const CustomArray<double>& scores, int k, bool positiveOnly, CustomArray<int>& out) {
+    out.clear();
+    if (k <= 0) return;
+    for (int i = 0; i < scores.size(); i++) {
+        double score = scores[i];
+        if (positiveOnly && !(score > 0)) continue;
+        int pos;
+        if (out.size() < k) {
+            out.push_back(i);
+            pos = out.size() - 1;
+        } else if (score > scores[out[k - 1]]) {
+            pos = k - 1;
+        } else {
+            continue;
+        }
+        while (pos > 0 && scores[out[pos - 1]] < score) {
+            out[pos] = out[pos - 1];
+            pos--;
+        }
+        out[pos] = i;
+    }
+}
+
+inline void copyTopScores(const CustomArray<double>& scratch, const CustomArray<int>& order, CustomArray<double>& scores) {
+    scores.clear();
+    for (int i = 0; i < order.size(); i++) scores.push_back(scratch[order[i]]);
+}
+
+// ---------------------------------------------------------------------------
+// Match engine: top topN jobs for a resume under any scoring policy
+// (scoring.hpp). positiveOnly drops jobs scoring 0 or less.
+// ---------------------------------------------------------------------------
+
+template<typename Scorer>
+void queryTopJobs(const CustomArrayV2<Job>& jobs, const Resume& resume, Scorer& scorer, int topN,
+                  bool positiveOnly, QueryResult& out) {
+    out.clear();
+    out.scratch.resize(jobs.getSize());
+    scorer.prepare(resume);
+    const Scorer& prepared = scorer;
+    parallelFor(0, jobs.getSize(), 0, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) out.scratch[i] = prepared.score(jobs[i]);
+    }, Scorer::label());
+    selectTopScores(out.scratch, topN, positiveOnly, out.indices);
+    copyTopScores(out.scratch, out.indices, out.scores);
+}
+
+// Same over the positions in rows only (ascending, e.g. the jobs of some
+// category buckets); ties keep the lower position first as above
+template<typename Scorer>
+void queryTopJobsInRows(const CustomArrayV2<Job>& jobs, const CustomArray<int>& rows, const Resume& resume,
+                        Scorer& scorer, int topN, bool positiveOnly, QueryResult& out) {
+    out.clear();
+    out.scratch.resize(rows.size());
+    scorer.prepare(resume);
+    const Scorer& prepared = scorer;
+    parallelFor(0, rows.size(), 0, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) out.scratch[i] = prepared.score(jobs[rows[i]]);
+    }, Scorer::label());
+    selectTopScores(out.scratch, topN, positiveOnly, out.indices);
+    copyTopScores(out.scratch, out.indices, out.scores);
+    for (int i = 0; i < out.indices.size(); i++) out.indices[i] = rows[out.indices[i]];
+}
+
+// Rank the jobs in out.scratchItems; ties keep their order there
+template<typename Scorer>
+void rankJobHandles(const Resume& resume, Scorer& scorer, int topN, bool positiveOnly, HandleQueryResult<Job>& out) {
+    out.items.clear();
+    out.scores.clear();
+    out.scratch.resize(out.scratchItems.size());
+    scorer.prepare(resume);
+    const Scorer& prepared = scorer;
+    parallelFor(0, out.scratchItems.size(), 0, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) out.scratch[i] = prepared.score(*out.scratchItems[i]);
+    }, Scorer::label());
+
+    CustomArray<int> order;
+    selectTopScores(out.scratch, topN, positiveOnly, order);
+    for (int i = 0; i < order.size(); i++) {
+        out.items.push_back(out.scratchItems[order[i]]);
+        out.scores.push_back(out.scratch[order[i]]);
+    }
+}
+
+// Same over a list; ties keep list order
+template<typename Scorer>
+void queryTopJobList(const CustomLinkedList<Job>& jobs, const Resume& resume, Scorer& scorer, int topN,
+                     bool positiveOnly, HandleQueryResult<Job>& out) {
+    out.clear();
+    out.scratchItems.clear();
+    out.scratchItems.reserve(jobs.getSize());
+    for (const ListNode<Job>* current = jobs.getHead(); current != nullptr; current = current->next) {
+        out.scratchItems.push_back(&current->data);
+    }
+    INSTRUMENT_COUNT(COUNTER_NODE_HOPS, jobs.getSize());
+    rankJobHandles(resume, scorer, topN, positiveOnly, out);
+}
+
+// ---------------------------------------------------------------------------
+// Array storage queries
+// ---------------------------------------------------------------------------
+
+// Jobs whose title equals title exactly
+inline void queryJobsByTitle(const CustomArrayV2<Job>& jobs, const CustomString& title, QueryResult& out) {
+    out.clear();
+    if (title.c_str() == nullptr) return;
+    for (int i = 0; i < jobs.getSize(); i++) {
+        if (strcmp(jobs[i].jobTitle.c_str(), title.c_str()) == 0) out.indices.push_back(i);
+    }
+}
+
+// Case-insensitive skill match against the stored lower-cased skills
+inline bool hasLowerCaseSkill(const CustomArray<CustomString>& lowerCaseSkills, const CustomString& lowerSkill) {
+    for (int j = 0; j < lowerCaseSkills.size(); j++) {
+        if (strcmp(lowerCaseSkills[j].c_str(), lowerSkill.c_str()) == 0) return true;
+    }
+    return false;
+}
+
+inline void queryJobsBySkill(const CustomArrayV2<Job>& jobs, const CustomString& skill, QueryResult& out) {
+    out.clear();
+    CustomString lowerSkill = convertToLowerCase(skill);
+    if (lowerSkill.c_str() == nullptr) return;
+    for (int i = 0; i < jobs.getSize(); i++) {
+        if (hasLowerCaseSkill(jobs[i].lowerCaseSkills, lowerSkill)) out.indices.push_back(i);
+    }
+}
+
+inline void queryResumesBySkill(const CustomArrayV2<Resume>& resumes, const CustomString& skill, QueryResult& out) {
+    out.clear();
+    CustomString lowerSkill = convertToLowerCase(skill);
+    if (lowerSkill.c_str() == nullptr) return;
+    for (int i = 0; i < resumes.getSize(); i++) {
+        if (hasLowerCaseSkill(resumes[i].lowerCaseSkills, lowerSkill)) out.indices.push_back(i);
+    }
+}
+
+// Jobs whose lower-cased title contains keyword (case-insensitive)
+inline void queryJobsByTitleKeyword(const CustomArrayV2<Job>& jobs, const CustomString& keyword, QueryResult& out) {
+    out.clear();
+    CustomString lowerKey = convertToLowerCase(keyword);
+    if (lowerKey.c_str() == nullptr) return;
+    INSTRUMENT_COUNT(COUNTER_STRCMP, jobs.getSize());
+    for (int i = 0; i < jobs.getSize(); i++) {
+        const char* title = jobs[i].lowerCaseTitle.c_str();
+        if (title && strstr(title, lowerKey.c_str())) out.indices.push_back(i);
+    }
+}
+
+// Top topN jobs for a resume by weighted skill score
+inline void queryTopJobsByWeightedScore(const CustomArrayV2<Job>& jobs, const Resume& resume, int topN, QueryResult& out) {
+    WeightedScorer scorer;
+    queryTopJobs(jobs, resume, scorer, topN, false, out);
+}
+
+// Same ranking through the batch kernel; columns must be built from jobs
+inline void queryTopJobsByWeightedScore(const WeightedScoreColumns& columns, const CustomArrayV2<Job>& jobs,
+                                        const Resume& resume, int topN, QueryResult& out) {
+    if (columns.jobCount != jobs.getSize()) {
+        queryTopJobsByWeightedScore(jobs, resume, topN, out);
+        return;
+    }
+    out.clear();
+    out.scratch.resize(jobs.getSize());
+    if (jobs.getSize() > 0) scoreAllJobsWeighted(columns, jobs, resume, &out.scratch[0]);
+    selectTopScores(out.scratch, topN, false, out.indices);
+    copyTopScores(out.scratch, out.indices, out.scores);
+}
+
+// Same ranking over the positions in rows only (ascending)
+inline void queryTopJobsByWeightedScoreInRows(const WeightedScoreColumns& columns, const CustomArrayV2<Job>& jobs,
+                                              const CustomArray<int>& rows, const Resume& resume, int topN, QueryResult& out) {
+    if (columns.jobCount != jobs.getSize()) {
+        WeightedScorer scorer;
+        queryTopJobsInRows(jobs, rows, resume, scorer, topN, false, out);
+        return;
+    }
+    out.clear();
+    out.scratch.resize(rows.size());
+    if (rows.size() > 0) scoreJobRowsWeighted(columns, jobs, rows, resume, &out.scratch[0]);
+    selectTopScores(out.scratch, topN, false, out.indices);
+    copyTopScores(out.scratch, out.indices, out.scores);
+    for (int i = 0; i < out.indices.size(); i++) out.indices[i] = rows[out.indices[i]];
+}
+
+// Top topN jobs for a resume by keyword overlap. Uses cached masks when the
+// matcher filled them earlier, otherwise scans without writing to the store;
+// ArrayDataStorage fills them as rows are added, so its queries never scan.
+inline void queryTopJobsByKeywords(const CustomArrayV2<Job>& jobs, const Resume& resume,
+                                   const KeywordMatcher& matcher, int topN, QueryResult& out) {
+    KeywordScorer scorer(matcher);
+    queryTopJobs(jobs, resume, scorer, topN, false, out);
+}
+
+// ---------------------------------------------------------------------------
+// Linked list storage queries (exact, case-sensitive matches like the
+// original linear searches)
+// ---------------------------------------------------------------------------
+
+inline void queryJobListByTitle(const CustomLinkedList<Job>& jobs, const CustomString& title, HandleQueryResult<Job>& out) {
+    out.clear();
+    if (title.c_str() == nullptr) return;
+    for (const ListNode<Job>* current = jobs.getHead(); current != nullptr; current = current->next) {
+        if (strcmp(current->data.jobTitle.c_str(), title.c_str()) == 0) out.items.push_back(&current->data);
+    }
+    INSTRUMENT_COUNT(COUNTER_NODE_HOPS, jobs.getSize());
+    INSTRUMENT_COUNT(COUNTER_STRCMP, jobs.getSize());
+}
+
+inline bool hasExactSkill(const CustomArray<CustomString>& skills, const CustomString& skill) {
+    for (int i = 0; i < skills.size(); ++i) {
+        if (strcmp(skills[i].c_str(), skill.c_str()) == 0) {
+            INSTRUMENT_COUNT(COUNTER_STRCMP, i + 1);
+            return true;
+        }
+    }
+    INSTRUMENT_COUNT(COUNTER_STRCMP, skills.size());
+    return false;
+}
+
+inline void queryJobListBySkill(const CustomLinkedList<Job>& jobs, const CustomString& skill, HandleQueryResult<Job>& out) {
+    out.clear();
+    if (skill.c_str() == nullptr) return;
+    for (const ListNode<Job>* current = jobs.getHead(); current != nullptr; current = current->next) {
+        if (hasExactSkill(current->data.skills, skill)) out.items.push_back(&current->data);
+    }
+    INSTRUMENT_COUNT(COUNTER_NODE_HOPS, jobs.getSize());
+}
+
+inline void queryResumeListBySkill(const CustomLinkedList<Resume>& resumes, const CustomString& skill,
+                                   HandleQueryResult<Resume>& out) {
+    out.clear();
+    if (skill.c_str() == nullptr) return;
+    for (const ListNode<Resume>* current = resumes.getHead(); current != nullptr; current = current->next) {
+        if (hasExactSkill(current->data.resumeSkills, skill)) out.items.push_back(&current->data);
+    }
+    INSTRUMENT_COUNT(COUNTER_NODE_HOPS, resumes.getSize());
+}
+
+// Top topN jobs with a positive Jaccard score for a resume, in list order on ties
+inline void queryTopJobListByJaccard(const CustomLinkedList<Job>& jobs, const Resume& resume, int topN,
+                                     HandleQueryResult<Job>& out) {
+    JaccardScorer scorer;
+    queryTopJobList(jobs, resume, scorer, topN, true, out);
+}
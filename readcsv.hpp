@@ -73,6 +73,58 @@ public:
         return lines;
     }
     
+    // Read complete lines appended after a byte offset (file tail). The header is
+    // skipped when starting from offset 0; a trailing partial line is left unread
+    // so the next call picks it up once the writer finishes it, unless the caller
+    // treats the file as complete (full loads).
+    CustomArray<CustomString> readLinesFrom(long long startOffset, long long& endOffset,
+                                            bool includePartialLine = false) {
+        CustomArray<CustomString> lines;
+        endOffset = startOffset;
+        ifstream file(filename, ios::binary);
+        
+        if (!file.is_open()) {
+            cerr << "Error: Could not open file " << filename << endl;
+            return lines;
+        }
+        
+        file.seekg(0, ios::end);
+        long long fileSize = file.tellg();
+        if (fileSize <= startOffset) {
+            return lines;
+        }
+        
+        long long tailSize = fileSize - startOffset;
+        char* buffer = new char[tailSize + 1];
+        file.seekg(startOffset);
+        file.read(buffer, tailSize);
+        buffer[tailSize] = '\0';
+        file.close();
+        
+        const char* lineStart = buffer;
+        const char* bufferEnd = buffer + tailSize;
+        bool skipHeader = (startOffset == 0);
+        while (lineStart < bufferEnd) {
+            const char* newline = static_cast<const char*>(memchr(lineStart, '\n', bufferEnd - lineStart));
+            if (newline == nullptr) {
+                if (!includePartialLine) {
+                    break; // Partial line, wait for the rest
+                }
+                newline = bufferEnd;
+            }
+            if (skipHeader) {
+                skipHeader = false;
+            } else {
+                lines.push_back(CustomString(lineStart, newline - lineStart));
+            }
+            lineStart = (newline < bufferEnd) ? newline + 1 : bufferEnd;
+        }
+        
+        endOffset = startOffset + (lineStart - buffer);
+        delete[] buffer;
+        return lines;
+    }
+    
     // Parse CSV line and return array of fields
     CustomArray<CustomString> parseCSVLine(const char* line) {
         CustomArray<CustomString> fields;
@@ -136,6 +188,27 @@ public:
     }
 };
 
+// Split an in-memory block of CSV rows (no header) into lines
+CustomArray<CustomString> splitCSVBuffer(const char* buffer) {
+    CustomArray<CustomString> lines;
+    if (buffer == nullptr) {
+        return lines;
+    }
+    
+    const char* lineStart = buffer;
+    while (*lineStart != '\0') {
+        const char* lineEnd = lineStart;
+        while (*lineEnd != '\0' && *lineEnd != '\n') {
+            lineEnd++;
+        }
+        if (lineEnd > lineStart) {
+            lines.push_back(CustomString(lineStart, lineEnd - lineStart));
+        }
+        lineStart = (*lineEnd == '\n') ? lineEnd + 1 : lineEnd;
+    }
+    return lines;
+}
+
 // Helper function to read job descriptions
 void readJobDescriptions(const char* filename, int maxLines = 10) {
     CSVReader reader(filename);
@@ -146,53 +219,87 @@ void readJobDescriptions(const char* filename, int maxLines = 10) {
 }
 
 // Load jobs into linked list with preprocessing
-CustomLinkedList<Job> loadJobsAsLinkedList(const char* filename) {
+CustomLinkedList<Job> loadJobsAsLinkedList(const char* filename, long long* endOffset = nullptr) {
     CustomLinkedList<Job> jobList;
     CSVReader reader(filename);
     
     cout << "Loading jobs from " << filename << "..." << endl;
     
-    CustomArray<CustomString> rawLines = reader.readAllLines();
+    long long offset = 0;
+    CustomArray<CustomString> rawLines = reader.readLinesFrom(0, offset, true);
+    if (endOffset) *endOffset = offset;
     cout << "Read " << rawLines.size() << " raw lines from CSV" << endl;
     
+    // Preprocess on the thread pool, then link in file order
+    Job* jobs = new Job[rawLines.size() > 0 ? rawLines.size() : 1];
+    parallelFor(0, rawLines.size(), 0, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) jobs[i] = preprocessJobDescription(rawLines[i], i + 1);
+    }, "preprocess.jobs");
+    
     for (int i = 0; i < rawLines.size(); i++) {
-        Job job = preprocessJobDescription(rawLines[i], i + 1);
-        jobList.push_back(job);
+        jobList.push_back(jobs[i]);
         
         // Progress indicator
         if ((i + 1) % 1000 == 0) {
             cout << "Processed " << (i + 1) << " jobs..." << endl;
         }
     }
+    delete[] jobs;
     
     cout << "Successfully loaded " << jobList.getSize() << " jobs into linked list" << endl;
     return jobList;
 }
 
-// Load resumes into linked list with preprocessing (with skillset filtering)
-CustomLinkedList<Resume> loadResumesAsLinkedList(const char* filename, const CustomArray<CustomString>& validSkills) {
+// Load resumes using a hashed skillset; rejected skills are recorded for incremental ingestion
+CustomLinkedList<Resume> loadResumesAsLinkedList(const char* filename,
+                                                 const CustomHashMap<CustomString, int>& validSkillIndex,
+                                                 PendingSkillMap* pendingSkills = nullptr,
+                                                 long long* endOffset = nullptr) {
     CustomLinkedList<Resume> resumeList;
     CSVReader reader(filename);
     
     cout << "Loading resumes from " << filename << "..." << endl;
     
-    CustomArray<CustomString> rawLines = reader.readAllLines();
+    long long offset = 0;
+    CustomArray<CustomString> rawLines = reader.readLinesFrom(0, offset, true);
+    if (endOffset) *endOffset = offset;
     cout << "Read " << rawLines.size() << " raw lines from CSV" << endl;
     
+    // Preprocess on the thread pool (the skill index is only read), then link in file order
+    Resume* resumes = new Resume[rawLines.size() > 0 ? rawLines.size() : 1];
+    CustomArray<CustomString>* rejected = new CustomArray<CustomString>[rawLines.size() > 0 ? rawLines.size() : 1];
+    parallelFor(0, rawLines.size(), 0, [&](int begin, int end) {
+        for (int i = begin; i < end; i++)
+            resumes[i] = preprocessResumeDescription(rawLines[i], i + 1, validSkillIndex, &rejected[i]);
+    }, "preprocess.resumes");
+    
     for (int i = 0; i < rawLines.size(); i++) {
-        Resume resume = preprocessResumeDescription(rawLines[i], i + 1, validSkills);
-        resumeList.push_back(resume);
+        if (pendingSkills) {
+            recordRejectedSkills(*pendingSkills, rejected[i], resumes[i].id);
+        }
+        resumeList.push_back(resumes[i]);
         
         // Progress indicator
         if ((i + 1) % 1000 == 0) {
             cout << "Processed " << (i + 1) << " resumes..." << endl;
         }
     }
+    delete[] resumes;
+    delete[] rejected;
     
     cout << "Successfully loaded " << resumeList.getSize() << " resumes into linked list" << endl;
     return resumeList;
 }
 
+// Load resumes into linked list with preprocessing (with skillset filtering)
+CustomLinkedList<Resume> loadResumesAsLinkedList(const char* filename, const CustomArray<CustomString>& validSkills) {
+    CustomHashMap<CustomString, int> validSkillIndex;
+    for (int i = 0; i < validSkills.size(); i++) {
+        validSkillIndex.insert(validSkills[i], i);
+    }
+    return loadResumesAsLinkedList(filename, validSkillIndex);
+}
+
 // Display sample of processed jobs
 void displaySampleJobs(const CustomLinkedList<Job>& jobList, int maxJobs = 5) {
     cout << "\n=== SAMPLE PROCESSED JOBS ===" << endl;
@@ -0,0 +1,357 @@
+#pragma once
+#include "model.hpp"
+#include "array.hpp"
+#include "hashmap.hpp"
+#include "matching.hpp"
+#include "simd_text.hpp"
+#include "thread_pool.hpp"
+#include "snapshot_section.hpp"
+
+using namespace std;
+
+// Batch weighted scoring: one resume against every job at once.
+//
+// The job side is stored column-wise: a skill bitmask per job (one bit per
+// distinct skill string), the skill count and the id tie-breaker. For a resume
+// the match count of a job is then popcount(jobMask & resumeMask), and the
+// weighted formula is evaluated for 4 jobs per AVX2 step (scalar elsewhere).
+// Scores match calculateWeightedMatchScore bit for bit: the same divisions and
+// additions in the same order (separate multiply and add, no FMA).
+//
+// Jobs or resumes listing a skill more than once don't fit the popcount (the
+// two match counts of the formula differ then); those pairs go through
+// calculateWeightedMatchScore.
+
+struct WeightedScoreColumns {
+    CustomHashMap<CustomString, int> skillBits;    // exact skill string -> bit number
+    int words;                                     // 64-bit words per job mask
+    int jobCount;
+    CustomArray<unsigned long long> masks;         // jobCount * words
+    CustomArray<double> skillCounts;               // job.skills.size()
+    CustomArray<double> tieBreakers;               // job.id / 100000.0
+    CustomArray<int> repeatedSkillJobs;            // positions scored by the scalar function
+
+    WeightedScoreColumns() : words(1), jobCount(0) {}
+
+    // Fill row i from job; true if the job lists a skill twice
+    bool fillRow(const Job& job, int i) {
+        unsigned long long* mask = &masks[i * words];
+        for (int w = 0; w < words; w++) mask[w] = 0;
+        bool repeated = false;
+        for (int k = 0; k < job.skills.size(); k++) {
+            int bit = *skillBits.find(job.skills[k]);
+            unsigned long long flag = 1ULL << (bit % 64);
+            if (mask[bit / 64] & flag) repeated = true;
+            mask[bit / 64] |= flag;
+        }
+        skillCounts[i] = static_cast<double>(job.skills.size());
+        tieBreakers[i] = static_cast<double>(job.id) / 100000.0;
+        return repeated;
+    }
+
+    // Give every mask newWords words; the new words are zero
+    void widen(int newWords) {
+        CustomArray<unsigned long long> wider;
+        wider.resize(jobCount * newWords);
+        for (int i = 0; i < jobCount; i++) {
+            for (int w = 0; w < words; w++) wider[i * newWords + w] = masks[i * words + w];
+        }
+        masks = move(wider);
+        words = newWords;
+    }
+
+    void build(const CustomArrayV2<Job>& jobs) {
+        skillBits.clear();
+        repeatedSkillJobs.clear();
+        jobCount = jobs.getSize();
+        for (int i = 0; i < jobCount; i++) {
+            for (int k = 0; k < jobs[i].skills.size(); k++) {
+                if (!skillBits.contains(jobs[i].skills[k])) skillBits.insert(jobs[i].skills[k], skillBits.size());
+            }
+        }
+        words = max(1, (skillBits.size() + 63) / 64);
+
+        masks.resize(jobCount * words);
+        skillCounts.resize(jobCount);
+        tieBreakers.resize(jobCount);
+        CustomArray<char> repeated;
+        repeated.resize(jobCount);
+        parallelFor(0, jobCount, 0, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) repeated[i] = fillRow(jobs[i], i) ? 1 : 0;
+        }, "match.weighted.columns");
+        for (int i = 0; i < jobCount; i++) {
+            if (repeated[i]) repeatedSkillJobs.push_back(i);
+        }
+    }
+
+    // Add the rows of the jobs appended since the last build or append. A
+    // skill no job had before takes the next bit; when the bits outgrow the
+    // masks, the masks double in width, which leaves every score unchanged.
+    void append(const CustomArrayV2<Job>& jobs) {
+        int first = jobCount;
+        for (int i = first; i < jobs.getSize(); i++) {
+            for (int k = 0; k < jobs[i].skills.size(); k++) {
+                if (!skillBits.contains(jobs[i].skills[k])) skillBits.insert(jobs[i].skills[k], skillBits.size());
+            }
+        }
+        int needed = max(1, (skillBits.size() + 63) / 64);
+        if (needed > words) widen(max(needed, words * 2));
+
+        jobCount = jobs.getSize();
+        masks.resize(jobCount * words);
+        skillCounts.resize(jobCount);
+        tieBreakers.resize(jobCount);
+        for (int i = first; i < jobCount; i++) {
+            if (fillRow(jobs[i], i)) repeatedSkillJobs.push_back(i);
+        }
+    }
+
+    // The jobs were reordered: the row at old position p moves to
+    // newPosition[p]. Skill bits stay as they are.
+    void remap(const CustomArray<int>& newPosition) {
+        CustomArray<unsigned long long> movedMasks;
+        CustomArray<double> movedCounts;
+        CustomArray<double> movedTieBreakers;
+        movedMasks.resize(jobCount * words);
+        movedCounts.resize(jobCount);
+        movedTieBreakers.resize(jobCount);
+        parallelFor(0, jobCount, 0, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                int to = newPosition[i];
+                for (int w = 0; w < words; w++) movedMasks[to * words + w] = masks[i * words + w];
+                movedCounts[to] = skillCounts[i];
+                movedTieBreakers[to] = tieBreakers[i];
+            }
+        }, "match.weighted.columns");
+        masks = move(movedMasks);
+        skillCounts = move(movedCounts);
+        tieBreakers = move(movedTieBreakers);
+        CustomArray<char> repeated;
+        repeated.resize(jobCount);
+        for (int r = 0; r < repeatedSkillJobs.size(); r++) repeated[newPosition[repeatedSkillJobs[r]]] = 1;
+        repeatedSkillJobs.clear();
+        for (int i = 0; i < jobCount; i++) {
+            if (repeated[i]) repeatedSkillJobs.push_back(i);
+        }
+    }
+
+    // Snapshot section: the skills by bit, then the columns
+    void save(SnapshotSectionWriter& out) const {
+        CustomArray<const CustomString*> byBit;
+        byBit.resize(skillBits.size());
+        skillBits.forEach([&](const CustomString& skill, int bit) { byBit[bit] = &skill; });
+        out.putStrings(byBit.size(), [&](int i) -> const CustomString& { return *byBit[i]; });
+        out.putValue(words);
+        out.putValue(jobCount);
+        out.putArray(masks);
+        out.putArray(skillCounts);
+        out.putArray(tieBreakers);
+        out.putArray(repeatedSkillJobs);
+    }
+
+    // Load a saved section over storeSize jobs; false leaves no rows
+    bool restore(SnapshotSectionReader& in, int storeSize) {
+        skillBits.clear();
+        CustomArray<CustomString> byBit;
+        bool ok = in.getStrings(byBit) && in.getValue(words) && in.getValue(jobCount) && in.getArray(masks)
+               && in.getArray(skillCounts) && in.getArray(tieBreakers) && in.getArray(repeatedSkillJobs)
+               && jobCount == storeSize && words >= max(1, (byBit.size() + 63) / 64)
+               && masks.size() == static_cast<long long>(jobCount) * words
+               && skillCounts.size() == jobCount && tieBreakers.size() == jobCount;
+        for (int i = 0; ok && i < repeatedSkillJobs.size(); i++) {
+            ok = repeatedSkillJobs[i] >= 0 && repeatedSkillJobs[i] < jobCount
+              && (i == 0 || repeatedSkillJobs[i] > repeatedSkillJobs[i - 1]);
+        }
+        skillBits.reserve(byBit.size());
+        for (int i = 0; ok && i < byBit.size(); i++) {
+            ok = !skillBits.contains(byBit[i]);
+            skillBits.insert(byBit[i], i);
+        }
+        if (!ok) {
+            skillBits.clear();
+            words = 1;
+            jobCount = 0;
+            masks.clear();
+            skillCounts.clear();
+            tieBreakers.clear();
+            repeatedSkillJobs.clear();
+            return in.fail();
+        }
+        return true;
+    }
+
+    // Resume bitmask over the same skill bits; false if the resume repeats a
+    // skill. Skills no job has get no bit, they can't match anyway.
+    bool resumeMask(const Resume& resume, unsigned long long* mask) const {
+        for (int w = 0; w < words; w++) mask[w] = 0;
+        for (int k = 0; k < resume.resumeSkills.size(); k++) {
+            const int* bit = skillBits.find(resume.resumeSkills[k]);
+            if (bit == nullptr) {
+                for (int other = 0; other < k; other++) {
+                    if (strcmp(resume.resumeSkills[other].c_str(), resume.resumeSkills[k].c_str()) == 0) return false;
+                }
+                continue;
+            }
+            unsigned long long flag = 1ULL << (*bit % 64);
+            if (mask[*bit / 64] & flag) return false;
+            mask[*bit / 64] |= flag;
+        }
+        return true;
+    }
+};
+
+inline int matchedSkills(const unsigned long long* jobMask, const unsigned long long* resumeMask, int words) {
+    int count = 0;
+    for (int w = 0; w < words; w++) count += countKeywordBits(jobMask[w] & resumeMask[w]);
+    return count;
+}
+
+// Same arithmetic as calculateWeightedMatchScore, given the match count
+inline double weightedScoreFromCounts(double matches, double jobSkills, double resumeSkills, double tieBreaker) {
+    if (jobSkills == 0) return 0.0;
+    double jobCoverage = matches / jobSkills;
+    double resumeUtilization = matches / resumeSkills;
+    double matchBonus = matches / max(jobSkills, resumeSkills);
+    double skillDensityBonus = jobSkills / 10.0;
+    double finalScore = (0.4 * jobCoverage) + (0.25 * resumeUtilization) + (0.2 * matchBonus) + (0.15 * skillDensityBonus);
+    return finalScore + tieBreaker;
+}
+
+inline void weightedScoreRangeScalar(const WeightedScoreColumns& columns, const unsigned long long* resumeMask,
+                                     double resumeSkills, int begin, int end, double* out) {
+    for (int i = begin; i < end; i++) {
+        double matches = matchedSkills(&columns.masks[i * columns.words], resumeMask, columns.words);
+        out[i] = weightedScoreFromCounts(matches, columns.skillCounts[i], resumeSkills, columns.tieBreakers[i]);
+    }
+}
+
+#if defined(TEXT_KERNELS_AVX2)
+
+__attribute__((target("avx2,popcnt")))
+inline void weightedScoreRangeAVX2(const WeightedScoreColumns& columns, const unsigned long long* resumeMask,
+                                   double resumeSkills, int begin, int end, double* out) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d resume = _mm256_set1_pd(resumeSkills);
+    const __m256d ten = _mm256_set1_pd(10.0);
+    const __m256d coverageWeight = _mm256_set1_pd(0.4);
+    const __m256d utilizationWeight = _mm256_set1_pd(0.25);
+    const __m256d bonusWeight = _mm256_set1_pd(0.2);
+    const __m256d densityWeight = _mm256_set1_pd(0.15);
+    const unsigned long long* masks = &columns.masks[0];
+    const double* skillCounts = &columns.skillCounts[0];
+    const double* tieBreakers = &columns.tieBreakers[0];
+    int words = columns.words;
+
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m256d matches;
+        if (words == 1) {
+            matches = _mm256_set_pd(countKeywordBits(masks[i + 3] & resumeMask[0]),
+                                    countKeywordBits(masks[i + 2] & resumeMask[0]),
+                                    countKeywordBits(masks[i + 1] & resumeMask[0]),
+                                    countKeywordBits(masks[i] & resumeMask[0]));
+        } else {
+            matches = _mm256_set_pd(matchedSkills(masks + (i + 3) * words, resumeMask, words),
+                                    matchedSkills(masks + (i + 2) * words, resumeMask, words),
+                                    matchedSkills(masks + (i + 1) * words, resumeMask, words),
+                                    matchedSkills(masks + i * words, resumeMask, words));
+        }
+        __m256d job = _mm256_loadu_pd(skillCounts + i);
+        __m256d coverage = _mm256_div_pd(matches, job);
+        __m256d utilization = _mm256_div_pd(matches, resume);
+        __m256d bonus = _mm256_div_pd(matches, _mm256_max_pd(job, resume));
+        __m256d density = _mm256_div_pd(job, ten);
+        __m256d score = _mm256_add_pd(_mm256_mul_pd(coverageWeight, coverage), _mm256_mul_pd(utilizationWeight, utilization));
+        score = _mm256_add_pd(score, _mm256_mul_pd(bonusWeight, bonus));
+        score = _mm256_add_pd(score, _mm256_mul_pd(densityWeight, density));
+        score = _mm256_add_pd(score, _mm256_loadu_pd(tieBreakers + i));
+        // Jobs without skills score 0 (their coverage lane is NaN)
+        score = _mm256_andnot_pd(_mm256_cmp_pd(job, zero, _CMP_EQ_OQ), score);
+        _mm256_storeu_pd(out + i, score);
+    }
+    weightedScoreRangeScalar(columns, resumeMask, resumeSkills, i, end, out);
+}
+
+#endif
+
+typedef void (*WeightedScoreKernel)(const WeightedScoreColumns&, const unsigned long long*, double, int, int, double*);
+
+inline WeightedScoreKernel selectWeightedScoreKernel() {
+#if defined(TEXT_KERNELS_AVX2)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) return weightedScoreRangeAVX2;
+#endif
+    return weightedScoreRangeScalar;
+}
+
+inline WeightedScoreKernel weightedScoreKernel() {
+    static const WeightedScoreKernel kernel = selectWeightedScoreKernel();
+    return kernel;
+}
+
+inline const char* weightedScoreKernelName() {
+    return weightedScoreKernel() == weightedScoreRangeScalar ? "scalar" : "avx2";
+}
+
+// Weighted score of resume against every job into scores[0, jobs.getSize()).
+// columns must have been built from jobs.
+inline void scoreAllJobsWeighted(const WeightedScoreColumns& columns, const CustomArrayV2<Job>& jobs,
+                                 const Resume& resume, double* scores) {
+    int n = jobs.getSize();
+    double resumeSkills = static_cast<double>(resume.resumeSkills.size());
+    CustomArray<unsigned long long> mask;
+    mask.resize(columns.words);
+
+    if (resumeSkills == 0 || !columns.resumeMask(resume, &mask[0])) {
+        parallelFor(0, n, 0, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) scores[i] = calculateWeightedMatchScore(jobs[i], resume);
+        }, "match.weighted");
+        return;
+    }
+
+    WeightedScoreKernel kernel = weightedScoreKernel();
+    parallelFor(0, n, 0, [&](int begin, int end) {
+        kernel(columns, &mask[0], resumeSkills, begin, end, scores);
+    }, "match.weighted");
+    for (int r = 0; r < columns.repeatedSkillJobs.size(); r++) {
+        int i = columns.repeatedSkillJobs[r];
+        scores[i] = calculateWeightedMatchScore(jobs[i], resume);
+    }
+}
+
+// Weighted score of resume against the jobs at rows (ascending positions)
+// into scores[0, rows.size()); a gather over the same columns, for queries
+// restricted to some jobs
+inline void scoreJobRowsWeighted(const WeightedScoreColumns& columns, const CustomArrayV2<Job>& jobs,
+                                 const CustomArray<int>& rows, const Resume& resume, double* scores) {
+    int n = rows.size();
+    double resumeSkills = static_cast<double>(resume.resumeSkills.size());
+    CustomArray<unsigned long long> mask;
+    mask.resize(columns.words);
+
+    if (resumeSkills == 0 || !columns.resumeMask(resume, &mask[0])) {
+        parallelFor(0, n, 0, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) scores[i] = calculateWeightedMatchScore(jobs[rows[i]], resume);
+        }, "match.weighted");
+        return;
+    }
+
+    parallelFor(0, n, 0, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            int row = rows[i];
+            double matches = matchedSkills(&columns.masks[row * columns.words], &mask[0], columns.words);
+            scores[i] = weightedScoreFromCounts(matches, columns.skillCounts[row], resumeSkills, columns.tieBreakers[row]);
+        }
+    }, "match.weighted");
+    for (int r = 0; r < columns.repeatedSkillJobs.size(); r++) {
+        int row = columns.repeatedSkillJobs[r];
+        int low = 0;
+        int high = n;
+        while (low < high) {
+            int mid = low + (high - low) / 2;
+            if (rows[mid] < row) low = mid + 1;
+            else high = mid;
+        }
+        if (low < n && rows[low] == row) scores[low] = calculateWeightedMatchScore(jobs[row], resume);
+    }
+}
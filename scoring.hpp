@@ -0,0 +1,242 @@
+#pragma once
+#include "model.hpp"
+#include "array.hpp"
+#include "linkedlist.hpp"
+#include "hashmap.hpp"
+#include "matching.hpp"
+#include "snapshot_section.hpp"
+#include <cmath>
+#include <cstring>
+
+using namespace std;
+
+// Scoring policies for the match engine (queryTopJobs / queryTopJobList in
+// query.hpp). The engine is a template over the policy, so score() is inlined
+// into the scan loop; there is no common base class and no virtual call.
+//
+// A policy provides:
+//   static const char* name();          // shown in menus
+//   static const char* label();         // thread pool timing region
+//   void prepare(const Resume& resume); // once per query, before any score()
+//   double score(const Job& job) const; // per job, called from pool threads
+//
+// A prepared policy is read-only, so one instance serves all threads of a
+// query. Prepare a separate instance per concurrent query.
+
+// Skill overlap of a resume and a job by exact lower-cased skill
+inline int countSharedSkills(const Job& job, const Resume& resume) {
+    int shared = 0;
+    long long compares = 0;
+    for (int j = 0; j < resume.lowerCaseSkills.size(); ++j) {
+        for (int k = 0; k < job.lowerCaseSkills.size(); ++k) {
+            compares++;
+            if (strcmp(resume.lowerCaseSkills[j].c_str(), job.lowerCaseSkills[k].c_str()) == 0) {
+                shared++;
+                break;
+            }
+        }
+    }
+    INSTRUMENT_COUNT(COUNTER_STRCMP, compares);
+    return shared;
+}
+
+// Weighted skill coverage (array storage default)
+struct WeightedScorer {
+    const Resume* resume;
+
+    WeightedScorer() : resume(nullptr) {}
+
+    static const char* name() { return "Weighted"; }
+    static const char* label() { return "match.weighted"; }
+    void prepare(const Resume& r) { resume = &r; }
+    double score(const Job& job) const { return calculateWeightedMatchScore(job, *resume); }
+};
+
+// Jaccard similarity of skill sets (linked list storage default)
+struct JaccardScorer {
+    const Resume* resume;
+
+    JaccardScorer() : resume(nullptr) {}
+
+    static const char* name() { return "Jaccard"; }
+    static const char* label() { return "match.jaccard"; }
+    void prepare(const Resume& r) { resume = &r; }
+    double score(const Job& job) const { return calculateJaccardMatchScore(job, *resume); }
+};
+
+// Number of keywords found in both descriptions
+struct KeywordScorer {
+    const KeywordMatcher& matcher;
+    unsigned long long resumeMask;
+
+    explicit KeywordScorer(const KeywordMatcher& keywordMatcher) : matcher(keywordMatcher), resumeMask(0) {}
+
+    static const char* name() { return "Keyword"; }
+    static const char* label() { return "match.keywords"; }
+    void prepare(const Resume& r) { resumeMask = matcher.maskFor(r); }
+    double score(const Job& job) const {
+        return static_cast<double>(KeywordMatcher::score(matcher.maskFor(job), resumeMask));
+    }
+};
+
+// Cosine similarity of binary skill vectors: shared / sqrt(|job| * |resume|)
+struct CosineScorer {
+    const Resume* resume;
+    double resumeNorm;
+
+    CosineScorer() : resume(nullptr), resumeNorm(0.0) {}
+
+    static const char* name() { return "Cosine"; }
+    static const char* label() { return "match.cosine"; }
+    void prepare(const Resume& r) {
+        resume = &r;
+        resumeNorm = sqrt(static_cast<double>(r.lowerCaseSkills.size()));
+    }
+    double score(const Job& job) const {
+        if (job.lowerCaseSkills.size() == 0 || resumeNorm == 0.0) return 0.0;
+        return countSharedSkills(job, *resume) / (sqrt(static_cast<double>(job.lowerCaseSkills.size())) * resumeNorm);
+    }
+};
+
+// Document frequencies of lower-cased skills over a job collection, for BM25
+struct SkillStatistics {
+    CustomHashMap<CustomString, int> documentFrequency;
+    int documents;
+    double averageLength;
+
+    SkillStatistics() : documents(0), averageLength(0.0), totalLength(0.0) {}
+
+    void build(const CustomArrayV2<Job>& jobs) {
+        clear();
+        for (int i = 0; i < jobs.getSize(); i++) addJob(jobs[i]);
+        finish();
+    }
+
+    void build(const CustomLinkedList<Job>& jobs) {
+        clear();
+        for (const ListNode<Job>* node = jobs.getHead(); node != nullptr; node = node->next) addJob(node->data);
+        finish();
+    }
+
+    // Count one more job; the statistics don't depend on job order
+    void add(const Job& job) {
+        addJob(job);
+        finish();
+    }
+
+    // Okapi idf, kept positive for skills found in most jobs
+    double idf(const CustomString& skill) const {
+        const int* df = documentFrequency.find(skill);
+        double n = df ? *df : 0;
+        return log(1.0 + (documents - n + 0.5) / (n + 0.5));
+    }
+
+    // Snapshot section: the skills and their frequencies
+    void save(SnapshotSectionWriter& out) const {
+        CustomArray<const CustomString*> skills;
+        CustomArray<int> frequencies;
+        documentFrequency.forEach([&](const CustomString& skill, int df) {
+            skills.push_back(&skill);
+            frequencies.push_back(df);
+        });
+        out.putStrings(skills.size(), [&](int i) -> const CustomString& { return *skills[i]; });
+        out.putArray(frequencies);
+        out.putValue(documents);
+        out.putValue(totalLength);
+    }
+
+    // Load a saved section for a collection of jobCount jobs; false leaves
+    // the statistics empty
+    bool restore(SnapshotSectionReader& in, int jobCount) {
+        clear();
+        CustomArray<CustomString> skills;
+        CustomArray<int> frequencies;
+        bool ok = in.getStrings(skills) && in.getArray(frequencies) && in.getValue(documents)
+               && in.getValue(totalLength) && skills.size() == frequencies.size() && documents == jobCount;
+        documentFrequency.reserve(skills.size());
+        for (int i = 0; ok && i < skills.size(); i++) {
+            ok = frequencies[i] > 0 && frequencies[i] <= documents && !documentFrequency.contains(skills[i]);
+            documentFrequency.insert(skills[i], frequencies[i]);
+        }
+        if (!ok) {
+            clear();
+            finish();
+            return in.fail();
+        }
+        finish();
+        return true;
+    }
+
+private:
+    double totalLength;
+
+    void clear() {
+        documentFrequency.clear();
+        documents = 0;
+        totalLength = 0.0;
+    }
+
+    void addJob(const Job& job) {
+        documents++;
+        totalLength += job.lowerCaseSkills.size();
+        for (int k = 0; k < job.lowerCaseSkills.size(); k++) {
+            bool seen = false;
+            for (int p = 0; p < k && !seen; p++) {
+                seen = strcmp(job.lowerCaseSkills[p].c_str(), job.lowerCaseSkills[k].c_str()) == 0;
+            }
+            if (seen) continue;
+            int* df = documentFrequency.find(job.lowerCaseSkills[k]);
+            if (df) (*df)++;
+            else documentFrequency.insert(job.lowerCaseSkills[k], 1);
+        }
+    }
+
+    void finish() {
+        averageLength = documents > 0 ? totalLength / documents : 0.0;
+    }
+};
+
+// Okapi BM25 with the resume's skills as query terms and the job's skills as
+// the document. stats must describe the collection being ranked.
+struct BM25Scorer {
+    const SkillStatistics& stats;
+    double k1;
+    double b;
+    CustomArray<const CustomString*> terms;   // distinct resume skills
+    CustomArray<double> termWeights;          // idf * (k1 + 1)
+
+    explicit BM25Scorer(const SkillStatistics& skillStats, double k1Value = 1.2, double bValue = 0.75)
+        : stats(skillStats), k1(k1Value), b(bValue) {}
+
+    static const char* name() { return "BM25"; }
+    static const char* label() { return "match.bm25"; }
+
+    void prepare(const Resume& r) {
+        terms.clear();
+        termWeights.clear();
+        for (int j = 0; j < r.lowerCaseSkills.size(); j++) {
+            bool seen = false;
+            for (int p = 0; p < terms.size() && !seen; p++) {
+                seen = strcmp(terms[p]->c_str(), r.lowerCaseSkills[j].c_str()) == 0;
+            }
+            if (seen) continue;
+            terms.push_back(&r.lowerCaseSkills[j]);
+            termWeights.push_back(stats.idf(r.lowerCaseSkills[j]) * (k1 + 1.0));
+        }
+    }
+
+    double score(const Job& job) const {
+        int length = job.lowerCaseSkills.size();
+        if (length == 0 || terms.size() == 0) return 0.0;
+        double norm = k1 * (1.0 - b + b * length / (stats.averageLength > 0 ? stats.averageLength : 1.0));
+        double total = 0.0;
+        for (int t = 0; t < terms.size(); t++) {
+            int tf = 0;
+            for (int k = 0; k < length; k++) {
+                if (strcmp(job.lowerCaseSkills[k].c_str(), terms[t]->c_str()) == 0) tf++;
+            }
+            if (tf > 0) total += termWeights[t] * tf / (tf + norm);
+        }
+        return total;
+    }
+};
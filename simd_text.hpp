@@ -0,0 +1,242 @@
+#pragma once
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#define TEXT_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// ASCII text kernels used by the preprocessor: case folding, delimiter search
+// and word counting. The input is plain ASCII (non-ASCII bytes are left alone),
+// so none of these go through the locale-aware <cctype> functions.
+//
+// On x86 an SSE2 or AVX2 implementation is selected once at runtime; every
+// other platform uses the scalar versions.
+
+// ---------------------------------------------------------------------------
+// Scalar kernels (reference behaviour and fallback)
+// ---------------------------------------------------------------------------
+
+inline void asciiLowerCopyScalar(char* dst, const char* src, int len) {
+    for (int i = 0; i < len; i++) {
+        char c = src[i];
+        dst[i] = (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+}
+
+inline int findFirstOfScalar(const char* text, int len, char a, char b, char c) {
+    for (int i = 0; i < len; i++) {
+        char ch = text[i];
+        if (ch == a || ch == b || ch == c) return i;
+    }
+    return -1;
+}
+
+inline bool asciiAlpha(char c) {
+    char folded = static_cast<char>(c | 0x20);
+    return folded >= 'a' && folded <= 'z';
+}
+
+// Count runs of alphabetic characters; prevAlpha carries state across calls
+inline int countWordStartsScalar(const char* text, int len, bool& prevAlpha) {
+    int count = 0;
+    for (int i = 0; i < len; i++) {
+        bool alpha = asciiAlpha(text[i]);
+        if (alpha && !prevAlpha) count++;
+        prevAlpha = alpha;
+    }
+    return count;
+}
+
+#if defined(TEXT_KERNELS_X86)
+
+inline int countTrailingZeros(unsigned int x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(x);
+#else
+    int n = 0;
+    while ((x & 1U) == 0) { x >>= 1; n++; }
+    return n;
+#endif
+}
+
+inline int popCount(unsigned int x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcount(x);
+#else
+    int n = 0;
+    while (x) { x &= x - 1; n++; }
+    return n;
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// SSE2 kernels (16 bytes per step, always available on x86-64)
+// ---------------------------------------------------------------------------
+
+inline void asciiLowerCopySSE2(char* dst, const char* src, int len) {
+    const __m128i beforeA = _mm_set1_epi8('A' - 1);
+    const __m128i afterZ = _mm_set1_epi8('Z' + 1);
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    int i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        // Signed compares: bytes >= 0x80 are negative and never match
+        __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, beforeA), _mm_cmplt_epi8(v, afterZ));
+        v = _mm_or_si128(v, _mm_and_si128(upper, caseBit));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+    }
+    asciiLowerCopyScalar(dst + i, src + i, len - i);
+}
+
+inline int findFirstOfSSE2(const char* text, int len, char a, char b, char c) {
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    const __m128i vc = _mm_set1_epi8(c);
+    int i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, va), _mm_cmpeq_epi8(v, vb)),
+                                   _mm_cmpeq_epi8(v, vc));
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(hit));
+        if (mask != 0) return i + countTrailingZeros(mask);
+    }
+    int rest = findFirstOfScalar(text + i, len - i, a, b, c);
+    return rest < 0 ? -1 : i + rest;
+}
+
+inline int countWordStartsSSE2(const char* text, int len, bool& prevAlpha) {
+    const __m128i beforeA = _mm_set1_epi8('a' - 1);
+    const __m128i afterZ = _mm_set1_epi8('z' + 1);
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    int count = 0;
+    unsigned int carry = prevAlpha ? 1U : 0U;
+    int i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i)), caseBit);
+        __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(v, beforeA), _mm_cmplt_epi8(v, afterZ));
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(alpha));
+        // A word starts where a byte is alphabetic and the byte before it is not
+        unsigned int starts = mask & ~((mask << 1) | carry) & 0xFFFFU;
+        count += popCount(starts);
+        carry = (mask >> 15) & 1U;
+    }
+    prevAlpha = carry != 0;
+    return count + countWordStartsScalar(text + i, len - i, prevAlpha);
+}
+
+// ---------------------------------------------------------------------------
+// AVX2 kernels (32 bytes per step), compiled for AVX2 regardless of -m flags
+// and only called after a runtime CPU check
+// ---------------------------------------------------------------------------
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TEXT_KERNELS_AVX2 1
+
+__attribute__((target("avx2")))
+inline void asciiLowerCopyAVX2(char* dst, const char* src, int len) {
+    const __m256i beforeA = _mm256_set1_epi8('A' - 1);
+    const __m256i afterZ = _mm256_set1_epi8('Z' + 1);
+    const __m256i caseBit = _mm256_set1_epi8(0x20);
+    int i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(v, beforeA), _mm256_cmpgt_epi8(afterZ, v));
+        v = _mm256_or_si256(v, _mm256_and_si256(upper, caseBit));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), v);
+    }
+    asciiLowerCopySSE2(dst + i, src + i, len - i);
+}
+
+__attribute__((target("avx2")))
+inline int findFirstOfAVX2(const char* text, int len, char a, char b, char c) {
+    const __m256i va = _mm256_set1_epi8(a);
+    const __m256i vb = _mm256_set1_epi8(b);
+    const __m256i vc = _mm256_set1_epi8(c);
+    int i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+        __m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, va), _mm256_cmpeq_epi8(v, vb)),
+                                      _mm256_cmpeq_epi8(v, vc));
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(hit));
+        if (mask != 0) return i + countTrailingZeros(mask);
+    }
+    int rest = findFirstOfSSE2(text + i, len - i, a, b, c);
+    return rest < 0 ? -1 : i + rest;
+}
+
+__attribute__((target("avx2")))
+inline int countWordStartsAVX2(const char* text, int len, bool& prevAlpha) {
+    const __m256i beforeA = _mm256_set1_epi8('a' - 1);
+    const __m256i afterZ = _mm256_set1_epi8('z' + 1);
+    const __m256i caseBit = _mm256_set1_epi8(0x20);
+    int count = 0;
+    unsigned int carry = prevAlpha ? 1U : 0U;
+    int i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i)), caseBit);
+        __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(v, beforeA), _mm256_cmpgt_epi8(afterZ, v));
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(alpha));
+        unsigned int starts = mask & ~((mask << 1) | carry);
+        count += popCount(starts);
+        carry = mask >> 31;
+    }
+    prevAlpha = carry != 0;
+    return count + countWordStartsSSE2(text + i, len - i, prevAlpha);
+}
+#endif
+
+#endif // TEXT_KERNELS_X86
+
+// ---------------------------------------------------------------------------
+// Runtime dispatch
+// ---------------------------------------------------------------------------
+
+struct TextKernels {
+    const char* name;
+    void (*lowerCopy)(char* dst, const char* src, int len);
+    int (*findFirstOf)(const char* text, int len, char a, char b, char c);
+    int (*countWordStarts)(const char* text, int len, bool& prevAlpha);
+};
+
+inline TextKernels selectTextKernels() {
+    TextKernels kernels = {"scalar", asciiLowerCopyScalar, findFirstOfScalar, countWordStartsScalar};
+#if defined(TEXT_KERNELS_X86)
+    kernels.name = "sse2";
+    kernels.lowerCopy = asciiLowerCopySSE2;
+    kernels.findFirstOf = findFirstOfSSE2;
+    kernels.countWordStarts = countWordStartsSSE2;
+#if defined(TEXT_KERNELS_AVX2)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.name = "avx2";
+        kernels.lowerCopy = asciiLowerCopyAVX2;
+        kernels.findFirstOf = findFirstOfAVX2;
+        kernels.countWordStarts = countWordStartsAVX2;
+    }
+#endif
+#endif
+    return kernels;
+}
+
+inline const TextKernels& textKernels() {
+    static const TextKernels kernels = selectTextKernels();
+    return kernels;
+}
+
+// Convenience wrappers used by the preprocessor
+inline void asciiLowerCopy(char* dst, const char* src, int len) {
+    textKernels().lowerCopy(dst, src, len);
+}
+
+// Position of the first a/b/c byte in text[0, len), or -1
+inline int findFirstOf(const char* text, int len, char a, char b, char c) {
+    return textKernels().findFirstOf(text, len, a, b, c);
+}
+
+inline int countAsciiWords(const char* text, int len) {
+    bool prevAlpha = false;
+    return textKernels().countWordStarts(text, len, prevAlpha);
+}
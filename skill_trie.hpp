@@ -0,0 +1,291 @@
+#pragma once
+#include "model.hpp"
+#include "array.hpp"
+#include "sorting.hpp"
+#include "snapshot_section.hpp"
+#include <cctype>
+#include <cstring>
+
+using namespace std;
+
+// Ternary search tree over the valid skillset, for skill autocomplete and
+// typo-tolerant skill lookup.
+//
+// Each node holds one character and three child links: lo and hi to the
+// siblings that sort before and after it, eq to the next character of the
+// skills passing through it. Nodes live in one array and link by index, and
+// a node that ends a skill holds its id, the skill's position in validSkills.
+// Keys are lower-cased, so "Power BI" finds "power bi". build() inserts the
+// skills in median order of the sorted set, which keeps the lo/hi chains
+// balanced.
+//
+// complete() walks to the prefix node and lists the skills below it in
+// lexicographic order. fuzzy() carries one row of the edit-distance matrix
+// per depth down the tree and leaves a branch once every entry of the row is
+// above the bound, so it touches only prefixes within reach of the query;
+// "powerbi" finds "power bi" at distance 1.
+
+const int SKILL_TRIE_NONE = -1;
+
+class SkillTrie {
+private:
+    struct Node {
+        char c;
+        int lo, eq, hi;
+        int skillId;      // SKILL_TRIE_NONE unless a skill ends here
+    };
+
+    CustomArray<Node> nodes;
+    int root;
+    int skillCount;
+    int longestSkill;
+
+    static char lower(char c) {
+        return static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+
+    int newNode(char c) {
+        Node node;
+        node.c = c;
+        node.lo = node.eq = node.hi = SKILL_TRIE_NONE;
+        node.skillId = SKILL_TRIE_NONE;
+        nodes.push_back(node);
+        return nodes.size() - 1;
+    }
+
+    // lo, eq or hi link of node for direction -1, 0 or 1
+    int& child(int node, int direction) {
+        return direction < 0 ? nodes[node].lo : (direction > 0 ? nodes[node].hi : nodes[node].eq);
+    }
+
+    // Node of the last character of text, SKILL_TRIE_NONE if no skill starts with it
+    int findNode(const char* text) const {
+        int current = root;
+        while (current != SKILL_TRIE_NONE) {
+            char c = lower(*text);
+            const Node& node = nodes[current];
+            if (c < node.c) current = node.lo;
+            else if (c > node.c) current = node.hi;
+            else if (*++text == '\0') return current;
+            else current = node.eq;
+        }
+        return SKILL_TRIE_NONE;
+    }
+
+    // Skills at and below node in lexicographic order, up to limit
+    void collect(int node, int limit, CustomArray<int>& out) const {
+        if (node == SKILL_TRIE_NONE || out.size() >= limit) return;
+        collect(nodes[node].lo, limit, out);
+        if (nodes[node].skillId != SKILL_TRIE_NONE && out.size() < limit) out.push_back(nodes[node].skillId);
+        collect(nodes[node].eq, limit, out);
+        collect(nodes[node].hi, limit, out);
+    }
+
+    // rows holds one edit-distance row of width + 1 entries per depth;
+    // row depth is the distance of query to the path above node
+    void fuzzyVisit(int node, int depth, const char* query, int width, int maxEdits, CustomArray<int>& rows,
+                    CustomArray<int>& ids, CustomArray<int>& distances) const {
+        while (node != SKILL_TRIE_NONE) {
+            const Node& current = nodes[node];
+            fuzzyVisit(current.lo, depth, query, width, maxEdits, rows, ids, distances);
+
+            const int* above = &rows[depth * (width + 1)];
+            int* row = &rows[(depth + 1) * (width + 1)];
+            row[0] = above[0] + 1;
+            int best = row[0];
+            for (int j = 1; j <= width; j++) {
+                int cost = query[j - 1] == current.c ? 0 : 1;
+                int value = above[j - 1] + cost;
+                if (above[j] + 1 < value) value = above[j] + 1;
+                if (row[j - 1] + 1 < value) value = row[j - 1] + 1;
+                row[j] = value;
+                if (value < best) best = value;
+            }
+            if (current.skillId != SKILL_TRIE_NONE && row[width] <= maxEdits) {
+                ids.push_back(current.skillId);
+                distances.push_back(row[width]);
+            }
+            if (best <= maxEdits) fuzzyVisit(current.eq, depth + 1, query, width, maxEdits, rows, ids, distances);
+
+            node = current.hi;   // same depth, so loop instead of recursing
+        }
+    }
+
+public:
+    SkillTrie() : root(SKILL_TRIE_NONE), skillCount(0), longestSkill(0) {}
+
+    void clear() {
+        nodes.clear();
+        root = SKILL_TRIE_NONE;
+        skillCount = 0;
+        longestSkill = 0;
+    }
+
+    // Add skill under id; a skill added twice keeps the lower id
+    void insert(const CustomString& skill, int id) {
+        const char* text = skill.c_str();
+        if (text == nullptr || *text == '\0') return;
+        // Links are held as (parent, direction) since newNode may move the array
+        int parent = SKILL_TRIE_NONE;
+        int direction = 0;
+        while (true) {
+            char c = lower(*text);
+            int current = parent == SKILL_TRIE_NONE ? root : child(parent, direction);
+            if (current == SKILL_TRIE_NONE) {
+                current = newNode(c);
+                if (parent == SKILL_TRIE_NONE) root = current;
+                else child(parent, direction) = current;
+            }
+            parent = current;
+            direction = c < nodes[current].c ? -1 : (c > nodes[current].c ? 1 : 0);
+            if (direction == 0 && *++text == '\0') {
+                if (nodes[current].skillId == SKILL_TRIE_NONE) {
+                    skillCount++;
+                    if (skill.size() > longestSkill) longestSkill = skill.size();
+                } else if (nodes[current].skillId < id) {
+                    return;
+                }
+                nodes[current].skillId = id;
+                return;
+            }
+        }
+    }
+
+    // Rebuild from skills, ids being positions in skills
+    void build(const CustomArray<CustomString>& skills) {
+        clear();
+        if (skills.size() == 0) return;
+        CustomArray<int> order;
+        for (int i = 0; i < skills.size(); i++) order.push_back(i);
+        parallelIntroSort(&order[0], order.size(), [&](int a, int b) {
+            return strcmp(skills[a].c_str(), skills[b].c_str()) < 0;
+        }, "skill_trie.sort");
+
+        // Medians first: an explicit stack of [low, high] ranges
+        nodes.reserve(skills.size() * 4);
+        CustomArray<int> ranges;
+        ranges.push_back(0);
+        ranges.push_back(order.size() - 1);
+        while (ranges.size() > 0) {
+            int high = ranges[ranges.size() - 1];
+            int low = ranges[ranges.size() - 2];
+            ranges.resize(ranges.size() - 2);
+            if (low > high) continue;
+            int mid = low + (high - low) / 2;
+            insert(skills[order[mid]], order[mid]);
+            ranges.push_back(low);
+            ranges.push_back(mid - 1);
+            ranges.push_back(mid + 1);
+            ranges.push_back(high);
+        }
+    }
+
+    // Id of the skill equal to text ignoring case, SKILL_TRIE_NONE if none
+    int find(const CustomString& text) const {
+        if (text.c_str() == nullptr || text.size() == 0) return SKILL_TRIE_NONE;
+        int node = findNode(text.c_str());
+        return node == SKILL_TRIE_NONE ? SKILL_TRIE_NONE : nodes[node].skillId;
+    }
+
+    // Ids of up to limit skills starting with prefix, in lexicographic order
+    void complete(const CustomString& prefix, int limit, CustomArray<int>& ids) const {
+        ids.clear();
+        if (limit <= 0) return;
+        if (prefix.c_str() == nullptr || prefix.size() == 0) {
+            collect(root, limit, ids);
+            return;
+        }
+        int node = findNode(prefix.c_str());
+        if (node == SKILL_TRIE_NONE) return;
+        if (nodes[node].skillId != SKILL_TRIE_NONE) ids.push_back(nodes[node].skillId);
+        collect(nodes[node].eq, limit, ids);
+    }
+
+    // Ids of the skills within maxEdits insertions, deletions or substitutions
+    // of text, closest first, lexicographic within a distance
+    void fuzzy(const CustomString& text, int maxEdits, CustomArray<int>& ids, CustomArray<int>& distances) const {
+        ids.clear();
+        distances.clear();
+        if (text.c_str() == nullptr || root == SKILL_TRIE_NONE) return;
+        int width = text.size();
+        CustomArray<char> query;
+        query.resize(width + 1);
+        for (int i = 0; i < width; i++) query[i] = lower(text.c_str()[i]);
+
+        CustomArray<int> rows;
+        rows.resize((longestSkill + 1) * (width + 1));
+        for (int j = 0; j <= width; j++) rows[j] = j;
+        fuzzyVisit(root, 0, &query[0], width, maxEdits, rows, ids, distances);
+
+        // Visit order is lexicographic; one pass per distance keeps it within ties
+        CustomArray<int> visited = ids;
+        CustomArray<int> visitedDistances = distances;
+        ids.clear();
+        distances.clear();
+        for (int distance = 0; distance <= maxEdits; distance++) {
+            for (int i = 0; i < visited.size(); i++) {
+                if (visitedDistances[i] != distance) continue;
+                ids.push_back(visited[i]);
+                distances.push_back(distance);
+            }
+        }
+    }
+
+    // Exact match, else the closest skill within maxEdits, else SKILL_TRIE_NONE
+    int resolve(const CustomString& text, int maxEdits) const {
+        int id = find(text);
+        if (id != SKILL_TRIE_NONE || maxEdits <= 0) return id;
+        CustomArray<int> ids;
+        CustomArray<int> distances;
+        fuzzy(text, maxEdits, ids, distances);
+        return ids.size() > 0 ? ids[0] : SKILL_TRIE_NONE;
+    }
+
+    // Snapshot section: the node array as is
+    void save(SnapshotSectionWriter& out) const {
+        out.putArray(nodes);
+        out.putValue(root);
+        out.putValue(longestSkill);
+    }
+
+    // Load a saved section for a skillset of skills entries. Every link must
+    // point to a later node that nothing else links to, so the tree has no
+    // cycles, and no path may be longer than longestSkill, which sizes the
+    // fuzzy() rows. On false the trie is left empty.
+    bool restore(SnapshotSectionReader& in, int skills) {
+        clear();
+        bool ok = in.getArray(nodes) && in.getValue(root) && in.getValue(longestSkill)
+               && (nodes.size() == 0 ? root == SKILL_TRIE_NONE : root == 0)
+               && longestSkill >= 0 && longestSkill <= nodes.size();
+        CustomArray<int> depth;              // eq links above each node, SKILL_TRIE_NONE if unlinked
+        depth.resize(nodes.size());
+        for (int i = 0; ok && i < nodes.size(); i++) depth[i] = i == 0 ? 0 : SKILL_TRIE_NONE;
+        for (int i = 0; ok && i < nodes.size(); i++) {
+            const Node& node = nodes[i];
+            int links[3] = {node.lo, node.eq, node.hi};
+            for (int k = 0; ok && k < 3; k++) {
+                int next = links[k];
+                if (next == SKILL_TRIE_NONE) continue;
+                ok = next > i && next < nodes.size() && depth[next] == SKILL_TRIE_NONE && depth[i] != SKILL_TRIE_NONE;
+                if (ok) depth[next] = depth[i] + (k == 1 ? 1 : 0);
+            }
+            ok = ok && depth[i] < longestSkill && node.skillId >= SKILL_TRIE_NONE && node.skillId < skills;
+            if (node.skillId != SKILL_TRIE_NONE) skillCount++;
+        }
+        if (!ok) {
+            clear();
+            return in.fail();
+        }
+        return true;
+    }
+
+    int getSkillCount() const { return skillCount; }
+    int getNodeCount() const { return nodes.size(); }
+    size_t getMemoryBytes() const { return nodes.size() * sizeof(Node); }
+};
+
+// Typo budget for a skill query of length characters: one edit for short
+// skills like "git", where two would reach unrelated ones, two otherwise
+inline int skillEditBound(int length) {
+    return length <= 4 ? 1 : 2;
+}
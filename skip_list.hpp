@@ -0,0 +1,180 @@
+#pragma once
+#include "model.hpp"
+#include "linkedlist.hpp"
+#include "query.hpp"
+#include "index_keys.hpp"
+#include <cstring>
+
+using namespace std;
+
+// Ordered skip-list index over the nodes of a CustomLinkedList.
+//
+// Entries point at ListNodes, which never move: swapNodes relinks them and
+// push_back adds new ones, so an index stays valid across sorts and only needs
+// an insert per ingested row. Entries are ordered by (key, id); each has a
+// random height (P = 1/4), so insert, remove and lower-bound lookups take
+// O(log N) expected pointer hops and a range scan walks level 0 in key order.
+//
+// KeyTraits (see index_keys.hpp) supplies the key of a record and a
+// three-way compare; keys are stored in the entry.
+
+const int SKIP_LIST_MAX_LEVEL = 16;   // enough for 4^16 entries
+
+template<typename T, typename KeyTraits>
+class SkipListIndex {
+public:
+    typedef typename KeyTraits::Key Key;
+
+    struct Entry {
+        Key key;
+        int id;
+        ListNode<T>* node;
+        int level;
+        Entry** forward;   // level pointers, forward[0] is the next entry
+
+        Entry(Key entryKey, int entryId, ListNode<T>* listNode, int height)
+            : key(entryKey), id(entryId), node(listNode), level(height), forward(new Entry*[height]) {
+            for (int i = 0; i < height; i++) forward[i] = nullptr;
+        }
+
+        ~Entry() { delete[] forward; }
+
+        Entry(const Entry&) = delete;
+        Entry& operator=(const Entry&) = delete;
+    };
+
+private:
+    Entry* head;        // sentinel of full height, holds no record
+    int level;          // levels in use
+    int size;
+    unsigned long long randomState;
+
+    int randomLevel() {
+        randomState ^= randomState << 13;
+        randomState ^= randomState >> 7;
+        randomState ^= randomState << 17;
+        int height = 1;
+        unsigned long long bits = randomState;
+        while (height < SKIP_LIST_MAX_LEVEL && (bits & 3) == 0) {
+            height++;
+            bits >>= 2;
+        }
+        return height;
+    }
+
+    // Negative when entry orders before (key, id)
+    static int compareEntry(const Entry* entry, Key key, int id) {
+        int cmp = KeyTraits::compare(entry->key, key);
+        if (cmp != 0) return cmp;
+        return entry->id < id ? -1 : (entry->id > id ? 1 : 0);
+    }
+
+    // Fill update[i] with the last entry before (key, id) on level i
+    void findPredecessors(Key key, int id, Entry** update) const {
+        Entry* current = head;
+        int hops = 0;
+        for (int i = level - 1; i >= 0; i--) {
+            while (current->forward[i] != nullptr && compareEntry(current->forward[i], key, id) < 0) {
+                current = current->forward[i];
+                hops++;
+            }
+            update[i] = current;
+        }
+        INSTRUMENT_COUNT(COUNTER_NODE_HOPS, hops);
+    }
+
+public:
+    SkipListIndex() : level(1), size(0), randomState(0x2545f4914f6cdd1dULL) {
+        head = new Entry(Key(), 0, nullptr, SKIP_LIST_MAX_LEVEL);
+    }
+
+    ~SkipListIndex() {
+        clear();
+        delete head;
+    }
+
+    SkipListIndex(const SkipListIndex&) = delete;
+    SkipListIndex& operator=(const SkipListIndex&) = delete;
+
+    void clear() {
+        Entry* current = head->forward[0];
+        while (current != nullptr) {
+            Entry* next = current->forward[0];
+            delete current;
+            current = next;
+        }
+        for (int i = 0; i < SKIP_LIST_MAX_LEVEL; i++) head->forward[i] = nullptr;
+        level = 1;
+        size = 0;
+    }
+
+    // Index every node of list
+    void build(const CustomLinkedList<T>& list) {
+        clear();
+        for (ListNode<T>* node = list.getHead(); node != nullptr; node = node->next) insert(node);
+    }
+
+    // Add node; false if a record with the same key and id is already indexed
+    bool insert(ListNode<T>* node) {
+        Key key = KeyTraits::of(node->data);
+        Entry* update[SKIP_LIST_MAX_LEVEL];
+        findPredecessors(key, node->data.id, update);
+        Entry* next = update[0]->forward[0];
+        if (next != nullptr && compareEntry(next, key, node->data.id) == 0) return false;
+
+        int height = randomLevel();
+        for (int i = level; i < height; i++) update[i] = head;
+        if (height > level) level = height;
+        Entry* entry = new Entry(key, node->data.id, node, height);
+        INSTRUMENT_COUNT(COUNTER_ALLOCATIONS, 1);
+        for (int i = 0; i < height; i++) {
+            entry->forward[i] = update[i]->forward[i];
+            update[i]->forward[i] = entry;
+        }
+        size++;
+        return true;
+    }
+
+    // Drop the entry of record (its key must be the one it was indexed under)
+    bool remove(const T& record) {
+        Key key = KeyTraits::of(record);
+        Entry* update[SKIP_LIST_MAX_LEVEL];
+        findPredecessors(key, record.id, update);
+        Entry* target = update[0]->forward[0];
+        if (target == nullptr || compareEntry(target, key, record.id) != 0) return false;
+        for (int i = 0; i < target->level; i++) update[i]->forward[i] = target->forward[i];
+        delete target;
+        while (level > 1 && head->forward[level - 1] == nullptr) level--;
+        size--;
+        return true;
+    }
+
+    // First entry with a key >= key, nullptr past the end
+    const Entry* lowerBound(Key key) const {
+        Entry* update[SKIP_LIST_MAX_LEVEL];
+        findPredecessors(key, -2147483647 - 1, update);
+        return update[0]->forward[0];
+    }
+
+    // Records with exactly key, in id order
+    void find(Key key, HandleQueryResult<T>& out) const {
+        out.clear();
+        for (const Entry* entry = lowerBound(key); entry != nullptr && KeyTraits::compare(entry->key, key) == 0; entry = entry->forward[0]) {
+            out.items.push_back(&entry->node->data);
+        }
+    }
+
+    // Records with low <= key <= high in key order
+    void range(Key low, Key high, HandleQueryResult<T>& out) const {
+        out.clear();
+        for (const Entry* entry = lowerBound(low); entry != nullptr && KeyTraits::compare(entry->key, high) <= 0; entry = entry->forward[0]) {
+            out.items.push_back(&entry->node->data);
+        }
+    }
+
+    // First entry in key order, follow forward[0] for the rest
+    const Entry* first() const { return head->forward[0]; }
+
+    int getSize() const { return size; }
+    int getLevel() const { return level; }
+};
@@ -0,0 +1,578 @@
+#pragma once
+#include "model.hpp"
+#include "hashmap.hpp"
+#include "matching.hpp"
+#include "snapshot_section.hpp"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// Binary snapshot of the preprocessed storage state.
+//
+// Layout (native endianness, every section 8-byte aligned):
+//   SnapshotHeader
+//   uint32 stringOffsets[stringCount]    offsets into the string bytes
+//   char   stringBytes[stringBytes]      interned, null-terminated strings
+//   SnapshotJobRecord    jobs[jobCount]
+//   SnapshotResumeRecord resumes[resumeCount]
+//   uint32 stringRefs[refCount]          skill lists, as string table indices
+//   SnapshotPendingRecord pending[pendingCount]  rejected resume skills
+//   int32  pendingIds[pendingIdCount]    resume ids per pending skill
+//   SnapshotIndexEntry indexes[indexCount]  kind and place of each index section
+//   index sections, in directory order  (SnapshotSectionWriter layout)
+//
+// Every string (titles, categories, skills, descriptions) is stored once in
+// the string table, so repeated skills cost four bytes per reference.
+//
+// Records carry their keyword masks, valid for the keyword list with the
+// header's fingerprint. The index sections hold what the storage built over
+// the records (id positions, buckets, skill trie and statistics, BM25
+// postings, LSH bands, ...) as flat arrays, so a warm start copies them back
+// instead of rebuilding; a missing or invalid section is rebuilt as after a
+// CSV load. Records are still decoded into owning Jobs and Resumes, one
+// buffer per string, and the versioned store keeps its own copy of each.
+
+const char SNAPSHOT_MAGIC[8] = {'J', 'M', 'S', 'N', 'A', 'P', '\0', '\0'};
+const uint32_t SNAPSHOT_VERSION = 3;
+
+// Index section kinds
+const uint32_t SNAPSHOT_INDEX_JOB_POSITIONS = 1;       // job id -> array position
+const uint32_t SNAPSHOT_INDEX_RESUME_POSITIONS = 2;
+const uint32_t SNAPSHOT_INDEX_SKILL_TRIE = 3;
+const uint32_t SNAPSHOT_INDEX_SKILL_STATISTICS = 4;
+const uint32_t SNAPSHOT_INDEX_WEIGHTED_COLUMNS = 5;
+const uint32_t SNAPSHOT_INDEX_TITLE_TRIGRAMS = 6;
+const uint32_t SNAPSHOT_INDEX_JOB_BUCKETS = 7;
+const uint32_t SNAPSHOT_INDEX_DESCRIPTIONS = 8;        // BM25 postings
+const uint32_t SNAPSHOT_INDEX_LSH = 9;                 // MinHash band entries
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t fileSize;
+    uint64_t stringCount;
+    uint64_t stringBytes;
+    uint64_t jobCount;
+    uint64_t resumeCount;
+    uint64_t refCount;
+    uint32_t validSkillsBegin;
+    uint32_t validSkillsCount;
+    uint64_t pendingCount;
+    uint64_t pendingIdCount;
+    int64_t jobSourceOffset;     // CSV bytes consumed, for incremental ingestion
+    int64_t resumeSourceOffset;
+    uint64_t keywordFingerprint; // keyword list the record masks are for, 0 = no masks
+    uint64_t indexCount;
+};
+
+struct SnapshotJobRecord {
+    int32_t id;
+    uint32_t title;
+    uint32_t lowerCaseTitle;
+    uint32_t fullDescription;
+    uint32_t jobCategory;
+    int32_t skillCount;
+    int32_t titleLength;
+    int32_t priority;
+    int32_t experienceLevel;
+    uint32_t skillsBegin;
+    uint32_t skillsCount;
+    uint32_t lowerSkillsBegin;
+    uint32_t lowerSkillsCount;
+    uint32_t reserved;
+    uint64_t keywordMask;
+};
+
+struct SnapshotResumeRecord {
+    int32_t id;
+    uint32_t fullDescription;
+    int32_t skillCount;
+    uint32_t skillsBegin;
+    uint32_t skillsCount;
+    uint32_t lowerSkillsBegin;
+    uint32_t lowerSkillsCount;
+    uint32_t reserved;
+    uint64_t keywordMask;
+};
+
+struct SnapshotPendingRecord {
+    uint32_t skill;
+    uint32_t idsBegin;
+    uint32_t idsCount;
+    uint32_t reserved;
+};
+
+struct SnapshotIndexEntry {
+    uint32_t kind;
+    uint32_t reserved;
+    uint64_t offset;             // from the start of the file
+    uint64_t bytes;
+};
+
+// Collects preprocessed records and writes them out as one snapshot file
+class SnapshotWriter {
+private:
+    CustomHashMap<CustomString, uint32_t> stringIds;
+    CustomArray<uint32_t> stringOffsets;
+    CustomArray<char> stringBytes;
+    CustomArray<SnapshotJobRecord> jobs;
+    CustomArray<SnapshotResumeRecord> resumes;
+    CustomArray<uint32_t> refs;
+    CustomArray<SnapshotPendingRecord> pending;
+    CustomArray<int32_t> pendingIds;
+    uint32_t validSkillsBegin;
+    uint32_t validSkillsCount;
+    int64_t jobSourceOffset;
+    int64_t resumeSourceOffset;
+    const KeywordMatcher* keywordMatcher;
+    CustomArray<SnapshotIndexEntry> indexes;
+    CustomArray<char> indexBytes;                 // the sections back to back, each padded
+
+    uint32_t intern(const CustomString& str) {
+        CustomString key = str.c_str() ? str : CustomString("");
+        uint32_t* existing = stringIds.find(key);
+        if (existing) return *existing;
+
+        uint32_t id = static_cast<uint32_t>(stringOffsets.size());
+        stringOffsets.push_back(static_cast<uint32_t>(stringBytes.size()));
+        for (int i = 0; i < key.size(); i++) {
+            stringBytes.push_back(key.c_str()[i]);
+        }
+        stringBytes.push_back('\0');
+        stringIds.insert(key, id);
+        return id;
+    }
+
+    uint32_t appendRefs(const CustomArray<CustomString>& list) {
+        uint32_t begin = static_cast<uint32_t>(refs.size());
+        for (int i = 0; i < list.size(); i++) {
+            refs.push_back(intern(list[i]));
+        }
+        return begin;
+    }
+
+    static bool writePadded(ofstream& out, const void* data, uint64_t bytes) {
+        if (bytes > 0) out.write(static_cast<const char*>(data), bytes);
+        static const char zeros[8] = {0};
+        uint64_t padding = alignSnapshotOffset(bytes) - bytes;
+        if (padding > 0) out.write(zeros, padding);
+        return out.good();
+    }
+
+    template<typename T>
+    static bool writeArray(ofstream& out, const CustomArray<T>& arr) {
+        if (arr.empty()) return true;
+        return writePadded(out, &arr[0], static_cast<uint64_t>(arr.size()) * sizeof(T));
+    }
+
+public:
+    SnapshotWriter() : validSkillsBegin(0), validSkillsCount(0), jobSourceOffset(0), resumeSourceOffset(0),
+                       keywordMatcher(nullptr) {}
+
+    // Store each record's keyword mask for matcher (scanning records it has
+    // not masked yet); set before adding records
+    void setKeywordMatcher(const KeywordMatcher& matcher) {
+        keywordMatcher = &matcher;
+    }
+
+    void addJob(const Job& job) {
+        SnapshotJobRecord rec;
+        memset(&rec, 0, sizeof(rec));
+        rec.id = job.id;
+        rec.title = intern(job.jobTitle);
+        rec.lowerCaseTitle = intern(job.lowerCaseTitle);
+        rec.fullDescription = intern(job.fullDescription);
+        rec.jobCategory = intern(job.jobCategory);
+        rec.skillCount = job.skillCount;
+        rec.titleLength = job.titleLength;
+        rec.priority = job.priority;
+        rec.experienceLevel = job.experienceLevel;
+        rec.skillsBegin = appendRefs(job.skills);
+        rec.skillsCount = job.skills.size();
+        rec.lowerSkillsBegin = appendRefs(job.lowerCaseSkills);
+        rec.lowerSkillsCount = job.lowerCaseSkills.size();
+        rec.keywordMask = keywordMatcher ? keywordMatcher->maskFor(job) : 0;
+        jobs.push_back(rec);
+    }
+
+    void addResume(const Resume& resume) {
+        SnapshotResumeRecord rec;
+        memset(&rec, 0, sizeof(rec));
+        rec.id = resume.id;
+        rec.fullDescription = intern(resume.fullDescription);
+        rec.skillCount = resume.skillCount;
+        rec.skillsBegin = appendRefs(resume.resumeSkills);
+        rec.skillsCount = resume.resumeSkills.size();
+        rec.lowerSkillsBegin = appendRefs(resume.lowerCaseSkills);
+        rec.lowerSkillsCount = resume.lowerCaseSkills.size();
+        rec.keywordMask = keywordMatcher ? keywordMatcher->maskFor(resume) : 0;
+        resumes.push_back(rec);
+    }
+
+    void setValidSkills(const CustomArray<CustomString>& validSkills) {
+        validSkillsBegin = appendRefs(validSkills);
+        validSkillsCount = validSkills.size();
+    }
+
+    // Skills rejected during resume filtering, so ingestion can resume after a warm start
+    void setPendingSkills(const CustomHashMap<CustomString, CustomArray<int> >& pendingSkills) {
+        pendingSkills.forEach([this](const CustomString& skill, const CustomArray<int>& ids) {
+            SnapshotPendingRecord rec;
+            memset(&rec, 0, sizeof(rec));
+            rec.skill = intern(skill);
+            rec.idsBegin = static_cast<uint32_t>(pendingIds.size());
+            rec.idsCount = ids.size();
+            for (int i = 0; i < ids.size(); i++) {
+                pendingIds.push_back(ids[i]);
+            }
+            pending.push_back(rec);
+        });
+    }
+
+    void setSourceOffsets(long long jobOffset, long long resumeOffset) {
+        jobSourceOffset = jobOffset;
+        resumeSourceOffset = resumeOffset;
+    }
+
+    // Add an index section: index.save(section) writes its body
+    template<typename Index>
+    void addIndex(uint32_t kind, const Index& index) {
+        SnapshotSectionWriter section;
+        index.save(section);
+        SnapshotIndexEntry entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.kind = kind;
+        entry.offset = indexBytes.size();       // made absolute in write
+        entry.bytes = section.getSize();
+        indexes.push_back(entry);
+        int at = indexBytes.size();
+        indexBytes.resize(at + section.getSize());
+        if (section.getSize() > 0) memcpy(&indexBytes[at], section.getData(), section.getSize());
+    }
+
+    bool write(const char* filename) {
+        ofstream out(filename, ios::binary | ios::trunc);
+        if (!out.is_open()) {
+            cerr << "Error: Could not create snapshot " << filename << endl;
+            return false;
+        }
+
+        SnapshotHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.version = SNAPSHOT_VERSION;
+        header.headerSize = sizeof(SnapshotHeader);
+        header.stringCount = stringOffsets.size();
+        header.stringBytes = stringBytes.size();
+        header.jobCount = jobs.size();
+        header.resumeCount = resumes.size();
+        header.refCount = refs.size();
+        header.validSkillsBegin = validSkillsBegin;
+        header.validSkillsCount = validSkillsCount;
+        header.pendingCount = pending.size();
+        header.pendingIdCount = pendingIds.size();
+        header.jobSourceOffset = jobSourceOffset;
+        header.resumeSourceOffset = resumeSourceOffset;
+        header.keywordFingerprint = keywordMatcher ? keywordMatcher->getFingerprint() : 0;
+        header.indexCount = indexes.size();
+        uint64_t indexStart = alignSnapshotOffset(sizeof(SnapshotHeader))
+                        + alignSnapshotOffset(header.stringCount * sizeof(uint32_t))
+                        + alignSnapshotOffset(header.stringBytes)
+                        + alignSnapshotOffset(header.jobCount * sizeof(SnapshotJobRecord))
+                        + alignSnapshotOffset(header.resumeCount * sizeof(SnapshotResumeRecord))
+                        + alignSnapshotOffset(header.refCount * sizeof(uint32_t))
+                        + alignSnapshotOffset(header.pendingCount * sizeof(SnapshotPendingRecord))
+                        + alignSnapshotOffset(header.pendingIdCount * sizeof(int32_t))
+                        + alignSnapshotOffset(header.indexCount * sizeof(SnapshotIndexEntry));
+        for (int i = 0; i < indexes.size(); i++) indexes[i].offset += indexStart;
+        header.fileSize = indexStart + indexBytes.size();
+
+        bool ok = writePadded(out, &header, sizeof(header))
+               && writeArray(out, stringOffsets)
+               && writeArray(out, stringBytes)
+               && writeArray(out, jobs)
+               && writeArray(out, resumes)
+               && writeArray(out, refs)
+               && writeArray(out, pending)
+               && writeArray(out, pendingIds)
+               && writeArray(out, indexes)
+               && writeArray(out, indexBytes);
+        out.close();
+
+        if (!ok) {
+            cerr << "Error: Failed while writing snapshot " << filename << endl;
+            return false;
+        }
+        cout << "Snapshot written: " << jobs.size() << " jobs, " << resumes.size() << " resumes, "
+             << stringOffsets.size() << " interned strings, " << indexes.size() << " indexes ("
+             << header.fileSize << " bytes)" << endl;
+        return true;
+    }
+};
+
+// Read-only view of a snapshot file, memory-mapped where the platform allows
+class SnapshotReader {
+private:
+    const char* base;
+    uint64_t mappedSize;
+    bool mapped;
+    char* ownedBuffer;
+
+    const SnapshotHeader* header;
+    const uint32_t* stringOffsets;
+    const char* stringBytes;
+    const SnapshotJobRecord* jobs;
+    const SnapshotResumeRecord* resumes;
+    const uint32_t* refs;
+    const SnapshotPendingRecord* pending;
+    const int32_t* pendingIds;
+    const SnapshotIndexEntry* indexes;
+
+    bool mapFile(const char* filename) {
+#if !defined(_WIN32)
+        int fd = ::open(filename, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+        void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) return false;
+        base = static_cast<const char*>(addr);
+        mappedSize = st.st_size;
+        mapped = true;
+        return true;
+#else
+        ifstream in(filename, ios::binary | ios::ate);
+        if (!in.is_open()) return false;
+        streamsize size = in.tellg();
+        if (size <= 0) return false;
+        in.seekg(0);
+        ownedBuffer = new char[size];
+        if (!in.read(ownedBuffer, size)) {
+            delete[] ownedBuffer;
+            ownedBuffer = nullptr;
+            return false;
+        }
+        base = ownedBuffer;
+        mappedSize = size;
+        return true;
+#endif
+    }
+
+    void unmap() {
+#if !defined(_WIN32)
+        if (mapped && base) munmap(const_cast<char*>(base), mappedSize);
+#endif
+        delete[] ownedBuffer;
+        ownedBuffer = nullptr;
+        base = nullptr;
+        mappedSize = 0;
+        mapped = false;
+        header = nullptr;
+    }
+
+    // Point section at offset and move offset past count elements of
+    // elementSize bytes, padded; false if they run past the mapping. The
+    // count is checked against the bytes left before multiplying, so a
+    // corrupt count cannot overflow.
+    template<typename T>
+    bool nextSection(uint64_t& offset, uint64_t count, uint64_t elementSize, const T*& section) const {
+        uint64_t left = mappedSize - offset;
+        if (count > left / elementSize || alignSnapshotOffset(count * elementSize) > left) return false;
+        section = reinterpret_cast<const T*>(base + offset);
+        offset += alignSnapshotOffset(count * elementSize);
+        return true;
+    }
+
+    // Every string must start inside the string bytes, after the one before
+    // it, and end in the null the writer puts there; stringAt relies on it
+    bool validStringTable() const {
+        if (header->stringCount > UINT32_MAX) return false;
+        for (uint64_t i = 0; i < header->stringCount; i++) {
+            uint64_t begin = stringOffsets[i];
+            uint64_t end = (i + 1 < header->stringCount) ? stringOffsets[i + 1] : header->stringBytes;
+            if (begin >= end || end > header->stringBytes || end - begin - 1 > INT32_MAX) return false;
+            if (stringBytes[end - 1] != '\0') return false;
+        }
+        return true;
+    }
+
+    CustomString stringAt(uint32_t index) const {
+        if (index >= header->stringCount) return CustomString("");
+        uint64_t begin = stringOffsets[index];
+        uint64_t end = (index + 1 < header->stringCount) ? stringOffsets[index + 1] : header->stringBytes;
+        return CustomString(stringBytes + begin, static_cast<int>(end - begin - 1));
+    }
+
+    CustomArray<CustomString> stringList(uint32_t begin, uint32_t count) const {
+        CustomArray<CustomString> list;
+        if (static_cast<uint64_t>(begin) + count > header->refCount) return list;
+        // Move each string into place; push_back would copy it a second time
+        list.resize(count);
+        for (uint32_t i = 0; i < count; i++) {
+            list[i] = stringAt(refs[begin + i]);
+        }
+        return list;
+    }
+
+public:
+    SnapshotReader() : base(nullptr), mappedSize(0), mapped(false), ownedBuffer(nullptr),
+                       header(nullptr), stringOffsets(nullptr), stringBytes(nullptr),
+                       jobs(nullptr), resumes(nullptr), refs(nullptr), pending(nullptr), pendingIds(nullptr),
+                       indexes(nullptr) {}
+
+    ~SnapshotReader() {
+        unmap();
+    }
+
+    // Map the file and validate magic, version and section sizes
+    bool open(const char* filename) {
+        unmap();
+        if (!mapFile(filename)) {
+            cerr << "Error: Could not open snapshot " << filename << endl;
+            return false;
+        }
+
+        if (mappedSize < sizeof(SnapshotHeader)) {
+            cerr << "Error: Snapshot " << filename << " is truncated" << endl;
+            unmap();
+            return false;
+        }
+        header = reinterpret_cast<const SnapshotHeader*>(base);
+        if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 ||
+            header->headerSize != sizeof(SnapshotHeader)) {
+            cerr << "Error: " << filename << " is not a snapshot file" << endl;
+            unmap();
+            return false;
+        }
+        if (header->version != SNAPSHOT_VERSION) {
+            cerr << "Error: Snapshot version " << header->version << " is not supported (expected "
+                 << SNAPSHOT_VERSION << ")" << endl;
+            unmap();
+            return false;
+        }
+        if (header->fileSize != mappedSize) {
+            cerr << "Error: Snapshot " << filename << " size mismatch" << endl;
+            unmap();
+            return false;
+        }
+
+        uint64_t offset = alignSnapshotOffset(sizeof(SnapshotHeader));
+        bool fits = nextSection(offset, header->stringCount, sizeof(uint32_t), stringOffsets)
+                 && nextSection(offset, header->stringBytes, 1, stringBytes)
+                 && nextSection(offset, header->jobCount, sizeof(SnapshotJobRecord), jobs)
+                 && nextSection(offset, header->resumeCount, sizeof(SnapshotResumeRecord), resumes)
+                 && nextSection(offset, header->refCount, sizeof(uint32_t), refs)
+                 && nextSection(offset, header->pendingCount, sizeof(SnapshotPendingRecord), pending)
+                 && nextSection(offset, header->pendingIdCount, sizeof(int32_t), pendingIds)
+                 && nextSection(offset, header->indexCount, sizeof(SnapshotIndexEntry), indexes);
+        // Index sections follow the directory back to back, in its order
+        for (uint64_t i = 0; fits && i < header->indexCount; i++) {
+            const char* body;
+            fits = indexes[i].offset == offset && nextSection(offset, indexes[i].bytes, 1, body);
+        }
+
+        if (!fits || offset != mappedSize || header->jobCount > INT32_MAX || header->resumeCount > INT32_MAX) {
+            cerr << "Error: Snapshot " << filename << " has inconsistent sections" << endl;
+            unmap();
+            return false;
+        }
+        if (!validStringTable()) {
+            cerr << "Error: Snapshot " << filename << " has a corrupt string table" << endl;
+            unmap();
+            return false;
+        }
+        return true;
+    }
+
+    bool isOpen() const { return header != nullptr; }
+    int getJobCount() const { return header ? static_cast<int>(header->jobCount) : 0; }
+    int getResumeCount() const { return header ? static_cast<int>(header->resumeCount) : 0; }
+    int getStringCount() const { return header ? static_cast<int>(header->stringCount) : 0; }
+
+    // True if the record masks were computed for the keywords of matcher
+    bool hasKeywordMasks(const KeywordMatcher& matcher) const {
+        return header && header->keywordFingerprint != 0 && header->keywordFingerprint == matcher.getFingerprint();
+    }
+
+    // Decode a job; with a matcher whose keywords the masks were saved for,
+    // its keyword mask comes along instead of being scanned again
+    Job readJob(int index, const KeywordMatcher* matcher = nullptr) const {
+        const SnapshotJobRecord& rec = jobs[index];
+        Job job;
+        job.id = rec.id;
+        job.jobTitle = stringAt(rec.title);
+        job.lowerCaseTitle = stringAt(rec.lowerCaseTitle);
+        job.fullDescription = stringAt(rec.fullDescription);
+        job.jobCategory = stringAt(rec.jobCategory);
+        int categoryCode = jobCategoryCode(job.jobCategory.c_str());
+        job.categoryCode = categoryCode >= 0 ? static_cast<JobCategory>(categoryCode) : JOB_CATEGORY_UNKNOWN;
+        job.skillCount = rec.skillCount;
+        job.titleLength = rec.titleLength;
+        job.priority = rec.priority;
+        job.experienceLevel = rec.experienceLevel;
+        job.skills = stringList(rec.skillsBegin, rec.skillsCount);
+        job.lowerCaseSkills = stringList(rec.lowerSkillsBegin, rec.lowerSkillsCount);
+        job.matchScore = 0.0;
+        if (matcher && hasKeywordMasks(*matcher)) matcher->adoptMask(job, rec.keywordMask);
+        return job;
+    }
+
+    Resume readResume(int index, const KeywordMatcher* matcher = nullptr) const {
+        const SnapshotResumeRecord& rec = resumes[index];
+        Resume resume;
+        resume.id = rec.id;
+        resume.fullDescription = stringAt(rec.fullDescription);
+        resume.skillCount = rec.skillCount;
+        resume.resumeSkills = stringList(rec.skillsBegin, rec.skillsCount);
+        resume.lowerCaseSkills = stringList(rec.lowerSkillsBegin, rec.lowerSkillsCount);
+        resume.matchScore = 0.0;
+        if (matcher && hasKeywordMasks(*matcher)) matcher->adoptMask(resume, rec.keywordMask);
+        return resume;
+    }
+
+    CustomArray<CustomString> readValidSkills() const {
+        return stringList(header->validSkillsBegin, header->validSkillsCount);
+    }
+
+    void readPendingSkills(CustomHashMap<CustomString, CustomArray<int> >& pendingSkills) const {
+        pendingSkills.clear();
+        for (uint64_t i = 0; i < header->pendingCount; i++) {
+            const SnapshotPendingRecord& rec = pending[i];
+            if (static_cast<uint64_t>(rec.idsBegin) + rec.idsCount > header->pendingIdCount) continue;
+            CustomArray<int> ids;
+            ids.reserve(rec.idsCount);
+            for (uint32_t j = 0; j < rec.idsCount; j++) {
+                ids.push_back(pendingIds[rec.idsBegin + j]);
+            }
+            pendingSkills.insert(stringAt(rec.skill), ids);
+        }
+    }
+
+    // Body of the index section of kind, false if the snapshot has none
+    bool openIndex(uint32_t kind, SnapshotSectionReader& section) const {
+        for (uint64_t i = 0; header && i < header->indexCount; i++) {
+            if (indexes[i].kind != kind) continue;
+            section = SnapshotSectionReader(base + indexes[i].offset, indexes[i].bytes);
+            return true;
+        }
+        return false;
+    }
+
+    long long getJobSourceOffset() const { return header ? header->jobSourceOffset : 0; }
+    long long getResumeSourceOffset() const { return header ? header->resumeSourceOffset : 0; }
+};
@@ -0,0 +1,156 @@
+#pragma once
+#include "model.hpp"
+#include <cstring>
+#include <cstdint>
+
+using namespace std;
+
+// Body of one index section of a snapshot (see snapshot.hpp).
+//
+// An index saves itself as a run of plain values and arrays: a value is its
+// bytes, an array a uint64 element count and then its elements, each padded
+// to 8 bytes so every array starts aligned. Restoring copies each array out
+// in one memcpy; nothing is tokenised, hashed or sorted again. The reader
+// checks every count against the bytes left, but what the values mean (row
+// numbers in range, postings ascending) is for the restoring index to check.
+
+inline uint64_t alignSnapshotOffset(uint64_t offset) {
+    return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+class SnapshotSectionWriter {
+private:
+    CustomArray<char> bytes;
+    int reserved;
+
+    void append(const void* data, uint64_t size) {
+        int at = bytes.size();
+        int padded = static_cast<int>(alignSnapshotOffset(size));
+        // resize reserves exactly, so grow geometrically here
+        if (at + padded > reserved) {
+            reserved = max(at + padded, reserved * 2);
+            bytes.reserve(reserved);
+        }
+        bytes.resize(at + padded);
+        if (size > 0) memcpy(&bytes[at], data, size);
+        for (int i = at + static_cast<int>(size); i < at + padded; i++) bytes[i] = 0;
+    }
+
+public:
+    SnapshotSectionWriter() : reserved(0) {}
+
+    template<typename T>
+    void putValue(const T& value) {
+        append(&value, sizeof(T));
+    }
+
+    template<typename T>
+    void putArray(const T* data, int count) {
+        uint64_t n = count;
+        append(&n, sizeof(n));
+        append(data, n * sizeof(T));
+    }
+
+    template<typename T>
+    void putArray(const CustomArray<T>& arr) {
+        putArray(arr.size() > 0 ? &arr[0] : static_cast<const T*>(nullptr), arr.size());
+    }
+
+    // count strings, stringAt(i) giving each: their lengths, then their bytes
+    template<typename StringAt>
+    void putStrings(int count, StringAt stringAt) {
+        CustomArray<int32_t> lengths;
+        CustomArray<char> text;
+        lengths.resize(count);
+        int total = 0;
+        for (int i = 0; i < count; i++) {
+            lengths[i] = stringAt(i).size();
+            total += lengths[i];
+        }
+        text.resize(total);
+        int at = 0;
+        for (int i = 0; i < count; i++) {
+            if (lengths[i] > 0) memcpy(&text[at], stringAt(i).c_str(), lengths[i]);
+            at += lengths[i];
+        }
+        putArray(lengths);
+        putArray(text);
+    }
+
+    const char* getData() const { return bytes.size() > 0 ? &bytes[0] : nullptr; }
+    int getSize() const { return bytes.size(); }
+};
+
+class SnapshotSectionReader {
+private:
+    const char* data;
+    uint64_t left;
+    bool failed;
+
+    const char* take(uint64_t size) {
+        if (failed || size > left || alignSnapshotOffset(size) > left) {
+            failed = true;
+            return nullptr;
+        }
+        const char* at = data;
+        data += alignSnapshotOffset(size);
+        left -= alignSnapshotOffset(size);
+        return at;
+    }
+
+public:
+    SnapshotSectionReader() : data(nullptr), left(0), failed(true) {}
+    SnapshotSectionReader(const char* bytes, uint64_t size) : data(bytes), left(size), failed(false) {}
+
+    template<typename T>
+    bool getValue(T& value) {
+        const char* at = take(sizeof(T));
+        if (at) memcpy(&value, at, sizeof(T));
+        return at != nullptr;
+    }
+
+    template<typename T>
+    bool getArray(CustomArray<T>& out) {
+        uint64_t n = 0;
+        if (!getValue(n) || n > INT32_MAX || n > left / sizeof(T)) {
+            failed = true;
+            return false;
+        }
+        const char* at = take(n * sizeof(T));
+        if (at == nullptr) return false;
+        out.clear();
+        out.resize(static_cast<int>(n));
+        if (n > 0) memcpy(&out[0], at, n * sizeof(T));
+        return true;
+    }
+
+    // Strings written by putStrings
+    bool getStrings(CustomArray<CustomString>& out) {
+        CustomArray<int32_t> lengths;
+        CustomArray<char> text;
+        if (!getArray(lengths) || !getArray(text)) return false;
+        long long total = 0;
+        for (int i = 0; i < lengths.size(); i++) {
+            if (lengths[i] < 0) return fail();
+            total += lengths[i];
+        }
+        if (total != text.size()) return fail();
+        out.clear();
+        out.resize(lengths.size());
+        int at = 0;
+        for (int i = 0; i < lengths.size(); i++) {
+            out[i] = CustomString(text.size() > 0 ? &text[at] : "", lengths[i]);
+            at += lengths[i];
+        }
+        return true;
+    }
+
+    // Mark the section unusable; returns false for the caller to pass on
+    bool fail() {
+        failed = true;
+        return false;
+    }
+
+    // Every byte read and nothing failed: the section held what was expected
+    bool finished() const { return !failed && left == 0; }
+};
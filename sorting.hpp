@@ -0,0 +1,224 @@
+#pragma once
+#include "model.hpp"
+#include "thread_pool.hpp"
+#include <utility>
+#include <chrono>
+
+using namespace std;
+
+// Parallel in-place sorts for the array storage.
+//
+// parallelIntroSort: unstable. Median-of-3 pivot, three-way partition (runs of
+// equal keys are finished in one pass), heapsort once the recursion gets deeper
+// than 2*log2(n), insertion sort below 16 elements. The smaller side of each
+// partition is recursed into (as a pool task when it is large), the larger side
+// is looped on, so stack depth stays O(log n) on any input.
+//
+// parallelSort: stable merge sort, halves sorted in parallel, every merge goes
+// through one buffer that callers may keep between sorts.
+
+const int SORT_INSERTION_CUTOFF = 16;
+
+template<typename T, typename Less>
+void insertionSortRange(T* data, int low, int high, Less& less) {
+    for (int i = low + 1; i < high; i++) {
+        if (!less(data[i], data[i - 1])) continue;
+        T value = move(data[i]);
+        int j = i;
+        while (j > low && less(value, data[j - 1])) {
+            data[j] = move(data[j - 1]);
+            j--;
+        }
+        data[j] = move(value);
+    }
+}
+
+template<typename T, typename Less>
+void siftDown(T* data, int root, int count, Less& less) {
+    T value = move(data[root]);
+    while (true) {
+        int child = 2 * root + 1;
+        if (child >= count) break;
+        if (child + 1 < count && less(data[child], data[child + 1])) child++;
+        if (!less(value, data[child])) break;
+        data[root] = move(data[child]);
+        root = child;
+    }
+    data[root] = move(value);
+}
+
+template<typename T, typename Less>
+void heapSortRange(T* data, int low, int high, Less& less) {
+    T* base = data + low;
+    int count = high - low;
+    for (int i = count / 2 - 1; i >= 0; i--) siftDown(base, i, count, less);
+    for (int end = count - 1; end > 0; end--) {
+        swap(base[0], base[end]);
+        siftDown(base, 0, end, less);
+    }
+}
+
+// Median of data[a], data[b], data[c] moved to data[b]
+template<typename T, typename Less>
+void medianOfThree(T* data, int a, int b, int c, Less& less) {
+    if (less(data[b], data[a])) swap(data[a], data[b]);
+    if (less(data[c], data[b])) {
+        swap(data[b], data[c]);
+        if (less(data[b], data[a])) swap(data[a], data[b]);
+    }
+}
+
+template<typename T, typename Less>
+void introSortRange(T* data, int low, int high, int depthLimit, Less& less, int parallelCutoff, TaskGroup* group) {
+    while (high - low > SORT_INSERTION_CUTOFF) {
+        if (depthLimit == 0) {
+            heapSortRange(data, low, high, less);
+            return;
+        }
+        depthLimit--;
+
+        int mid = low + (high - low) / 2;
+        medianOfThree(data, low, mid, high - 1, less);
+        T pivot = data[mid];
+
+        // [low, lt) < pivot, [lt, i) == pivot, (gt, high) > pivot
+        int lt = low, i = low, gt = high - 1;
+        while (i <= gt) {
+            if (less(data[i], pivot)) swap(data[lt++], data[i++]);
+            else if (less(pivot, data[i])) swap(data[i], data[gt--]);
+            else i++;
+        }
+
+        int leftLow = low, leftHigh = lt;
+        int rightLow = gt + 1, rightHigh = high;
+        if (leftHigh - leftLow > rightHigh - rightLow) {
+            swap(leftLow, rightLow);
+            swap(leftHigh, rightHigh);
+        }
+        // [leftLow, leftHigh) is the smaller side
+        if (group != nullptr && leftHigh - leftLow > parallelCutoff) {
+            group->spawn([=, &less] {
+                introSortRange(data, leftLow, leftHigh, depthLimit, less, parallelCutoff, group);
+            });
+        } else {
+            introSortRange(data, leftLow, leftHigh, depthLimit, less, parallelCutoff, group);
+        }
+        low = rightLow;
+        high = rightHigh;
+    }
+    insertionSortRange(data, low, high, less);
+}
+
+template<typename T, typename Less>
+void parallelIntroSort(T* data, int n, Less less, const char* label = "parallel_introsort") {
+    if (n < 2) return;
+    ThreadPool& pool = threadPool();
+    auto wallStart = chrono::steady_clock::now();
+    int depthLimit = 0;
+    for (int m = n; m > 1; m >>= 1) depthLimit += 2;
+    int parallelCutoff = max(4096, n / (pool.getWorkerCount() * 8));
+    if (pool.getWorkerCount() > 1 && n > parallelCutoff) {
+        TaskGroup group(pool);
+        introSortRange(data, 0, n, depthLimit, less, parallelCutoff, &group);
+        group.wait();
+    } else {
+        introSortRange(data, 0, n, depthLimit, less, parallelCutoff, static_cast<TaskGroup*>(nullptr));
+    }
+    auto wallEnd = chrono::steady_clock::now();
+#if INSTRUMENTATION_ENABLED
+    recordTimer(label, wallStart, wallEnd);
+#endif
+    double wallMs = chrono::duration<double, milli>(wallEnd - wallStart).count();
+    pool.recordRegion(label, 1, wallMs, wallMs, wallMs);
+}
+
+template<typename T, typename Less>
+void mergeSortRange(T* data, T* buffer, int low, int high, Less& less, int parallelCutoff, ThreadPool* pool) {
+    int count = high - low;
+    if (count <= 24) {
+        insertionSortRange(data, low, high, less);
+        return;
+    }
+    int mid = low + count / 2;
+    if (pool != nullptr && count > parallelCutoff) {
+        TaskGroup group(*pool);
+        group.spawn([=, &less] { mergeSortRange(data, buffer, low, mid, less, parallelCutoff, pool); });
+        mergeSortRange(data, buffer, mid, high, less, parallelCutoff, pool);
+        group.wait();
+    } else {
+        mergeSortRange(data, buffer, low, mid, less, parallelCutoff, pool);
+        mergeSortRange(data, buffer, mid, high, less, parallelCutoff, pool);
+    }
+    if (!less(data[mid], data[mid - 1])) return;   // Halves already in order
+
+    int i = low, j = mid, k = low;
+    while (i < mid && j < high) {
+        if (less(data[j], data[i])) buffer[k++] = move(data[j++]);
+        else buffer[k++] = move(data[i++]);
+    }
+    while (i < mid) buffer[k++] = move(data[i++]);
+    while (j < high) buffer[k++] = move(data[j++]);
+    for (k = low; k < high; k++) data[k] = move(buffer[k]);
+}
+
+// Stable sort using buffer as merge space; buffer grows to n and can be kept
+// for the next sort. Elements left in it are moved-from.
+template<typename T, typename Less>
+void parallelSort(T* data, int n, Less less, CustomArray<T>& buffer, const char* label = "parallel_sort") {
+    if (n < 2) return;
+    ThreadPool& pool = threadPool();
+    auto wallStart = chrono::steady_clock::now();
+    if (buffer.size() < n) buffer.resize(n);
+    int parallelCutoff = max(4096, n / (pool.getWorkerCount() * 4));
+    mergeSortRange(data, &buffer[0], 0, n, less, parallelCutoff, pool.getWorkerCount() > 1 ? &pool : nullptr);
+    auto wallEnd = chrono::steady_clock::now();
+#if INSTRUMENTATION_ENABLED
+    recordTimer(label, wallStart, wallEnd);
+#endif
+    double wallMs = chrono::duration<double, milli>(wallEnd - wallStart).count();
+    pool.recordRegion(label, 1, wallMs, wallMs, wallMs);
+}
+
+template<typename T, typename Less>
+void parallelSort(T* data, int n, Less less, const char* label = "parallel_sort") {
+    CustomArray<T> buffer;
+    parallelSort(data, n, less, buffer, label);
+}
+
+// ---------------------------------------------------------------------------
+// Sort keys for Job and Resume
+// ---------------------------------------------------------------------------
+
+struct JobTitleLess {
+    bool operator()(const Job& a, const Job& b) const {
+        const char* x = a.jobTitle.c_str();
+        const char* y = b.jobTitle.c_str();
+        if (x == nullptr || y == nullptr) return x == nullptr && y != nullptr;
+        return strcmp(x, y) < 0;
+    }
+};
+
+struct JobSkillCountLess {
+    bool operator()(const Job& a, const Job& b) const { return a.skillCount < b.skillCount; }
+};
+
+// Highest matchScore first
+struct JobMatchScoreGreater {
+    bool operator()(const Job& a, const Job& b) const { return a.matchScore > b.matchScore; }
+};
+
+struct JobIdLess {
+    bool operator()(const Job& a, const Job& b) const { return a.id < b.id; }
+};
+
+struct JobPriorityLess {
+    bool operator()(const Job& a, const Job& b) const { return a.priority < b.priority; }
+};
+
+struct ResumeSkillCountLess {
+    bool operator()(const Resume& a, const Resume& b) const { return a.skillCount < b.skillCount; }
+};
+
+struct ResumeIdLess {
+    bool operator()(const Resume& a, const Resume& b) const { return a.id < b.id; }
+};
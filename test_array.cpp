@@ -7,6 +7,9 @@
 
 using namespace std;
 
+// Default location of the preprocessed binary snapshot
+const char* ARRAY_SNAPSHOT_FILE = "csv/array_storage.snapshot";
+
 // Forward declarations
 void runSearchPerformance(ArrayDataStorage& storage);
 
@@ -18,6 +21,13 @@ void displayArrayMainMenu() {
     cout << "4. Search Data (Linear Search)" << endl;
     cout << "5. Find Job Matches for Resume" << endl;
     cout << "6. Performance Tests" << endl;
+    cout << "7. Save Binary Snapshot" << endl;
+    cout << "8. Load Binary Snapshot (Warm Start)" << endl;
+    cout << "9. Ingest New CSV Rows (Incremental)" << endl;
+    cout << "10. Concurrent Query Benchmark (Snapshot Readers)" << endl;
+    cout << "11. Compare Scoring Policies" << endl;
+    cout << "12. Write All Matches to File (Batch)" << endl;
+    cout << "13. Indexed Job Views (B+-tree)" << endl;
     cout << "0. Exit" << endl;
     cout << "=================================" << endl;
     cout << "Enter your choice: ";
@@ -39,7 +49,8 @@ void runKeywordMatchingDemo(ArrayDataStorage& storage) {
     }
 
     const Resume& sampleResume = storage.getResumeArray()[resumeIndex];
-    storage.rankJobsForResumeByKeywords(sampleResume);
+    QueryResult ranked;
+    storage.queryTopJobsByKeywords(sampleResume, 5, ranked);
 
     cout << "\n=== Top 5 Jobs by Keyword Overlap for Resume " << sampleResume.id << " ===" << endl;
     cout << "Resume Skills: ";
@@ -50,14 +61,158 @@ void runKeywordMatchingDemo(ArrayDataStorage& storage) {
     cout << endl;
     cout << "=========================================" << endl;
     
-    int top = min(5, storage.getJobArray().getSize());
-    for (int i = 0; i < top; i++) {
-        const Job& j = storage.getJobArray()[i];
-        cout << "\nJob Match #" << (i + 1) << " (Keyword Score: " << j.matchScore << "):" << endl;
+    for (int i = 0; i < ranked.size(); i++) {
+        const Job& j = storage.getJobArray()[ranked.indices[i]];
+        cout << "\nJob Match #" << (i + 1) << " (Keyword Score: " << ranked.scores[i] << "):" << endl;
         j.display();
     }
 }
 
+// Batch run: top K jobs of every resume written to disk
+void runBatchMatchOutput(ArrayDataStorage& storage) {
+    if (storage.getJobArray().getSize() == 0) {
+        cout << "\n[ERROR] Please load data first (Main Menu option 1)." << endl;
+        return;
+    }
+
+    int topK = 50;
+    int formatChoice = 1;
+    cout << "Matches per resume (K): ";
+    if (!(cin >> topK) || topK <= 0) {
+        cout << "Invalid K" << endl;
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        return;
+    }
+    cout << "Output format (1 = CSV, 2 = binary): ";
+    if (!(cin >> formatChoice) || (formatChoice != 1 && formatChoice != 2)) {
+        cout << "Invalid format" << endl;
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        return;
+    }
+
+    MatchOutputFormat format = formatChoice == 1 ? MATCH_OUTPUT_CSV : MATCH_OUTPUT_BINARY;
+    const char* filename = formatChoice == 1 ? "csv/batch_matches.csv" : "csv/batch_matches.bin";
+    auto start = chrono::high_resolution_clock::now();
+    long long rows = storage.writeAllMatches(filename, topK, format);
+    auto end = chrono::high_resolution_clock::now();
+    if (rows >= 0) {
+        cout << "Batch completed in: " << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms" << endl;
+    }
+}
+
+// Browse the jobs in the order of one B+-tree index without re-sorting them
+void runIndexedJobViews(ArrayDataStorage& storage) {
+    if (storage.getJobArray().getSize() == 0) {
+        cout << "\n[ERROR] Please load data first (Main Menu option 1)." << endl;
+        return;
+    }
+
+    const char* fields[] = {"title", "category", "priority", "skillCount", "id"};
+    int fieldChoice = 1;
+    cout << "Order by (1 = title, 2 = category, 3 = priority, 4 = skill count, 5 = id): ";
+    if (!(cin >> fieldChoice) || fieldChoice < 1 || fieldChoice > 5) {
+        cout << "Invalid choice" << endl;
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        return;
+    }
+
+    // The first view after a load or sort bulk-loads every index
+    QueryResult page;
+    auto start = chrono::high_resolution_clock::now();
+    storage.queryJobsOrderedBy(fields[fieldChoice - 1], 0, 10, page);
+    auto end = chrono::high_resolution_clock::now();
+    cout << "\nFirst 10 jobs by " << fields[fieldChoice - 1] << " ("
+         << chrono::duration_cast<chrono::microseconds>(end - start).count() << " microseconds):" << endl;
+    for (int i = 0; i < page.size(); i++) {
+        const Job& job = storage.getJobArray()[page.indices[i]];
+        cout << "  Job " << job.id << " | " << job.jobTitle << " | " << job.jobCategory
+             << " | priority " << job.priority << " | " << job.skillCount << " skills" << endl;
+    }
+
+    QueryResult matches;
+    start = chrono::high_resolution_clock::now();
+    storage.queryJobsByPriorityRange(3, 4, matches);
+    end = chrono::high_resolution_clock::now();
+    cout << "Jobs with priority 3-4: " << matches.size() << " (range scan "
+         << chrono::duration_cast<chrono::microseconds>(end - start).count() << " microseconds)" << endl;
+
+    // Category buckets: a filtered search scans only the selected buckets
+    cout << "Jobs per category:";
+    for (int category = 0; category < JOB_CATEGORY_COUNT; category++) {
+        cout << " " << jobCategoryName(category) << " " << storage.countJobsInBuckets(JobFilter(category, JOB_FILTER_ANY));
+    }
+    cout << endl;
+    JobFilter priorityThree(JOB_FILTER_ANY, 3);
+    start = chrono::high_resolution_clock::now();
+    storage.queryJobsBySkillFiltered(CustomString("python"), priorityThree, matches);
+    end = chrono::high_resolution_clock::now();
+    cout << "Priority-3 jobs with python: " << matches.size() << " ("
+         << storage.countJobsInBuckets(priorityThree) << " jobs scanned, "
+         << chrono::duration_cast<chrono::microseconds>(end - start).count() << " microseconds)" << endl;
+}
+
+// Rank one resume with one scoring policy and print the top 5 job ids
+template<typename Scorer>
+void printScorerRanking(ArrayDataStorage& storage, const Resume& resume, Scorer& scorer) {
+    QueryResult ranked;
+    auto start = chrono::high_resolution_clock::now();
+    storage.queryTopJobsWith(resume, scorer, 5, ranked);
+    auto end = chrono::high_resolution_clock::now();
+    cout << Scorer::name() << " (" << chrono::duration_cast<chrono::microseconds>(end - start).count() << " us):";
+    for (int i = 0; i < ranked.size(); i++) {
+        cout << " Job " << storage.getJobArray()[ranked.indices[i]].id << " [" << ranked.scores[i] << "]";
+    }
+    cout << endl;
+}
+
+// Demo: the same resume ranked by every scoring policy
+void runScorerComparison(ArrayDataStorage& storage) {
+    if (storage.getResumeArray().getSize() == 0) {
+        cout << "\n[ERROR] Please load data first (Main Menu option 1)." << endl;
+        return;
+    }
+
+    int resumeIndex = 0;
+    cout << "Enter resume index (0-" << (storage.getResumeArray().getSize() - 1) << "): ";
+    if (!(cin >> resumeIndex) || resumeIndex < 0 || resumeIndex >= storage.getResumeArray().getSize()) {
+        cout << "Invalid resume index" << endl;
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        return;
+    }
+    const Resume& resume = storage.getResumeArray()[resumeIndex];
+
+    WeightedScorer weighted;
+    JaccardScorer jaccard;
+    KeywordScorer keyword(storage.getKeywordMatcher());
+    CosineScorer cosine;
+    BM25Scorer bm25(storage.getSkillStatistics());
+
+    cout << "\n=== Top 5 Jobs for Resume " << resume.id << " by Scoring Policy ===" << endl;
+    printScorerRanking(storage, resume, weighted);
+    printScorerRanking(storage, resume, jaccard);
+    printScorerRanking(storage, resume, keyword);
+    printScorerRanking(storage, resume, cosine);
+    printScorerRanking(storage, resume, bm25);
+
+    // Full-text BM25 over descriptions through the inverted index
+    const DescriptionIndex& index = storage.getDescriptionIndex();
+    QueryResult ranked;
+    auto start = chrono::high_resolution_clock::now();
+    int scored = index.search(resume, 5, ranked);
+    auto end = chrono::high_resolution_clock::now();
+    cout << "BM25 description (" << chrono::duration_cast<chrono::microseconds>(end - start).count() << " us, "
+         << scored << " of " << index.getDocumentCount() << " jobs scored):";
+    for (int i = 0; i < ranked.size(); i++) {
+        cout << " Job " << storage.getJobArray()[ranked.indices[i]].id << " [" << ranked.scores[i] << "]";
+    }
+    cout << endl;
+    cout << "Index: " << index.getTermCount() << " terms, " << index.getPostingBytes() << " bytes of postings" << endl;
+}
+
 // Show comprehensive data statistics
 void showDataStatistics(ArrayDataStorage& storage) {
     if (storage.getJobArray().getSize() == 0) {
@@ -111,6 +266,9 @@ void displayArraySortMenu() {
     cout << "1. Sort Jobs by Title (A-Z) - Bubble Sort" << endl;
     cout << "2. Sort Jobs by Skill Count - Bubble Sort" << endl;
     cout << "3. Sort Resumes by Skill Count - Bubble Sort" << endl;
+    cout << "4. Sort Jobs by Title (A-Z) - Parallel Merge Sort" << endl;
+    cout << "5. Sort Jobs by Skill Count - Parallel Introsort" << endl;
+    cout << "6. Sort Resumes by Skill Count - Parallel Merge Sort" << endl;
     cout << "0. Back to Main Menu" << endl;
     cout << "----------------------" << endl;
     cout << "Enter your choice: ";
@@ -155,6 +313,36 @@ void handleSortMenu(ArrayDataStorage& storage) {
                          << ", Skills=" << storage.getResumeArray()[i].skillCount << endl;
                 }
                 break;
+            case 4: {
+                auto start = chrono::high_resolution_clock::now();
+                storage.sortJobsBy(JobTitleLess(), true, "sort.jobs.title");
+                auto end = chrono::high_resolution_clock::now();
+                cout << "Jobs sorted by title (Parallel Merge Sort) in "
+                     << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms." << endl;
+                storage.displaySampleData(5);
+                break;
+            }
+            case 5: {
+                auto start = chrono::high_resolution_clock::now();
+                storage.quickSortJobsBySkillCount();
+                auto end = chrono::high_resolution_clock::now();
+                cout << "Jobs sorted by skill count (Parallel Introsort) in "
+                     << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms." << endl;
+                storage.displaySampleData(5);
+                break;
+            }
+            case 6: {
+                auto start = chrono::high_resolution_clock::now();
+                storage.sortResumesBy(ResumeSkillCountLess(), true, "sort.resumes.skillCount");
+                auto end = chrono::high_resolution_clock::now();
+                cout << "Resumes sorted by skill count (Parallel Merge Sort) in "
+                     << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms." << endl;
+                for (int i = 0; i < min(5, storage.getResumeArray().getSize()); i++) {
+                    cout << "Resume " << i + 1 << ": ID=" << storage.getResumeArray()[i].id 
+                         << ", Skills=" << storage.getResumeArray()[i].skillCount << endl;
+                }
+                break;
+            }
             case 0:
                 cout << "Returning to main menu..." << endl;
                 break;
@@ -182,27 +370,23 @@ void runLinearSearchDemo(ArrayDataStorage& storage) {
     auto start = chrono::high_resolution_clock::now();
     
     // Find ALL jobs with matching title
-    CustomArrayV2<Job> foundJobs;
-    for (int i = 0; i < storage.getJobArray().getSize(); i++) {
-        if (strcmp(storage.getJobArray()[i].jobTitle.c_str(), title.c_str()) == 0) {
-            foundJobs.push_back(storage.getJobArray()[i]);
-        }
-    }
+    QueryResult foundJobs;
+    storage.queryJobsByTitle(title, foundJobs);
     
     auto end = chrono::high_resolution_clock::now();
     auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
     
-    if (foundJobs.getSize() > 0) {
-        cout << "\n[SUCCESS] Found " << foundJobs.getSize() << " job(s) matching \"" << title << "\":" << endl;
+    if (foundJobs.size() > 0) {
+        cout << "\n[SUCCESS] Found " << foundJobs.size() << " job(s) matching \"" << title << "\":" << endl;
         cout << "=========================================" << endl;
-        for (int i = 0; i < foundJobs.getSize(); i++) {
-            foundJobs[i].display();
-            if (i < foundJobs.getSize() - 1) {
+        for (int i = 0; i < foundJobs.size(); i++) {
+            storage.getJobArray()[foundJobs.indices[i]].display();
+            if (i < foundJobs.size() - 1) {
                 cout << "---" << endl;
             }
         }
         cout << "\nSearch completed in: " << duration.count() << " ms" << endl;
-        cout << "Total matches found: " << foundJobs.getSize() << " jobs" << endl;
+        cout << "Total matches found: " << foundJobs.size() << " jobs" << endl;
     } else {
         cout << "[NOT FOUND] No job with the title \"" << title << "\" was found." << endl;
         cout << "Search completed in: " << duration.count() << " ms" << endl;
@@ -226,25 +410,38 @@ void runJobSkillSearchDemo(ArrayDataStorage& storage) {
     cout << "\nSearch results for skill: '" << skill << "'" << endl;
     
     auto start = chrono::high_resolution_clock::now();
-    CustomArrayV2<Job> results = storage.searchJobsBySkill(skill);
+    QueryResult results;
+    int skillId = storage.resolveSkillId(skill);
+    if (skillId != SKILL_TRIE_NONE) storage.queryJobsBySkillId(skillId, results);
     auto end = chrono::high_resolution_clock::now();
+    if (skillId != SKILL_TRIE_NONE && strcmp(storage.getSkillName(skillId).c_str(), skill.c_str()) != 0) {
+        cout << "Matched skill: '" << storage.getSkillName(skillId) << "'" << endl;
+        skill = storage.getSkillName(skillId);
+    }
     auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
     
-    cout << "Found " << results.getSize() << " jobs with this skill." << endl;
+    cout << "Found " << results.size() << " jobs with this skill." << endl;
     
-    if (results.getSize() > 0) {
-        cout << "\n[SUCCESS] Found " << results.getSize() << " job(s) with skill \"" << skill << "\":" << endl;
+    if (results.size() > 0) {
+        cout << "\n[SUCCESS] Found " << results.size() << " job(s) with skill \"" << skill << "\":" << endl;
         cout << "=========================================" << endl;
-        for (int i = 0; i < results.getSize(); i++) {
-            results[i].display();
-            if (i < results.getSize() - 1) {
+        for (int i = 0; i < results.size(); i++) {
+            storage.getJobArray()[results.indices[i]].display();
+            if (i < results.size() - 1) {
                 cout << "---" << endl;
             }
         }
         cout << "\nSearch completed in: " << duration.count() << " ms" << endl;
-        cout << "Total matches found: " << results.getSize() << " jobs" << endl;
+        cout << "Total matches found: " << results.size() << " jobs" << endl;
     } else {
         cout << "[NOT FOUND] No jobs found with the skill \"" << skill << "\"." << endl;
+        CustomArray<int> completions;
+        storage.completeSkill(skill, 5, completions);
+        if (completions.size() > 0) {
+            cout << "Skills starting with \"" << skill << "\":";
+            for (int i = 0; i < completions.size(); i++) cout << " '" << storage.getSkillName(completions[i]) << "'";
+            cout << endl;
+        }
         cout << "Search completed in: " << duration.count() << " ms" << endl;
         cout << "Total matches found: 0 jobs" << endl;
     }
@@ -266,23 +463,24 @@ void runResumeSkillSearchDemo(ArrayDataStorage& storage) {
     cout << "\nSearch results for skill: '" << skill << "'" << endl;
     
     auto start = chrono::high_resolution_clock::now();
-    CustomArrayV2<Resume> results = storage.searchResumesBySkill(skill);
+    QueryResult results;
+    storage.queryResumesBySkill(skill, results);
     auto end = chrono::high_resolution_clock::now();
     auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
     
-    cout << "Found " << results.getSize() << " resumes with this skill." << endl;
+    cout << "Found " << results.size() << " resumes with this skill." << endl;
     
-    if (results.getSize() > 0) {
-        cout << "\n[SUCCESS] Found " << results.getSize() << " resume(s) with skill \"" << skill << "\":" << endl;
+    if (results.size() > 0) {
+        cout << "\n[SUCCESS] Found " << results.size() << " resume(s) with skill \"" << skill << "\":" << endl;
         cout << "=========================================" << endl;
-        for (int i = 0; i < results.getSize(); i++) {
-            results[i].display();
-            if (i < results.getSize() - 1) {
+        for (int i = 0; i < results.size(); i++) {
+            storage.getResumeArray()[results.indices[i]].display();
+            if (i < results.size() - 1) {
                 cout << "---" << endl;
             }
         }
         cout << "\nSearch completed in: " << duration.count() << " ms" << endl;
-        cout << "Total matches found: " << results.getSize() << " resumes" << endl;
+        cout << "Total matches found: " << results.size() << " resumes" << endl;
     } else {
         cout << "[NOT FOUND] No resumes found with the skill \"" << skill << "\"." << endl;
         cout << "Search completed in: " << duration.count() << " ms" << endl;
@@ -350,18 +548,27 @@ void runFilterDemo(ArrayDataStorage& storage) {
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
     getline(cin, keyword);
     CustomString key(keyword.c_str());
-    auto filtered = storage.filterJobsByTitleKeyword(key);
-    cout << "\n[SUCCESS] Found " << filtered.getSize() << " jobs with keyword '" << keyword << "' in title." << endl;
+    QueryResult filtered;
+    auto indexStart = chrono::high_resolution_clock::now();
+    storage.queryJobsByTitleKeyword(key, filtered);
+    auto indexEnd = chrono::high_resolution_clock::now();
+    QueryResult scanned;
+    ::queryJobsByTitleKeyword(storage.getJobArray(), key, scanned);
+    auto scanEnd = chrono::high_resolution_clock::now();
+    cout << "\n[SUCCESS] Found " << filtered.size() << " jobs with keyword '" << keyword << "' in title." << endl;
+    cout << "Trigram index: " << chrono::duration_cast<chrono::microseconds>(indexEnd - indexStart).count()
+         << " us, full title scan: " << chrono::duration_cast<chrono::microseconds>(scanEnd - indexEnd).count()
+         << " us (" << storage.getTitleTrigrams().getTrigramCount() << " trigrams)" << endl;
     cout << "=========================================" << endl;
     
-    int displayCount = min(5, filtered.getSize());
+    int displayCount = min(5, filtered.size());
     for (int i = 0; i < displayCount; i++) {
         cout << "\nJob Match #" << (i + 1) << ":" << endl;
-        filtered[i].display();
+        storage.getJobArray()[filtered.indices[i]].display();
     }
     
-    if (filtered.getSize() > 5) {
-        cout << "\n... and " << (filtered.getSize() - 5) << " more jobs found." << endl;
+    if (filtered.size() > 5) {
+        cout << "\n... and " << (filtered.size() - 5) << " more jobs found." << endl;
     }
 }
 
@@ -369,6 +576,7 @@ void runFilterDemo(ArrayDataStorage& storage) {
 
 // Performance: comprehensive sorting and matching timing
 void runSearchPerformance(ArrayDataStorage& storage) {
+    INSTRUMENT_SCOPE("bench.array.searchPerformance");
     if (storage.getJobArray().getSize() == 0) { 
         cout << "Load data first." << endl; 
         return; 
@@ -520,11 +728,37 @@ void runArrayMenu() {
                            runSearchPerformance(storage);
                        }
                        break;
+                   case 7:
+                       if (storage.getJobArray().getSize() == 0) {
+                           cout << "\n[ERROR] Please load data first (Main Menu option 1)." << endl;
+                       } else {
+                           storage.saveSnapshot(ARRAY_SNAPSHOT_FILE);
+                       }
+                       break;
+                   case 8:
+                       cout << "\nLoading snapshot " << ARRAY_SNAPSHOT_FILE << "..." << endl;
+                       storage.loadFromSnapshot(ARRAY_SNAPSHOT_FILE);
+                       break;
+                   case 9:
+                       storage.ingestNewRows("csv/job_description.csv", "csv/resume.csv");
+                       break;
+                   case 10:
+                       printSnapshotReaderBenchmark(storage.getPublishedStore());
+                       break;
+                   case 11:
+                       runScorerComparison(storage);
+                       break;
+                   case 12:
+                       runBatchMatchOutput(storage);
+                       break;
+                   case 13:
+                       runIndexedJobViews(storage);
+                       break;
                    case 0:
                        cout << "\nExiting Job Matching System. Goodbye!" << endl;
                        break;
                    default:
-                       cout << "\n[INVALID CHOICE] Please select a valid option (0-6)." << endl;
+                       cout << "\n[INVALID CHOICE] Please select a valid option (0-13)." << endl;
                        break;
         }
     } while (choice != 0);
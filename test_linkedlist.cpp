@@ -1,13 +1,18 @@
 // test_linkedlist.cpp — Combined Team Test Driver
 #include "linkedlist_datastorage.hpp"
 #include "model.hpp"
+#include "unrolled_list.hpp"
 #include <cctype>
 #include <iostream>
 #include <chrono>
+#include <iomanip>
 #include <limits> // Required for numeric_limits
 
 using namespace std;
 
+// Default location of the preprocessed binary snapshot
+const char* LINKEDLIST_SNAPSHOT_FILE = "csv/linkedlist_storage.snapshot";
+
 // --- Main Menu (Your new requirement) ---
 
 void displayMainMenu() {
@@ -18,11 +23,190 @@ void displayMainMenu() {
     cout << "4. Search Data (Linear Search)" << endl;
     cout << "5. Find Job Matches for Resume" << endl;
     cout << "6. Performance Tests" << endl;
+    cout << "7. Save Binary Snapshot" << endl;
+    cout << "8. Load Binary Snapshot (Warm Start)" << endl;
+    cout << "9. Ingest New CSV Rows (Incremental)" << endl;
+    cout << "10. Concurrent Query Benchmark (Snapshot Readers)" << endl;
+    cout << "11. Compare Scoring Policies" << endl;
+    cout << "12. Approximate Matching Benchmark (MinHash LSH)" << endl;
+    cout << "13. List Layout Benchmark (Linked vs Unrolled vs Array)" << endl;
     cout << "0. Exit" << endl;
     cout << "=================================" << endl;
     cout << "Enter your choice: ";
 }
 
+// --- Scoring policy comparison ---
+
+// Rank one resume with one scoring policy and print the top 5 job ids
+template<typename Scorer>
+void printScorerRanking(LinkedListDataStorage& dataStorage, const Resume& resume, Scorer& scorer) {
+    HandleQueryResult<Job> ranked;
+    auto start = chrono::high_resolution_clock::now();
+    dataStorage.queryTopMatchesWith(resume, scorer, 5, ranked);
+    auto end = chrono::high_resolution_clock::now();
+    cout << Scorer::name() << " (" << chrono::duration_cast<chrono::microseconds>(end - start).count() << " us):";
+    for (int i = 0; i < ranked.size(); i++) {
+        cout << " Job " << ranked.items[i]->id << " [" << ranked.scores[i] << "]";
+    }
+    cout << endl;
+}
+
+void runScorerComparison(LinkedListDataStorage& dataStorage) {
+    if (!dataStorage.isDataLoaded()) {
+        cout << "\n[ERROR] Please load data first (Main Menu option 1)." << endl;
+        return;
+    }
+
+    int resumeIndex = 0;
+    cout << "Enter resume index (0-" << (dataStorage.getResumeList().getSize() - 1) << "): ";
+    if (!(cin >> resumeIndex) || resumeIndex < 0 || resumeIndex >= dataStorage.getResumeList().getSize()) {
+        cout << "Invalid resume index" << endl;
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        return;
+    }
+    const Resume& resume = dataStorage.getResumeList()[resumeIndex];
+
+    SkillStatistics stats;
+    stats.build(dataStorage.getJobList());
+    KeywordMatcher matcher;
+    WeightedScorer weighted;
+    JaccardScorer jaccard;
+    KeywordScorer keyword(matcher);
+    CosineScorer cosine;
+    BM25Scorer bm25(stats);
+
+    cout << "\n=== Top 5 Jobs for Resume " << resume.id << " by Scoring Policy ===" << endl;
+    printScorerRanking(dataStorage, resume, weighted);
+    printScorerRanking(dataStorage, resume, jaccard);
+    printScorerRanking(dataStorage, resume, keyword);
+    printScorerRanking(dataStorage, resume, cosine);
+    printScorerRanking(dataStorage, resume, bm25);
+}
+
+// --- Approximate matching ---
+
+// recall@5 and query time of a few LSH shapes against the exact Jaccard scan
+void runLshBenchmark(LinkedListDataStorage& dataStorage) {
+    if (!dataStorage.isDataLoaded()) {
+        cout << "\n[ERROR] Please load data first (Main Menu option 1)." << endl;
+        return;
+    }
+
+    const int k = 5;
+    const LshConfig configs[] = {LshConfig(32, 2), LshConfig(16, 4), LshConfig(20, 5), LshConfig(8, 8)};
+    CustomArray<const Resume*> sample = sampleResumes(dataStorage.getResumeList(), 200);
+
+    cout << "\n=== MinHash LSH vs Exact Jaccard (" << sample.size() << " resumes, "
+         << dataStorage.getJobList().getSize() << " jobs) ===" << endl;
+    for (const LshConfig& config : configs) {
+        dataStorage.configureLsh(config);
+        auto start = chrono::high_resolution_clock::now();
+        const MinHashLshIndex& index = dataStorage.getLshIndex();
+        auto end = chrono::high_resolution_clock::now();
+        LshRecallReport report = measureLshRecall(index, sample, k);
+        cout << config.bands << " bands x " << config.rows << " rows: build "
+             << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms, recall@" << k << " "
+             << report.recall << ", " << report.averageCandidates << " candidates/query, exact "
+             << report.exactMs << " ms vs LSH " << report.approximateMs << " ms per query" << endl;
+    }
+    dataStorage.configureLsh(LshConfig());
+}
+
+// --- Container layout comparison ---
+
+// Milliseconds since start
+inline double elapsedMs(chrono::high_resolution_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count();
+}
+
+// Build, scan, indexed access and middle insert/remove over copies of the job
+// list in a node-per-job list, an unrolled list and an array
+void runListLayoutBenchmark(LinkedListDataStorage& dataStorage) {
+    if (!dataStorage.isDataLoaded()) {
+        cout << "\n[ERROR] Please load data first (Main Menu option 1)." << endl;
+        return;
+    }
+
+    const CustomLinkedList<Job>& jobs = dataStorage.getJobList();
+    const int scanPasses = 50;
+    const int lookups = 2000;
+    const int updates = 1000;
+    volatile long long sink = 0;
+
+    auto start = chrono::high_resolution_clock::now();
+    CustomLinkedList<Job> linked(jobs);
+    double linkedBuild = elapsedMs(start);
+
+    start = chrono::high_resolution_clock::now();
+    CustomUnrolledList<Job> unrolled;
+    for (const ListNode<Job>* node = jobs.getHead(); node != nullptr; node = node->next) unrolled.push_back(node->data);
+    double unrolledBuild = elapsedMs(start);
+
+    start = chrono::high_resolution_clock::now();
+    CustomArrayV2<Job> array;
+    for (const ListNode<Job>* node = jobs.getHead(); node != nullptr; node = node->next) array.push_back(node->data);
+    double arrayBuild = elapsedMs(start);
+
+    // Sum a small field so the scan cost is the traversal, not the work per job
+    start = chrono::high_resolution_clock::now();
+    for (int pass = 0; pass < scanPasses; pass++) {
+        long long sum = 0;
+        for (const ListNode<Job>* node = linked.getHead(); node != nullptr; node = node->next) sum += node->data.skillCount;
+        sink = sink + sum;
+    }
+    double linkedScan = elapsedMs(start) / scanPasses;
+
+    start = chrono::high_resolution_clock::now();
+    for (int pass = 0; pass < scanPasses; pass++) {
+        long long sum = 0;
+        for (const Job& job : unrolled) sum += job.skillCount;
+        sink = sink + sum;
+    }
+    double unrolledScan = elapsedMs(start) / scanPasses;
+
+    start = chrono::high_resolution_clock::now();
+    for (int pass = 0; pass < scanPasses; pass++) {
+        long long sum = 0;
+        for (int i = 0; i < array.getSize(); i++) sum += array[i].skillCount;
+        sink = sink + sum;
+    }
+    double arrayScan = elapsedMs(start) / scanPasses;
+
+    // Indexed access at evenly spread positions
+    int n = jobs.getSize();
+    start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < lookups; i++) sink = sink + linked[static_cast<int>((static_cast<long long>(i) * 7919) % n)].skillCount;
+    double linkedLookup = elapsedMs(start) * 1000.0 / lookups;
+    start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < lookups; i++) sink = sink + unrolled[static_cast<int>((static_cast<long long>(i) * 7919) % n)].skillCount;
+    double unrolledLookup = elapsedMs(start) * 1000.0 / lookups;
+    start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < lookups; i++) sink = sink + array[static_cast<int>((static_cast<long long>(i) * 7919) % n)].skillCount;
+    double arrayLookup = elapsedMs(start) * 1000.0 / lookups;
+
+    // Middle inserts then removes; the array can only shift on remove
+    start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < updates; i++) unrolled.insert(unrolled.getSize() / 2, jobs.getHead()->data);
+    for (int i = 0; i < updates; i++) unrolled.remove(unrolled.getSize() / 2);
+    double unrolledUpdate = elapsedMs(start) * 1000.0 / (2 * updates);
+    start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < updates; i++) array.remove(array.getSize() / 2);
+    double arrayUpdate = elapsedMs(start) * 1000.0 / updates;
+
+    cout << fixed << setprecision(3);
+    cout << "\n=== List Layouts (" << n << " jobs, unrolled nodes of 32: " << unrolled.getNodeCount() << ") ===" << endl;
+    cout << "Layout     | Build ms  | Scan ms   | Index us  | Mid update us" << endl;
+    cout << "Linked     | " << setw(9) << linkedBuild << " | " << setw(9) << linkedScan << " | " << setw(9) << linkedLookup
+         << " | n/a" << endl;
+    cout << "Unrolled   | " << setw(9) << unrolledBuild << " | " << setw(9) << unrolledScan << " | " << setw(9) << unrolledLookup
+         << " | " << unrolledUpdate << " (insert/remove)" << endl;
+    cout << "Array      | " << setw(9) << arrayBuild << " | " << setw(9) << arrayScan << " | " << setw(9) << arrayLookup
+         << " | " << arrayUpdate << " (remove)" << endl;
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+}
+
 // --- Linear Search Functions (From your code) ---
 
 void testLinearSearchJobs(LinkedListDataStorage& dataStorage) {
@@ -39,15 +223,16 @@ void testLinearSearchJobs(LinkedListDataStorage& dataStorage) {
     cout << "Searching for: \"" << searchTitle << "\"..." << endl;
     auto start = chrono::high_resolution_clock::now();
     
-    CustomLinkedList<Job> searchJobsTitleList = dataStorage.linearSearchJobsByTitle(searchTitle);
+    HandleQueryResult<Job> searchJobsTitleList;
+    dataStorage.queryJobsByTitle(searchTitle, searchJobsTitleList);
     
     auto end = chrono::high_resolution_clock::now();
     auto duration = chrono::duration_cast<chrono::microseconds>(end - start);
 
-    if (searchJobsTitleList.getSize() > 0) {
-        cout << "\n[SUCCESS] Found " << searchJobsTitleList.getSize() << " job(s) matching \"" << searchTitle << "\"." << endl;
-        for (int i = 0; i < searchJobsTitleList.getSize(); ++i) {
-            const Job& job = searchJobsTitleList[i];
+    if (searchJobsTitleList.size() > 0) {
+        cout << "\n[SUCCESS] Found " << searchJobsTitleList.size() << " job(s) matching \"" << searchTitle << "\"." << endl;
+        for (int i = 0; i < searchJobsTitleList.size(); ++i) {
+            const Job& job = *searchJobsTitleList.items[i];
             cout << "\nJob Match #" << i + 1 << ":" << endl;
             job.display(); 
         }
@@ -70,20 +255,33 @@ void testLinearSearchJobsBySkill(LinkedListDataStorage& dataStorage) {
     cout << "Searching for jobs with skill: \"" << searchSkill << "\"..." << endl;
     auto start = chrono::high_resolution_clock::now();
     
-    CustomLinkedList<Job> searchJobsSkillList = dataStorage.linearSearchJobsBySkills(searchSkill);
+    HandleQueryResult<Job> searchJobsSkillList;
+    int skillId = dataStorage.resolveSkillId(searchSkill);
+    if (skillId != SKILL_TRIE_NONE) dataStorage.queryJobsBySkillId(skillId, searchJobsSkillList);
     
     auto end = chrono::high_resolution_clock::now();
     auto duration = chrono::duration_cast<chrono::microseconds>(end - start);
+    if (skillId != SKILL_TRIE_NONE && strcmp(dataStorage.getSkillName(skillId).c_str(), searchSkill.c_str()) != 0) {
+        cout << "Matched skill: \"" << dataStorage.getSkillName(skillId) << "\"" << endl;
+        searchSkill = dataStorage.getSkillName(skillId);
+    }
     
-    if (searchJobsSkillList.getSize() > 0) {
-        cout << "\n[SUCCESS] Found " << searchJobsSkillList.getSize() << " job(s) with the skill \"" << searchSkill << "\"." << endl;
-        for (int i = 0; i < searchJobsSkillList.getSize(); ++i) {
-            const Job& job = searchJobsSkillList[i];
+    if (searchJobsSkillList.size() > 0) {
+        cout << "\n[SUCCESS] Found " << searchJobsSkillList.size() << " job(s) with the skill \"" << searchSkill << "\"." << endl;
+        for (int i = 0; i < searchJobsSkillList.size(); ++i) {
+            const Job& job = *searchJobsSkillList.items[i];
             cout << "\nJob Match #" << i + 1 << ":" << endl;
             job.display(); 
         }
     } else {
         cout << "[NOT FOUND] No job with the skill \"" << searchSkill << "\" was found." << endl;
+        CustomArray<int> completions;
+        dataStorage.completeSkill(searchSkill, 5, completions);
+        if (completions.size() > 0) {
+            cout << "Skills starting with \"" << searchSkill << "\":";
+            for (int i = 0; i < completions.size(); i++) cout << " \"" << dataStorage.getSkillName(completions[i]) << "\"";
+            cout << endl;
+        }
     }
     cout << "\nSearch Time: " << duration.count() << " microseconds." << endl;
 }
@@ -101,15 +299,16 @@ void testLinearSearchResumesBySkill(LinkedListDataStorage& dataStorage) {
     cout << "Searching for resumes with skill: \"" << searchSkill << "\"..." << endl;
     auto start = chrono::high_resolution_clock::now();
     
-    CustomLinkedList<Resume> searchResumeSkillList = dataStorage.linearSearchResumesBySkills(searchSkill);
+    HandleQueryResult<Resume> searchResumeSkillList;
+    dataStorage.queryResumesBySkill(searchSkill, searchResumeSkillList);
     
     auto end = chrono::high_resolution_clock::now();
     auto duration = chrono::duration_cast<chrono::microseconds>(end - start);
     
-    if (searchResumeSkillList.getSize() > 0) {
-        cout << "\n[SUCCESS] Found " << searchResumeSkillList.getSize() << " resume(s) with the skill \"" << searchSkill << "\"." << endl;
-        for (int i = 0; i < searchResumeSkillList.getSize(); ++i) {
-            const Resume& resume = searchResumeSkillList[i];
+    if (searchResumeSkillList.size() > 0) {
+        cout << "\n[SUCCESS] Found " << searchResumeSkillList.size() << " resume(s) with the skill \"" << searchSkill << "\"." << endl;
+        for (int i = 0; i < searchResumeSkillList.size(); ++i) {
+            const Resume& resume = *searchResumeSkillList.items[i];
             cout << "\nResume Match #" << i + 1 << ":" << endl;
             resume.display(); 
         }
@@ -121,11 +320,72 @@ void testLinearSearchResumesBySkill(LinkedListDataStorage& dataStorage) {
 
 // --- Search Sub-Menu 
 
+// --- Indexed Search Functions (skip list over the job nodes) ---
+
+void testIndexedSearchJobs(LinkedListDataStorage& dataStorage) {
+    cout << "\n--- Indexed Search by Job Title ---" << endl;
+    cout << "Enter the Job Title to search for: ";
+
+    string searchTitleStr;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    getline(cin, searchTitleStr);
+    CustomString searchTitle(searchTitleStr.c_str());
+
+    // The first query builds the index; time it separately
+    auto buildStart = chrono::high_resolution_clock::now();
+    const SkipListIndex<Job, JobTitleKey>& index = dataStorage.getJobTitleIndex();
+    auto buildEnd = chrono::high_resolution_clock::now();
+
+    HandleQueryResult<Job> indexed;
+    auto start = chrono::high_resolution_clock::now();
+    dataStorage.queryJobsByTitleIndexed(searchTitle, indexed);
+    auto end = chrono::high_resolution_clock::now();
+
+    HandleQueryResult<Job> linear;
+    auto linearStart = chrono::high_resolution_clock::now();
+    dataStorage.queryJobsByTitle(searchTitle, linear);
+    auto linearEnd = chrono::high_resolution_clock::now();
+
+    cout << "Found " << indexed.size() << " job(s) titled \"" << searchTitle << "\"" << endl;
+    for (int i = 0; i < indexed.size() && i < 5; i++) {
+        cout << "  Job " << indexed.items[i]->id << ": " << indexed.items[i]->jobTitle << endl;
+    }
+    cout << "Skip list (" << index.getSize() << " entries, " << index.getLevel() << " levels): "
+         << chrono::duration_cast<chrono::microseconds>(end - start).count() << " microseconds, index ready in "
+         << chrono::duration_cast<chrono::milliseconds>(buildEnd - buildStart).count() << " ms" << endl;
+    cout << "Linear search: " << linear.size() << " job(s) in "
+         << chrono::duration_cast<chrono::microseconds>(linearEnd - linearStart).count() << " microseconds" << endl;
+}
+
+void testSkillCountRange(LinkedListDataStorage& dataStorage) {
+    int low, high;
+    cout << "\nEnter minimum and maximum skill count: ";
+    if (!(cin >> low >> high)) {
+        cout << "Invalid range" << endl;
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        return;
+    }
+
+    HandleQueryResult<Job> matches;
+    auto start = chrono::high_resolution_clock::now();
+    dataStorage.queryJobsBySkillCountRange(low, high, matches);
+    auto end = chrono::high_resolution_clock::now();
+
+    cout << "Found " << matches.size() << " job(s) with " << low << "-" << high << " skills" << endl;
+    for (int i = 0; i < matches.size() && i < 5; i++) {
+        cout << "  Job " << matches.items[i]->id << ": " << matches.items[i]->skillCount << " skills" << endl;
+    }
+    cout << "Range scan time: " << chrono::duration_cast<chrono::microseconds>(end - start).count() << " microseconds." << endl;
+}
+
 void displaySearchMenu() {
     cout << "\n--- Linear Search Menu ---" << endl;
     cout << "1. Search Jobs by Title" << endl;
     cout << "2. Search Jobs by Skill" << endl;
     cout << "3. Search Resumes by Skill" << endl;
+    cout << "4. Search Jobs by Title (Skip List Index)" << endl;
+    cout << "5. Jobs by Skill Count Range (Skip List Index)" << endl;
     cout << "0. Back to Main Menu" << endl;
     cout << "--------------------------" << endl;
     cout << "Enter your choice: ";
@@ -159,6 +419,12 @@ void handleSearchMenu(LinkedListDataStorage& dataStorage) {
             case 3:
                 testLinearSearchResumesBySkill(dataStorage);
                 break;
+            case 4:
+                testIndexedSearchJobs(dataStorage);
+                break;
+            case 5:
+                testSkillCountRange(dataStorage);
+                break;
             case 0:
                 cout << "Returning to main menu..." << endl;
                 break;
@@ -293,11 +559,33 @@ void runLinkedListMenu() {
                 dataStorage.runPerformanceTests();
                 break;
                 break;
+            case 7:
+                dataStorage.saveSnapshot(LINKEDLIST_SNAPSHOT_FILE);
+                break;
+            case 8:
+                cout << "\nLoading snapshot " << LINKEDLIST_SNAPSHOT_FILE << "..." << endl;
+                dataStorage.loadFromSnapshot(LINKEDLIST_SNAPSHOT_FILE);
+                break;
+            case 9:
+                dataStorage.ingestNewRows("csv/job_description.csv", "csv/resume.csv");
+                break;
+            case 10:
+                printSnapshotReaderBenchmark(dataStorage.getPublishedStore());
+                break;
+            case 11:
+                runScorerComparison(dataStorage);
+                break;
+            case 12:
+                runLshBenchmark(dataStorage);
+                break;
+            case 13:
+                runListLayoutBenchmark(dataStorage);
+                break;
             case 0:
                 cout << "\nExiting Job Matching System. Goodbye!" << endl;
                 break;
             default:
-                cout << "\n[INVALID CHOICE] Please select a valid option (0-7)." << endl;
+                cout << "\n[INVALID CHOICE] Please select a valid option (0-13)." << endl;
                 break;
         }
     } while (choice != 0);
@@ -0,0 +1,407 @@
+#pragma once
+#include "model.hpp"
+#include "hashmap.hpp"
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+#include <exception>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+
+using namespace std;
+
+// Work-stealing thread pool shared by loading, sorting and matching.
+//
+// Every worker owns a deque: it pushes and pops its own tasks at the back
+// and idle workers steal from the front of the others. Threads that are not
+// workers (the menu thread) submit to an extra injection deque. A thread that
+// waits on a TaskGroup runs pending tasks while it waits, so parallel
+// primitives can be nested without deadlocking.
+//
+// Worker count: JOBMATCH_WORKERS environment variable, otherwise the hardware
+// thread count; setThreadPoolWorkers() changes it at runtime.
+
+class ThreadPool;
+
+struct TaskGroup;
+
+struct PoolTask {
+    function<void()> work;
+    TaskGroup* group;
+};
+
+// Mutex-guarded ring buffer of tasks. The owner uses the back, thieves the front.
+class WorkDeque {
+private:
+    mutex lock;
+    PoolTask** items;
+    int capacity;
+    int head;
+    int count;
+
+    void grow() {
+        int newCapacity = capacity * 2;
+        PoolTask** newItems = new PoolTask*[newCapacity];
+        for (int i = 0; i < count; i++) newItems[i] = items[(head + i) % capacity];
+        delete[] items;
+        items = newItems;
+        capacity = newCapacity;
+        head = 0;
+    }
+
+public:
+    WorkDeque() : items(new PoolTask*[64]), capacity(64), head(0), count(0) {}
+    ~WorkDeque() { delete[] items; }
+
+    WorkDeque(const WorkDeque&) = delete;
+    WorkDeque& operator=(const WorkDeque&) = delete;
+
+    void pushBack(PoolTask* task) {
+        lock_guard<mutex> guard(lock);
+        if (count == capacity) grow();
+        items[(head + count) % capacity] = task;
+        count++;
+    }
+
+    PoolTask* popBack() {
+        lock_guard<mutex> guard(lock);
+        if (count == 0) return nullptr;
+        count--;
+        return items[(head + count) % capacity];
+    }
+
+    PoolTask* stealFront() {
+        lock_guard<mutex> guard(lock);
+        if (count == 0) return nullptr;
+        PoolTask* task = items[head];
+        head = (head + 1) % capacity;
+        count--;
+        return task;
+    }
+};
+
+// Per-worker counters (the last entry belongs to non-worker threads)
+struct WorkerStats {
+    atomic<long long> tasksRun;
+    atomic<long long> steals;
+    atomic<long long> busyNanos;
+
+    WorkerStats() : tasksRun(0), steals(0), busyNanos(0) {}
+};
+
+// Aggregated timing of one named parallel region (e.g. "preprocess.jobs")
+struct ParallelRegionTiming {
+    long long calls;
+    long long tasks;
+    double wallMs;
+    double taskMs;       // summed over tasks; taskMs / wallMs ~ achieved parallelism
+    double maxTaskMs;    // slowest single task, shows imbalance
+
+    ParallelRegionTiming() : calls(0), tasks(0), wallMs(0), taskMs(0), maxTaskMs(0) {}
+};
+
+// Tasks spawned together and waited on together. The first exception thrown
+// by a task is rethrown from wait().
+struct TaskGroup {
+    ThreadPool& pool;
+    atomic<int> pending;
+    mutex errorLock;
+    exception_ptr error;
+
+    explicit TaskGroup(ThreadPool& owner) : pool(owner), pending(0) {}
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void spawn(function<void()> work);
+    void wait();
+};
+
+class ThreadPool {
+private:
+    int workerCount;
+    thread** threads;
+    WorkDeque* deques;              // workerCount + 1, the last one for external threads
+    WorkerStats* stats;             // workerCount + 1
+    atomic<bool> stopping;
+    atomic<int> queued;
+    mutex sleepLock;
+    condition_variable wake;
+    mutex timingLock;
+    CustomHashMap<CustomString, ParallelRegionTiming> regionTimings;
+
+    // Worker slot of the calling thread in this pool, or workerCount if it isn't one
+    int currentSlot() const {
+        return currentPool() == this ? currentWorker() : workerCount;
+    }
+
+    static const ThreadPool*& currentPool() {
+        static thread_local const ThreadPool* pool = nullptr;
+        return pool;
+    }
+
+    static int& currentWorker() {
+        static thread_local int worker = -1;
+        return worker;
+    }
+
+    void workerLoop(int index) {
+        currentPool() = this;
+        currentWorker() = index;
+        while (!stopping.load()) {
+            if (runOne()) continue;
+            unique_lock<mutex> guard(sleepLock);
+            wake.wait(guard, [this] { return queued.load() > 0 || stopping.load(); });
+        }
+    }
+
+    void execute(PoolTask* task, int slot) {
+        auto start = chrono::steady_clock::now();
+        try {
+            task->work();
+        } catch (...) {
+            lock_guard<mutex> guard(task->group->errorLock);
+            if (!task->group->error) task->group->error = current_exception();
+        }
+        auto end = chrono::steady_clock::now();
+        stats[slot].tasksRun.fetch_add(1, memory_order_relaxed);
+        stats[slot].busyNanos.fetch_add(chrono::duration_cast<chrono::nanoseconds>(end - start).count(),
+                                        memory_order_relaxed);
+        TaskGroup* group = task->group;
+        delete task;
+        group->pending.fetch_sub(1);
+    }
+
+public:
+    explicit ThreadPool(int workers) : workerCount(max(1, workers)), stopping(false), queued(0) {
+        deques = new WorkDeque[workerCount + 1];
+        stats = new WorkerStats[workerCount + 1];
+        threads = new thread*[workerCount];
+        for (int i = 0; i < workerCount; i++) {
+            threads[i] = new thread(&ThreadPool::workerLoop, this, i);
+        }
+    }
+
+    // Tasks still queued at shutdown are abandoned; wait on every group first
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> guard(sleepLock);
+            stopping.store(true);
+        }
+        wake.notify_all();
+        for (int i = 0; i < workerCount; i++) {
+            threads[i]->join();
+            delete threads[i];
+        }
+        delete[] threads;
+        delete[] deques;
+        delete[] stats;
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int getWorkerCount() const { return workerCount; }
+
+    void submit(PoolTask* task) {
+        deques[currentSlot()].pushBack(task);
+        queued.fetch_add(1);
+        { lock_guard<mutex> guard(sleepLock); }
+        wake.notify_one();
+    }
+
+    // Run one pending task: own deque first, then steal. False if none was found.
+    bool runOne() {
+        int slot = currentSlot();
+        PoolTask* task = deques[slot].popBack();
+        if (task == nullptr) {
+            for (int i = 1; i <= workerCount && task == nullptr; i++) {
+                task = deques[(slot + i) % (workerCount + 1)].stealFront();
+            }
+            if (task != nullptr) stats[slot].steals.fetch_add(1, memory_order_relaxed);
+        }
+        if (task == nullptr) return false;
+        queued.fetch_sub(1);
+        execute(task, slot);
+        return true;
+    }
+
+    void recordRegion(const char* label, long long tasks, double wallMs, double taskMs, double maxTaskMs) {
+        lock_guard<mutex> guard(timingLock);
+        CustomString key(label);
+        ParallelRegionTiming* timing = regionTimings.find(key);
+        if (timing == nullptr) timing = &regionTimings.insert(key, ParallelRegionTiming());
+        timing->calls++;
+        timing->tasks += tasks;
+        timing->wallMs += wallMs;
+        timing->taskMs += taskMs;
+        timing->maxTaskMs = max(timing->maxTaskMs, maxTaskMs);
+    }
+
+    void resetStats() {
+        lock_guard<mutex> guard(timingLock);
+        regionTimings.clear();
+        for (int i = 0; i <= workerCount; i++) {
+            stats[i].tasksRun.store(0);
+            stats[i].steals.store(0);
+            stats[i].busyNanos.store(0);
+        }
+    }
+
+    void printStats() {
+        cout << "\n=== Thread Pool (" << workerCount << " workers) ===" << endl;
+        cout << "Worker | Tasks      | Steals     | Busy ms" << endl;
+        for (int i = 0; i <= workerCount; i++) {
+            if (i == workerCount) cout << "  ext  | ";
+            else cout << setw(6) << i << " | ";
+            cout << setw(10) << stats[i].tasksRun.load() << " | " << setw(10) << stats[i].steals.load() << " | "
+                 << fixed << setprecision(2) << stats[i].busyNanos.load() / 1e6 << endl;
+        }
+        lock_guard<mutex> guard(timingLock);
+        if (regionTimings.empty()) return;
+        cout << "\nRegion                     | Calls | Tasks   | Wall ms   | Task ms   | Max task ms | Parallelism" << endl;
+        regionTimings.forEach([](const CustomString& label, const ParallelRegionTiming& t) {
+            cout << left << setw(26) << label.c_str() << right << " | " << setw(5) << t.calls << " | "
+                 << setw(7) << t.tasks << " | " << setw(9) << fixed << setprecision(2) << t.wallMs << " | "
+                 << setw(9) << t.taskMs << " | " << setw(11) << t.maxTaskMs << " | "
+                 << setprecision(2) << (t.wallMs > 0 ? t.taskMs / t.wallMs : 0.0) << "x" << endl;
+        });
+    }
+};
+
+inline TaskGroup::~TaskGroup() {
+    // Never leave tasks behind that point at a dead group
+    while (pending.load() > 0) {
+        if (!pool.runOne()) this_thread::yield();
+    }
+}
+
+inline void TaskGroup::spawn(function<void()> work) {
+    pending.fetch_add(1);
+    pool.submit(new PoolTask{work, this});
+}
+
+inline void TaskGroup::wait() {
+    while (pending.load() > 0) {
+        if (!pool.runOne()) this_thread::yield();
+    }
+    if (error) {
+        exception_ptr failure = error;
+        error = nullptr;
+        rethrow_exception(failure);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Shared pool and configuration
+// ---------------------------------------------------------------------------
+
+inline int defaultWorkerCount() {
+    const char* configured = getenv("JOBMATCH_WORKERS");
+    if (configured != nullptr && atoi(configured) > 0) return atoi(configured);
+    int hardware = static_cast<int>(thread::hardware_concurrency());
+    return hardware > 0 ? hardware : 1;
+}
+
+inline ThreadPool*& sharedThreadPoolSlot() {
+    static ThreadPool* pool = nullptr;
+    return pool;
+}
+
+inline mutex& sharedThreadPoolLock() {
+    static mutex lock;
+    return lock;
+}
+
+inline ThreadPool& threadPool() {
+    lock_guard<mutex> guard(sharedThreadPoolLock());
+    ThreadPool*& pool = sharedThreadPoolSlot();
+    if (pool == nullptr) pool = new ThreadPool(defaultWorkerCount());
+    return *pool;
+}
+
+// Replace the shared pool. Call only while no parallel work is running.
+inline void setThreadPoolWorkers(int workers) {
+    lock_guard<mutex> guard(sharedThreadPoolLock());
+    ThreadPool*& pool = sharedThreadPoolSlot();
+    delete pool;
+    pool = new ThreadPool(workers > 0 ? workers : defaultWorkerCount());
+}
+
+// ---------------------------------------------------------------------------
+// Parallel primitives
+// ---------------------------------------------------------------------------
+
+// Chunk size giving each worker several chunks to balance uneven work
+inline int autoGrainSize(int count, int workers) {
+    int grain = count / (workers * 8);
+    return grain > 0 ? grain : 1;
+}
+
+// Calls body(chunkBegin, chunkEnd) over [begin, end) split into chunks of grain
+// items (grain <= 0 picks one). Blocks until every chunk has run.
+template<typename Body>
+void parallelFor(int begin, int end, int grain, Body body, const char* label = "parallel_for") {
+    if (end <= begin) return;
+    ThreadPool& pool = threadPool();
+    if (grain <= 0) grain = autoGrainSize(end - begin, pool.getWorkerCount());
+
+    auto wallStart = chrono::steady_clock::now();
+    int chunks = (end - begin + grain - 1) / grain;
+    atomic<long long> taskNanos(0);
+    atomic<long long> maxTaskNanos(0);
+    auto runChunk = [&](int chunkBegin, int chunkEnd) {
+        auto start = chrono::steady_clock::now();
+        body(chunkBegin, chunkEnd);
+        auto finish = chrono::steady_clock::now();
+#if INSTRUMENTATION_ENABLED
+        recordTimer(label, start, finish);
+#endif
+        long long nanos = chrono::duration_cast<chrono::nanoseconds>(finish - start).count();
+        taskNanos.fetch_add(nanos, memory_order_relaxed);
+        long long seen = maxTaskNanos.load(memory_order_relaxed);
+        while (nanos > seen && !maxTaskNanos.compare_exchange_weak(seen, nanos, memory_order_relaxed)) {}
+    };
+
+    if (chunks == 1 || pool.getWorkerCount() == 1) {
+        for (int chunkBegin = begin; chunkBegin < end; chunkBegin += grain)
+            runChunk(chunkBegin, min(end, chunkBegin + grain));
+    } else {
+        TaskGroup group(pool);
+        for (int chunkBegin = begin; chunkBegin < end; chunkBegin += grain) {
+            int chunkEnd = min(end, chunkBegin + grain);
+            group.spawn([&runChunk, chunkBegin, chunkEnd] { runChunk(chunkBegin, chunkEnd); });
+        }
+        group.wait();
+    }
+
+    double wallMs = chrono::duration<double, milli>(chrono::steady_clock::now() - wallStart).count();
+    pool.recordRegion(label, chunks, wallMs, taskNanos.load() / 1e6, maxTaskNanos.load() / 1e6);
+}
+
+// Reduces [begin, end): map(chunkBegin, chunkEnd) produces one value per chunk
+// and combine(acc, value) folds them in chunk order, so the result is the same
+// as a sequential left fold whatever the worker count.
+template<typename T, typename Map, typename Combine>
+T parallelReduce(int begin, int end, int grain, T identity, Map map, Combine combine,
+                 const char* label = "parallel_reduce") {
+    if (end <= begin) return identity;
+    if (grain <= 0) grain = autoGrainSize(end - begin, threadPool().getWorkerCount());
+    int chunks = (end - begin + grain - 1) / grain;
+    T* partials = new T[chunks];
+    parallelFor(0, chunks, 1, [&](int first, int last) {
+        for (int c = first; c < last; c++) {
+            int chunkBegin = begin + c * grain;
+            partials[c] = map(chunkBegin, min(end, chunkBegin + grain));
+        }
+    }, label);
+    T result = identity;
+    for (int c = 0; c < chunks; c++) result = combine(result, partials[c]);
+    delete[] partials;
+    return result;
+}
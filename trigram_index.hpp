@@ -0,0 +1,323 @@
+#pragma once
+#include "model.hpp"
+#include "array.hpp"
+#include "hashmap.hpp"
+#include "query.hpp"
+#include "snapshot_section.hpp"
+#include <cstring>
+
+using namespace std;
+
+// Trigram index over the lower-cased job titles for substring queries.
+//
+// Every distinct three-byte window of a title adds the job's position to that
+// trigram's postings, stored back to back in one array (postingStart holds
+// each trigram's offset plus an end marker), so postings are in job order.
+// A keyword of three or more bytes can only occur in titles that hold all of
+// its trigrams: the postings are intersected from the shortest up, galloping
+// through the longer ones, and the few survivors are checked with strstr,
+// which also rules out trigrams that occur apart. Work follows the rarest
+// trigram of the keyword instead of the number of jobs. Shorter keywords have
+// no trigram and fall back to scanning every title.
+//
+// Ingest appends: the new rows' postings go to a tail per trigram, behind the
+// packed ones, and the tails are folded into the packed array once they hold
+// a quarter as many postings, so appends cost amortised O(1) per trigram. A
+// reorder maps every posting to its job's new position in one counting pass
+// instead of re-reading the titles.
+
+class TrigramIndex {
+private:
+    CustomHashMap<int, int> trigramIds;     // packed trigram -> id
+    CustomArray<int> postingStart;          // offset of each trigram's postings, plus an end marker
+    CustomArray<int> postingRows;           // job positions, ascending per trigram
+    CustomArray<CustomArray<int>> tailRows; // positions appended since the last compaction, per trigram
+    int tailCount;
+    int jobCount;
+
+    // Postings of one trigram: the packed ones, then its tail
+    struct Postings {
+        const int* packed;
+        int packedLength;
+        const CustomArray<int>* tail;
+
+        int size() const { return packedLength + tail->size(); }
+        int operator[](int k) const { return k < packedLength ? packed[k] : (*tail)[k - packedLength]; }
+    };
+
+    Postings postingsOf(int id) const {
+        Postings list;
+        list.packed = postingRows.size() > 0 ? &postingRows[postingStart[id]] : nullptr;
+        list.packedLength = postingStart[id + 1] - postingStart[id];
+        list.tail = &tailRows[id];
+        return list;
+    }
+
+    static int pack(const char* text) {
+        return (static_cast<unsigned char>(text[0]) << 16) | (static_cast<unsigned char>(text[1]) << 8)
+            | static_cast<unsigned char>(text[2]);
+    }
+
+    // Call fn(trigram) once per window of title; repeats within a title are
+    // filtered by the caller
+    template<typename Fn>
+    static void forEachTrigram(const CustomString& title, Fn fn) {
+        const char* text = title.c_str();
+        if (text == nullptr) return;
+        int len = title.size();
+        for (int i = 0; i + 3 <= len; i++) fn(pack(text + i));
+    }
+
+    // First index >= from of list holding a row >= target
+    static int gallop(const Postings& list, int from, int target) {
+        int end = list.size();
+        int step = 1;
+        int low = from;
+        int high = from;
+        while (high < end && list[high] < target) {
+            low = high + 1;
+            high += step;
+            step *= 2;
+        }
+        if (high > end) high = end;
+        while (low < high) {
+            int mid = low + (high - low) / 2;
+            if (list[mid] < target) low = mid + 1;
+            else high = mid;
+        }
+        return low;
+    }
+
+    // Fold the tails into the packed postings
+    void compact() {
+        if (tailCount == 0) return;
+        CustomArray<int> packed;
+        packed.resize(postingRows.size() + tailCount);
+        int next = 0;
+        for (int id = 0; id < tailRows.size(); id++) {
+            int begin = postingStart[id];
+            int end = postingStart[id + 1];
+            postingStart[id] = next;
+            for (int p = begin; p < end; p++) packed[next++] = postingRows[p];
+            for (int p = 0; p < tailRows[id].size(); p++) packed[next++] = tailRows[id][p];
+            tailRows[id].clear();
+        }
+        postingStart[tailRows.size()] = next;
+        postingRows = move(packed);
+        tailCount = 0;
+    }
+
+public:
+    TrigramIndex() : tailCount(0), jobCount(0) {
+        postingStart.push_back(0);
+    }
+
+    void clear() {
+        trigramIds.clear();
+        postingStart.clear();
+        postingStart.push_back(0);
+        postingRows.clear();
+        tailRows.clear();
+        tailCount = 0;
+        jobCount = 0;
+    }
+
+    // Index the lowerCaseTitle of every job; two passes, count then fill
+    void build(const CustomArrayV2<Job>& jobs) {
+        clear();
+        jobCount = jobs.getSize();
+        CustomArray<int> counts;
+        CustomArray<int> lastRow;           // last job counted per trigram, drops repeats
+        for (int row = 0; row < jobs.getSize(); row++) {
+            forEachTrigram(jobs[row].lowerCaseTitle, [&](int trigram) {
+                const int* id = trigramIds.find(trigram);
+                if (id == nullptr) {
+                    trigramIds.insert(trigram, counts.size());
+                    counts.push_back(1);
+                    lastRow.push_back(row);
+                } else if (lastRow[*id] != row) {
+                    counts[*id]++;
+                    lastRow[*id] = row;
+                }
+            });
+        }
+
+        postingStart.resize(counts.size() + 1);
+        postingStart[0] = 0;
+        for (int i = 0; i < counts.size(); i++) {
+            postingStart[i + 1] = postingStart[i] + counts[i];
+            counts[i] = postingStart[i];    // reused as the fill cursor
+            lastRow[i] = -1;
+        }
+        postingRows.resize(postingStart[counts.size()]);
+        for (int row = 0; row < jobs.getSize(); row++) {
+            forEachTrigram(jobs[row].lowerCaseTitle, [&](int trigram) {
+                int id = *trigramIds.find(trigram);
+                if (lastRow[id] == row) return;
+                lastRow[id] = row;
+                postingRows[counts[id]++] = row;
+            });
+        }
+        tailRows.resize(counts.size());
+    }
+
+    // Index the jobs past the last indexed position, appended since
+    void append(const CustomArrayV2<Job>& jobs) {
+        for (int row = jobCount; row < jobs.getSize(); row++) {
+            forEachTrigram(jobs[row].lowerCaseTitle, [&](int trigram) {
+                const int* found = trigramIds.find(trigram);
+                int id;
+                if (found == nullptr) {
+                    id = tailRows.size();
+                    trigramIds.insert(trigram, id);
+                    int end = postingStart[id];     // push_back may move the array
+                    postingStart.push_back(end);
+                    tailRows.push_back(CustomArray<int>());
+                } else {
+                    id = *found;
+                }
+                CustomArray<int>& tail = tailRows[id];
+                if (tail.size() > 0 && tail[tail.size() - 1] == row) return;
+                tail.push_back(row);
+                tailCount++;
+            });
+        }
+        jobCount = jobs.getSize();
+        if (tailCount > postingRows.size() / 4) compact();
+    }
+
+    // The jobs were reordered: the job at old position p is now at
+    // newPosition[p]. Postings are regrouped by new position, one counting
+    // pass, so each trigram's stay ascending.
+    void remap(const CustomArray<int>& newPosition) {
+        compact();
+        CustomArray<int> rowStart;          // postings of each new position, as trigram ids
+        rowStart.resize(jobCount + 1);
+        for (int p = 0; p < postingRows.size(); p++) rowStart[newPosition[postingRows[p]] + 1]++;
+        for (int row = 0; row < jobCount; row++) rowStart[row + 1] += rowStart[row];
+        CustomArray<int> trigramsByRow;
+        trigramsByRow.resize(postingRows.size());
+        for (int id = 0; id < tailRows.size(); id++) {
+            for (int p = postingStart[id]; p < postingStart[id + 1]; p++)
+                trigramsByRow[rowStart[newPosition[postingRows[p]]]++] = id;
+        }
+
+        // rowStart[row] now ends row's postings; refill each trigram's range in row order
+        CustomArray<int> cursor;
+        cursor.resize(tailRows.size());
+        for (int id = 0; id < tailRows.size(); id++) cursor[id] = postingStart[id];
+        int p = 0;
+        for (int row = 0; row < jobCount; row++) {
+            for (; p < rowStart[row]; p++) postingRows[cursor[trigramsByRow[p]]++] = row;
+        }
+    }
+
+    // Positions of the jobs whose lowerCaseTitle contains lowerKey, in job
+    // order; jobs must be the array the index was built from
+    void query(const CustomArrayV2<Job>& jobs, const CustomString& lowerKey, QueryResult& out) const {
+        out.clear();
+        const char* key = lowerKey.c_str();
+        if (key == nullptr) return;
+        int keyLength = lowerKey.size();
+        if (keyLength < 3 || jobCount != jobs.getSize()) {
+            queryJobsByTitleKeyword(jobs, lowerKey, out);
+            return;
+        }
+
+        // Postings of the distinct trigrams, shortest first
+        CustomArray<int> ids;
+        CustomArray<Postings> lists;
+        for (int i = 0; i + 3 <= keyLength; i++) {
+            const int* id = trigramIds.find(pack(key + i));
+            if (id == nullptr) return;      // some trigram occurs in no title
+            bool seen = false;
+            for (int j = 0; j < ids.size() && !seen; j++) seen = ids[j] == *id;
+            if (seen) continue;
+            ids.push_back(*id);
+            lists.push_back(postingsOf(*id));
+        }
+        for (int i = 1; i < lists.size(); i++) {
+            Postings list = lists[i];
+            int j = i - 1;
+            while (j >= 0 && lists[j].size() > list.size()) {
+                lists[j + 1] = lists[j];
+                j--;
+            }
+            lists[j + 1] = list;
+        }
+
+        CustomArray<int> cursors;
+        cursors.resize(lists.size());
+        int verified = 0;
+        const Postings& shortest = lists[0];
+        for (int p = 0; p < shortest.size(); p++) {
+            int row = shortest[p];
+            bool inAll = true;
+            for (int i = 1; i < lists.size() && inAll; i++) {
+                cursors[i] = gallop(lists[i], cursors[i], row);
+                inAll = cursors[i] < lists[i].size() && lists[i][cursors[i]] == row;
+            }
+            if (!inAll) continue;
+            verified++;
+            const char* title = jobs[row].lowerCaseTitle.c_str();
+            if (title && strstr(title, key)) out.indices.push_back(row);
+        }
+        INSTRUMENT_COUNT(COUNTER_STRCMP, verified);
+    }
+
+    // Snapshot section: the trigrams by id and each one's postings, tail
+    // included, so a restore starts compacted
+    void save(SnapshotSectionWriter& out) const {
+        CustomArray<int> byId;
+        byId.resize(tailRows.size());
+        trigramIds.forEach([&](int trigram, int id) { byId[id] = trigram; });
+        CustomArray<int> start;
+        CustomArray<int> rows;
+        start.resize(tailRows.size() + 1);
+        rows.reserve(postingRows.size() + tailCount);
+        start[0] = 0;
+        for (int id = 0; id < tailRows.size(); id++) {
+            Postings list = postingsOf(id);
+            for (int k = 0; k < list.size(); k++) rows.push_back(list[k]);
+            start[id + 1] = rows.size();
+        }
+        out.putArray(byId);
+        out.putArray(start);
+        out.putArray(rows);
+        out.putValue(jobCount);
+    }
+
+    // Load a saved section over storeSize jobs: every trigram's postings must
+    // be ascending rows below storeSize. On false the index is left empty.
+    bool restore(SnapshotSectionReader& in, int storeSize) {
+        clear();
+        CustomArray<int> byId;
+        bool ok = in.getArray(byId) && in.getArray(postingStart) && in.getArray(postingRows) && in.getValue(jobCount)
+               && jobCount == storeSize && postingStart.size() == byId.size() + 1
+               && postingStart[0] == 0 && postingStart[byId.size()] == postingRows.size();
+        for (int id = 0; ok && id < byId.size(); id++) {
+            ok = postingStart[id + 1] >= postingStart[id] && postingStart[id + 1] <= postingRows.size();
+            for (int p = postingStart[id]; ok && p < postingStart[id + 1]; p++) {
+                ok = postingRows[p] >= 0 && postingRows[p] < jobCount && (p == postingStart[id] || postingRows[p] > postingRows[p - 1]);
+            }
+        }
+        trigramIds.reserve(byId.size());
+        for (int id = 0; ok && id < byId.size(); id++) {
+            ok = !trigramIds.contains(byId[id]);
+            trigramIds.insert(byId[id], id);
+        }
+        if (!ok) {
+            clear();
+            return in.fail();
+        }
+        tailRows.resize(byId.size());
+        return true;
+    }
+
+    int getTrigramCount() const { return postingStart.size() - 1; }
+    int getPostingCount() const { return postingRows.size() + tailCount; }
+    size_t getMemoryBytes() const {
+        return (postingStart.size() + getPostingCount()) * sizeof(int)
+            + getTrigramCount() * (sizeof(int) * 2 + sizeof(CustomArray<int>));
+    }
+};
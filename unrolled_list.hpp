@@ -0,0 +1,280 @@
+#pragma once
+#include "model.hpp"
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+// Unrolled linked list: each node holds up to Capacity elements in place.
+//
+// A scan reads Capacity neighbouring elements per pointer hop instead of one,
+// so traversal touches memory almost like an array while insert and remove
+// stay local to one node: a full node splits in half, a node that drops
+// below a quarter full is merged with (or refilled from) its successor.
+// Element addresses move on insert/remove, so unlike ListNode handles they
+// must not be kept across updates.
+
+template<typename T, int Capacity>
+class UnrolledNode {
+public:
+    T items[Capacity];
+    int count;
+    UnrolledNode<T, Capacity>* next;
+    UnrolledNode<T, Capacity>* prev;
+
+    UnrolledNode() : count(0), next(nullptr), prev(nullptr) {}
+};
+
+template<typename T, int Capacity = 32>
+class CustomUnrolledList {
+    static_assert(Capacity >= 4, "unrolled list nodes need room to split and merge");
+
+public:
+    typedef UnrolledNode<T, Capacity> Node;
+
+private:
+    Node* head;
+    Node* tail;
+    int size;
+    int nodeCount;
+
+    Node* appendNode() {
+        Node* node = new Node();
+        INSTRUMENT_COUNT(COUNTER_ALLOCATIONS, 1);
+        insertNodeAfter(tail, node);
+        return node;
+    }
+
+    // Link node after position (at the front when position is null)
+    void insertNodeAfter(Node* position, Node* node) {
+        node->prev = position;
+        node->next = position ? position->next : head;
+        if (node->next) node->next->prev = node;
+        else tail = node;
+        if (position) position->next = node;
+        else head = node;
+        nodeCount++;
+    }
+
+    void unlinkNode(Node* node) {
+        if (node->prev) node->prev->next = node->next;
+        else head = node->next;
+        if (node->next) node->next->prev = node->prev;
+        else tail = node->prev;
+        delete node;
+        nodeCount--;
+    }
+
+    // Node holding index, with the index inside it in offset
+    Node* locate(int index, int& offset) const {
+        if (index < 0 || index >= size) {
+            throw out_of_range("Index out of range");
+        }
+        Node* current;
+        int hops = 0;
+        if (index < size / 2) {
+            current = head;
+            while (index >= current->count) {
+                index -= current->count;
+                current = current->next;
+                hops++;
+            }
+        } else {
+            int fromBack = size - 1 - index;
+            current = tail;
+            while (fromBack >= current->count) {
+                fromBack -= current->count;
+                current = current->prev;
+                hops++;
+            }
+            index = current->count - 1 - fromBack;
+        }
+        INSTRUMENT_COUNT(COUNTER_NODE_HOPS, hops);
+        offset = index;
+        return current;
+    }
+
+    // Move the upper half of a full node into a new node after it
+    void split(Node* node) {
+        Node* upper = new Node();
+        INSTRUMENT_COUNT(COUNTER_ALLOCATIONS, 1);
+        int keep = node->count / 2;
+        for (int i = keep; i < node->count; i++) upper->items[i - keep] = move(node->items[i]);
+        upper->count = node->count - keep;
+        node->count = keep;
+        insertNodeAfter(node, upper);
+    }
+
+    // Restore the quarter-full minimum after a removal from node
+    void rebalance(Node* node) {
+        if (node->count == 0) {
+            unlinkNode(node);
+            return;
+        }
+        if (node->count >= Capacity / 4 || node->next == nullptr) return;
+        Node* successor = node->next;
+        if (node->count + successor->count <= Capacity) {
+            for (int i = 0; i < successor->count; i++) node->items[node->count + i] = move(successor->items[i]);
+            node->count += successor->count;
+            unlinkNode(successor);
+        } else {
+            // Borrow enough from the successor to even the two nodes out
+            int borrow = (successor->count - node->count) / 2;
+            for (int i = 0; i < borrow; i++) node->items[node->count + i] = move(successor->items[i]);
+            for (int i = borrow; i < successor->count; i++) successor->items[i - borrow] = move(successor->items[i]);
+            node->count += borrow;
+            successor->count -= borrow;
+        }
+    }
+
+public:
+    class iterator {
+    private:
+        Node* node;
+        int offset;
+
+    public:
+        iterator(Node* start, int position) : node(start), offset(position) {}
+
+        T& operator*() const { return node->items[offset]; }
+        T* operator->() const { return &node->items[offset]; }
+
+        iterator& operator++() {
+            if (++offset >= node->count) {
+                node = node->next;
+                offset = 0;
+            }
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const { return node == other.node && offset == other.offset; }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+    };
+
+    CustomUnrolledList() : head(nullptr), tail(nullptr), size(0), nodeCount(0) {}
+
+    ~CustomUnrolledList() {
+        clear();
+    }
+
+    CustomUnrolledList(const CustomUnrolledList& other) : head(nullptr), tail(nullptr), size(0), nodeCount(0) {
+        for (const Node* node = other.head; node != nullptr; node = node->next) {
+            for (int i = 0; i < node->count; i++) push_back(node->items[i]);
+        }
+    }
+
+    CustomUnrolledList(CustomUnrolledList&& other)
+        : head(other.head), tail(other.tail), size(other.size), nodeCount(other.nodeCount) {
+        other.head = other.tail = nullptr;
+        other.size = other.nodeCount = 0;
+    }
+
+    CustomUnrolledList& operator=(const CustomUnrolledList& other) {
+        if (this != &other) {
+            clear();
+            for (const Node* node = other.head; node != nullptr; node = node->next) {
+                for (int i = 0; i < node->count; i++) push_back(node->items[i]);
+            }
+        }
+        return *this;
+    }
+
+    CustomUnrolledList& operator=(CustomUnrolledList&& other) {
+        if (this != &other) {
+            clear();
+            head = other.head;
+            tail = other.tail;
+            size = other.size;
+            nodeCount = other.nodeCount;
+            other.head = other.tail = nullptr;
+            other.size = other.nodeCount = 0;
+        }
+        return *this;
+    }
+
+    void push_back(const T& item) {
+        if (tail == nullptr || tail->count == Capacity) appendNode();
+        tail->items[tail->count++] = item;
+        size++;
+    }
+
+    void push_back(T&& item) {
+        if (tail == nullptr || tail->count == Capacity) appendNode();
+        tail->items[tail->count++] = move(item);
+        size++;
+    }
+
+    // Insert before index (index == size appends); splits a full node
+    void insert(int index, const T& item) {
+        if (index == size) {
+            push_back(item);
+            return;
+        }
+        int offset;
+        Node* node = locate(index, offset);
+        if (node->count == Capacity) {
+            split(node);
+            if (offset >= node->count) {
+                offset -= node->count;
+                node = node->next;
+            }
+        }
+        for (int i = node->count; i > offset; i--) node->items[i] = move(node->items[i - 1]);
+        node->items[offset] = item;
+        node->count++;
+        size++;
+    }
+
+    // Remove the element at index; merges an underfull node with its successor
+    void remove(int index) {
+        int offset;
+        Node* node = locate(index, offset);
+        for (int i = offset; i < node->count - 1; i++) node->items[i] = move(node->items[i + 1]);
+        node->items[node->count - 1] = T();
+        node->count--;
+        size--;
+        rebalance(node);
+    }
+
+    int getSize() const {
+        return size;
+    }
+
+    bool empty() const {
+        return size == 0;
+    }
+
+    int getNodeCount() const {
+        return nodeCount;
+    }
+
+    void clear() {
+        while (head != nullptr) {
+            Node* temp = head;
+            head = head->next;
+            delete temp;
+        }
+        head = tail = nullptr;
+        size = 0;
+        nodeCount = 0;
+    }
+
+    T& operator[](int index) {
+        int offset;
+        Node* node = locate(index, offset);
+        return node->items[offset];
+    }
+
+    const T& operator[](int index) const {
+        int offset;
+        Node* node = locate(index, offset);
+        return node->items[offset];
+    }
+
+    Node* getHead() const {
+        return head;
+    }
+
+    iterator begin() const { return iterator(head, 0); }
+    iterator end() const { return iterator(nullptr, 0); }
+};
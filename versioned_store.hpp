@@ -0,0 +1,504 @@
+#pragma once
+#include "model.hpp"
+#include "array.hpp"
+#include "linkedlist.hpp"
+#include "matching.hpp"
+#include "query.hpp"
+#include "id_index.hpp"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+using namespace std;
+
+// Read-mostly job store with snapshot isolation.
+//
+// Each published version is an immutable view of the jobs, resumes and skillset.
+// Readers pin the current version without taking a lock: they claim a reader
+// slot tagged with the current epoch and load the version pointer. A writer
+// builds the next version privately, swaps the pointer and retires the old
+// version, which is freed only once no slot holds an epoch at or before its
+// retirement. Writers serialise among themselves but never wait for readers,
+// and readers never wait for writers.
+//
+// Versions share their records. Records sit in chunks of STORE_CHUNK_SIZE in
+// the order they entered the store, and each version holds the chunk pointers,
+// its record count and an order table giving the record at every position.
+// The storages report their changes (appended rows, a re-filtered resume, a
+// new order after a sort) and publish turns them into a version:
+//   - appends go past the record count of every published version, even into
+//     a chunk readers share, since no reader looks beyond its own count
+//   - changing a published record copies its chunk first
+//   - a sort rewrites the order table only
+// A publish therefore copies chunk pointers and the changed rows, not the
+// store. Chunks a version stops using are freed with the version it replaced.
+// matchScore is ranking scratch and keeps the value the record was stored with.
+
+const int STORE_CHUNK_SIZE = 256;
+
+struct StoreChunkBase {
+    virtual ~StoreChunkBase() {}
+};
+
+template<typename T>
+struct StoreChunk : StoreChunkBase {
+    T items[STORE_CHUNK_SIZE];
+};
+
+// One table as a version sees it: the chunks and how many records count
+template<typename T>
+struct StoreTableView {
+    CustomArray<const StoreChunk<T>*> chunks;
+    int count;
+
+    StoreTableView() : count(0) {}
+
+    const T& operator[](int index) const {
+        return chunks[index / STORE_CHUNK_SIZE]->items[index % STORE_CHUNK_SIZE];
+    }
+
+    int size() const { return count; }
+};
+
+// Writer side of one table. A chunk stays fresh, and may be written in
+// place, until the first version that can see it is published.
+template<typename T>
+class StoreTable {
+private:
+    CustomArray<StoreChunk<T>*> chunks;
+    CustomArray<char> fresh;
+    int count;
+
+public:
+    StoreTable() : count(0) {}
+
+    ~StoreTable() {
+        for (int i = 0; i < chunks.size(); i++) delete chunks[i];
+    }
+
+    StoreTable(const StoreTable&) = delete;
+    StoreTable& operator=(const StoreTable&) = delete;
+
+    int size() const { return count; }
+
+    int append(const T& item) {
+        if (count == chunks.size() * STORE_CHUNK_SIZE) {
+            chunks.push_back(new StoreChunk<T>());
+            fresh.push_back(1);
+        }
+        chunks[count / STORE_CHUNK_SIZE]->items[count % STORE_CHUNK_SIZE] = item;
+        return count++;
+    }
+
+    // Record at index for writing. Its chunk is copied first if a published
+    // version can see it; the original goes to garbage.
+    T& change(int index, CustomArray<StoreChunkBase*>& garbage) {
+        int chunk = index / STORE_CHUNK_SIZE;
+        if (!fresh[chunk]) {
+            StoreChunk<T>* copy = new StoreChunk<T>();
+            int used = min(STORE_CHUNK_SIZE, count - chunk * STORE_CHUNK_SIZE);
+            for (int i = 0; i < used; i++) copy->items[i] = chunks[chunk]->items[i];
+            garbage.push_back(chunks[chunk]);
+            chunks[chunk] = copy;
+            fresh[chunk] = 1;
+        }
+        return chunks[chunk]->items[index % STORE_CHUNK_SIZE];
+    }
+
+    // Appended and changed records are not visible yet, so they may be written
+    T& unpublished(int index) {
+        return chunks[index / STORE_CHUNK_SIZE]->items[index % STORE_CHUNK_SIZE];
+    }
+
+    // Drop every record; chunks a version can see go to garbage
+    void clear(CustomArray<StoreChunkBase*>& garbage) {
+        for (int i = 0; i < chunks.size(); i++) {
+            if (fresh[i]) delete chunks[i];
+            else garbage.push_back(chunks[i]);
+        }
+        chunks.clear();
+        fresh.clear();
+        count = 0;
+    }
+
+    // Snapshot for the next version; from here on every chunk is shared
+    void view(StoreTableView<T>& out) {
+        out.chunks.resize(chunks.size());
+        for (int i = 0; i < chunks.size(); i++) {
+            out.chunks[i] = chunks[i];
+            fresh[i] = 0;
+        }
+        out.count = count;
+    }
+};
+
+struct StoreVersion {
+    unsigned long long version;
+    StoreTableView<Job> jobRecords;           // in the order they entered the store
+    StoreTableView<int> jobOrder;             // record of each job position
+    StoreTableView<Resume> resumeRecords;
+    StoreTableView<int> resumeOrder;
+    StoreTableView<CustomString> validSkills;
+    CustomArray<StoreChunkBase*> garbage;     // chunks the next version dropped
+
+    StoreVersion() : version(0) {}
+
+    ~StoreVersion() {
+        for (int i = 0; i < garbage.size(); i++) delete garbage[i];
+    }
+
+    StoreVersion(const StoreVersion&) = delete;
+    StoreVersion& operator=(const StoreVersion&) = delete;
+
+    int getJobCount() const { return jobOrder.size(); }
+    int getResumeCount() const { return resumeOrder.size(); }
+    const Job& job(int position) const { return jobRecords[jobOrder[position]]; }
+    const Resume& resume(int position) const { return resumeRecords[resumeOrder[position]]; }
+};
+
+class VersionedJobStore;
+
+// Keeps one version alive for as long as it exists. Move-only.
+class StoreReadGuard {
+private:
+    const StoreVersion* snapshot;
+    atomic<unsigned long long>* slot;
+
+    friend class VersionedJobStore;
+    StoreReadGuard(const StoreVersion* pinned, atomic<unsigned long long>* readerSlot)
+        : snapshot(pinned), slot(readerSlot) {}
+
+public:
+    StoreReadGuard(StoreReadGuard&& other) : snapshot(other.snapshot), slot(other.slot) {
+        other.snapshot = nullptr;
+        other.slot = nullptr;
+    }
+
+    ~StoreReadGuard() { release(); }
+
+    StoreReadGuard(const StoreReadGuard&) = delete;
+    StoreReadGuard& operator=(const StoreReadGuard&) = delete;
+    StoreReadGuard& operator=(StoreReadGuard&&) = delete;
+
+    void release() {
+        if (slot) slot->store(0);
+        slot = nullptr;
+        snapshot = nullptr;
+    }
+
+    // nullptr until the first publish
+    const StoreVersion* get() const { return snapshot; }
+    const StoreVersion* operator->() const { return snapshot; }
+    const StoreVersion& operator*() const { return *snapshot; }
+};
+
+class VersionedJobStore {
+public:
+    static constexpr int MAX_READERS = 64;
+
+private:
+    // One cache line per slot so readers on different cores don't share lines
+    struct alignas(64) ReaderSlot {
+        atomic<unsigned long long> epoch;   // 0 = free, otherwise epoch at pin time
+    };
+
+    struct RetiredVersion {
+        StoreVersion* version;
+        unsigned long long epoch;
+        RetiredVersion() : version(nullptr), epoch(0) {}
+        RetiredVersion(StoreVersion* v, unsigned long long e) : version(v), epoch(e) {}
+    };
+
+    atomic<StoreVersion*> current;
+    mutable atomic<unsigned long long> globalEpoch;
+    mutable ReaderSlot readers[MAX_READERS];
+    CustomArrayV2<RetiredVersion> retired;          // guarded by writerMutex
+    mutex writerMutex;
+    KeywordMatcher keywordMatcher;
+    atomic<unsigned long long> publishedVersions;
+
+    // Writer-side tables and the changes since the last publish, guarded by writerMutex
+    StoreTable<Job> jobRecords;
+    StoreTable<int> jobOrder;
+    StoreTable<Resume> resumeRecords;
+    StoreTable<int> resumeOrder;
+    StoreTable<CustomString> validSkills;
+    DenseIdIndex<int> jobRecordById;
+    DenseIdIndex<int> resumeRecordById;
+    CustomArray<int> changedJobs;                   // records whose keyword mask is not filled yet
+    CustomArray<int> changedResumes;
+    CustomArray<StoreChunkBase*> garbage;           // chunks the current version still uses
+
+    // Free retired versions no pinned reader can still see
+    void reclaimLocked() {
+        unsigned long long oldestPinned = 0;
+        for (int i = 0; i < MAX_READERS; i++) {
+            unsigned long long e = readers[i].epoch.load();
+            if (e != 0 && (oldestPinned == 0 || e < oldestPinned)) oldestPinned = e;
+        }
+        for (int i = retired.getSize() - 1; i >= 0; i--) {
+            if (oldestPinned == 0 || retired[i].epoch < oldestPinned) {
+                delete retired[i].version;
+                retired.remove(i);
+            }
+        }
+    }
+
+    // Caller holds writerMutex
+    unsigned long long publishLocked() {
+        // Fill the keyword mask caches of new and changed records before
+        // readers can see them
+        parallelFor(0, changedJobs.size(), 0, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) keywordMatcher.maskFor(jobRecords.unpublished(changedJobs[i]));
+        }, "publish.masks.jobs");
+        parallelFor(0, changedResumes.size(), 0, [&](int begin, int end) {
+            for (int i = begin; i < end; i++) keywordMatcher.maskFor(resumeRecords.unpublished(changedResumes[i]));
+        }, "publish.masks.resumes");
+        changedJobs.clear();
+        changedResumes.clear();
+
+        StoreVersion* next = new StoreVersion();
+        jobRecords.view(next->jobRecords);
+        jobOrder.view(next->jobOrder);
+        resumeRecords.view(next->resumeRecords);
+        resumeOrder.view(next->resumeOrder);
+        validSkills.view(next->validSkills);
+
+        next->version = publishedVersions.load() + 1;
+        StoreVersion* old = current.exchange(next);
+        unsigned long long retiredAt = globalEpoch.fetch_add(1);
+        if (old) {
+            old->garbage = move(garbage);
+            retired.push_back(RetiredVersion(old, retiredAt));
+        } else {
+            for (int i = 0; i < garbage.size(); i++) delete garbage[i];
+        }
+        garbage.clear();
+        publishedVersions.store(next->version);
+        reclaimLocked();
+        return next->version;
+    }
+
+public:
+    VersionedJobStore() : current(nullptr), globalEpoch(1), publishedVersions(0) {
+        for (int i = 0; i < MAX_READERS; i++) readers[i].epoch.store(0);
+    }
+
+    // Readers must have released their guards before the store goes away
+    ~VersionedJobStore() {
+        delete current.load();
+        for (int i = 0; i < retired.getSize(); i++) delete retired[i].version;
+        for (int i = 0; i < garbage.size(); i++) delete garbage[i];
+    }
+
+    VersionedJobStore(const VersionedJobStore&) = delete;
+    VersionedJobStore& operator=(const VersionedJobStore&) = delete;
+
+    // Pin the current version. Lock-free; only spins if every slot is taken.
+    StoreReadGuard pin() const {
+        static thread_local int slotHint = 0;
+        while (true) {
+            for (int i = 0; i < MAX_READERS; i++) {
+                int index = (slotHint + i) % MAX_READERS;
+                unsigned long long expected = 0;
+                unsigned long long epoch = globalEpoch.load();
+                if (readers[index].epoch.compare_exchange_strong(expected, epoch)) {
+                    slotHint = index;
+                    return StoreReadGuard(current.load(), &readers[index].epoch);
+                }
+            }
+            this_thread::yield();
+        }
+    }
+
+    // === Writer side ===
+    // Changes become visible to readers at the next publish.
+
+    // Drop every record, e.g. before a reload
+    void resetRecords() {
+        lock_guard<mutex> lock(writerMutex);
+        jobRecords.clear(garbage);
+        jobOrder.clear(garbage);
+        resumeRecords.clear(garbage);
+        resumeOrder.clear(garbage);
+        validSkills.clear(garbage);
+        jobRecordById.clear();
+        resumeRecordById.clear();
+        changedJobs.clear();
+        changedResumes.clear();
+    }
+
+    // Add a record after the last position
+    void appendJob(const Job& job) {
+        lock_guard<mutex> lock(writerMutex);
+        int record = jobRecords.append(job);
+        jobOrder.append(record);
+        jobRecordById.insert(job.id, record);
+        changedJobs.push_back(record);
+    }
+
+    void appendResume(const Resume& resume) {
+        lock_guard<mutex> lock(writerMutex);
+        int record = resumeRecords.append(resume);
+        resumeOrder.append(record);
+        resumeRecordById.insert(resume.id, record);
+        changedResumes.push_back(record);
+    }
+
+    void appendSkill(const CustomString& skill) {
+        lock_guard<mutex> lock(writerMutex);
+        validSkills.append(skill);
+    }
+
+    // Replace the resume with the same id, copying only its chunk
+    void replaceResume(const Resume& resume) {
+        lock_guard<mutex> lock(writerMutex);
+        const int* record = resumeRecordById.find(resume.id);
+        if (record == nullptr) return;
+        resumeRecords.change(*record, garbage) = resume;
+        changedResumes.push_back(*record);
+    }
+
+    // New position order. forEachJob(visit) must call visit(job) for every
+    // stored job in its new order; only the order table is rewritten.
+    template<typename ForEachJob>
+    void reorderJobs(ForEachJob forEachJob) {
+        lock_guard<mutex> lock(writerMutex);
+        jobOrder.clear(garbage);
+        forEachJob([&](const Job& job) {
+            const int* record = jobRecordById.find(job.id);
+            if (record) jobOrder.append(*record);
+        });
+    }
+
+    template<typename ForEachResume>
+    void reorderResumes(ForEachResume forEachResume) {
+        lock_guard<mutex> lock(writerMutex);
+        resumeOrder.clear(garbage);
+        forEachResume([&](const Resume& resume) {
+            const int* record = resumeRecordById.find(resume.id);
+            if (record) resumeOrder.append(*record);
+        });
+    }
+
+    // Make the changes so far visible as the next version
+    unsigned long long publish() {
+        lock_guard<mutex> lock(writerMutex);
+        return publishLocked();
+    }
+
+    // Free versions whose readers have all moved on
+    void reclaim() {
+        lock_guard<mutex> lock(writerMutex);
+        reclaimLocked();
+    }
+
+    // Number of the latest published version (0 before the first publish)
+    unsigned long long getVersion() const {
+        return publishedVersions.load();
+    }
+
+    int getRetiredCount() {
+        lock_guard<mutex> lock(writerMutex);
+        return retired.getSize();
+    }
+
+    // Keyword masks in published versions are cached for this matcher
+    const KeywordMatcher& getKeywordMatcher() const { return keywordMatcher; }
+};
+
+// Keyword top-k over a pinned version, as queryTopJobsByKeywords over an array
+inline void queryTopJobsByKeywords(const StoreVersion& snapshot, const Resume& resume,
+                                   const KeywordMatcher& matcher, int topN, QueryResult& out) {
+    KeywordScorer scorer(matcher);
+    out.clear();
+    out.scratch.resize(snapshot.getJobCount());
+    scorer.prepare(resume);
+    parallelFor(0, snapshot.getJobCount(), 0, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) out.scratch[i] = scorer.score(snapshot.job(i));
+    }, KeywordScorer::label());
+    selectTopScores(out.scratch, topN, false, out.indices);
+    copyTopScores(out.scratch, out.indices, out.scores);
+}
+
+// Result of a concurrent read benchmark
+struct SnapshotReaderStats {
+    int readers;
+    long long queries;
+    double millis;
+    unsigned long long firstVersion;
+    unsigned long long lastVersion;
+};
+
+// Run keyword top-5 queries from several reader threads against pinned versions
+// for durationMs, while a writer thread republishes the store every few ms
+inline SnapshotReaderStats benchmarkSnapshotReaders(VersionedJobStore& store, int readerCount, int durationMs) {
+    SnapshotReaderStats stats = {readerCount, 0, 0.0, store.getVersion(), 0};
+    atomic<bool> stop(false);
+    atomic<long long> totalQueries(0);
+
+    auto reader = [&](int seed) {
+        QueryResult result;
+        long long done = 0;
+        int resumeIndex = seed * 7919;
+        while (!stop.load(memory_order_relaxed)) {
+            StoreReadGuard snapshot = store.pin();
+            if (snapshot.get() == nullptr || snapshot->getResumeCount() == 0) break;
+            const Resume& resume = snapshot->resume(resumeIndex % snapshot->getResumeCount());
+            queryTopJobsByKeywords(*snapshot, resume, store.getKeywordMatcher(), 5, result);
+            resumeIndex += 31;
+            done++;
+        }
+        totalQueries.fetch_add(done);
+    };
+
+    auto writer = [&]() {
+        while (!stop.load(memory_order_relaxed)) {
+            store.publish();
+            this_thread::sleep_for(chrono::milliseconds(5));
+        }
+    };
+
+    auto start = chrono::high_resolution_clock::now();
+    thread** threads = new thread*[readerCount + 1];
+    for (int i = 0; i < readerCount; i++) threads[i] = new thread(reader, i + 1);
+    threads[readerCount] = new thread(writer);
+    this_thread::sleep_for(chrono::milliseconds(durationMs));
+    stop.store(true);
+    for (int i = 0; i <= readerCount; i++) {
+        threads[i]->join();
+        delete threads[i];
+    }
+    delete[] threads;
+    auto end = chrono::high_resolution_clock::now();
+
+    store.reclaim();
+    stats.queries = totalQueries.load();
+    stats.millis = chrono::duration<double, milli>(end - start).count();
+    stats.lastVersion = store.getVersion();
+    return stats;
+}
+
+// Print query throughput for 1, 2, 4, ... reader threads against one store
+inline void printSnapshotReaderBenchmark(VersionedJobStore& store, int durationMs = 1000) {
+    if (store.getVersion() == 0) {
+        cout << "No published version yet. Load data first." << endl;
+        return;
+    }
+    int hardwareThreads = static_cast<int>(thread::hardware_concurrency());
+    int maxReaders = max(1, min(hardwareThreads > 0 ? hardwareThreads : 4, VersionedJobStore::MAX_READERS - 1));
+
+    cout << "\n=== Concurrent Query Throughput (Snapshot Readers) ===" << endl;
+    cout << "Keyword top-5 queries, writer republishing every 5 ms" << endl;
+    cout << "Readers | Queries/s     | Versions published" << endl;
+    for (int readers = 1; readers <= maxReaders; readers *= 2) {
+        SnapshotReaderStats stats = benchmarkSnapshotReaders(store, readers, durationMs);
+        double perSecond = stats.millis > 0 ? stats.queries * 1000.0 / stats.millis : 0.0;
+        cout << setw(7) << readers << " | " << setw(13) << fixed << setprecision(1) << perSecond
+             << " | " << (stats.lastVersion - stats.firstVersion) << endl;
+    }
+    cout << "Retired versions still pinned: " << store.getRetiredCount() << endl;
+}
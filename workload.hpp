@@ -0,0 +1,615 @@
+#pragma once
+#include "array_datastorage.hpp"
+#include "linkedlist_datastorage.hpp"
+#include "thread_pool.hpp"
+#include "instrumentation.hpp"
+#include "perf_counters.hpp"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+
+using namespace std;
+
+// Non-interactive driver: command-line options and workload scripts.
+//
+// Both are lists of steps "command [argument]". On the command line a step is
+// --command or --command=argument; all settings are applied first and the
+// actions then run in the order given, so
+//   main --storage=array --load --sort=skillCount --match-resume=42 --topk=10 --repeat=100
+// loads, sorts and then runs 100 top-10 matches. A script (--script=file)
+// has one step per line, "command argument", with # comments; there settings
+// take effect from their line on, so one script can mix storages and repeats.
+//
+// Settings:  storage array|linkedlist   topk K   scorer NAME   repeat N
+//            format csv|binary   cache on|off   threads N   trace on|off   perf on|off
+//            category NAME|any   priority 1-3|any
+// Actions:   load [jobs.csv,resumes.csv]   snapshot-load FILE   snapshot-save FILE
+//            ingest [jobs.csv,resumes.csv]   sort KEY   match-resume ID   match-all   search-skill SKILL
+//            search-title TITLE   write-matches FILE   stats   script FILE
+//            instrument-reset   instrument-json FILE   trace-json FILE
+//            search-title-indexed TITLE   search-title-keyword TEXT
+//            complete-skill PREFIX   search-skill-fuzzy SKILL
+//
+// ingest reads the rows added since the last load or ingest to the CSV files
+// that load read; after snapshot-load, whose snapshot does not name its CSV
+// files, give them as the argument.
+// Query actions (match-*, search-*) run repeat times, the others once; each
+// action reports total, mean, min and max time and the instrumentation
+// counters it moved, e.g. node_hops per run. With perf on, hardware counters
+// of the calling thread (cycles, instructions, cache, branch and TLB misses)
+// follow; use threads 1 so pool work runs on that thread. Where perf_event_open
+// is unavailable a warning is printed once and only wall times are reported.
+// Scorers: array weighted|keyword|bm25|jaccard|cosine|description,
+//          linkedlist jaccard|weighted|cosine|lsh.
+// search-title-indexed uses the linked list's skip-list index, or on the array
+// a binary search, which needs the jobs sorted by title first.
+// search-title-keyword finds titles containing TEXT, through the array's
+// trigram index or by scanning the list. complete-skill lists up to topk skills
+// starting with PREFIX; search-skill-fuzzy resolves SKILL through the skill
+// trie (any case, a typo or two) and runs search-skill with the result.
+// category and priority restrict match-resume, match-all and search-skill to
+// the jobs of those buckets, e.g. "category scientist" then "match-resume 42"
+// for the top scientist jobs; filtered matching takes the weighted, keyword,
+// bm25, jaccard or cosine scorer on the array, jaccard, weighted or cosine on
+// the list.
+// Sort keys: array title|skillCount|skillCount-merge|resumeSkillCount|bubble-title,
+//            linkedlist title|skillCount|resumeSkillCount.
+
+const char* DEFAULT_JOB_FILE = "csv/job_description.csv";
+const char* DEFAULT_RESUME_FILE = "csv/resume.csv";
+
+struct WorkloadStep {
+    string command;
+    string argument;
+};
+
+inline bool isWorkloadSetting(const string& command) {
+    return command == "storage" || command == "topk" || command == "scorer" || command == "repeat"
+        || command == "format" || command == "cache" || command == "threads" || command == "trace"
+        || command == "perf" || command == "category" || command == "priority";
+}
+
+// Read-only actions, the ones repeat applies to
+inline bool isRepeatedAction(const string& command) {
+    return command == "match-resume" || command == "match-all" || command == "search-skill" || command == "search-title"
+        || command == "search-title-indexed" || command == "search-title-keyword" || command == "complete-skill"
+        || command == "search-skill-fuzzy";
+}
+
+inline bool isWorkloadAction(const string& command) {
+    return isRepeatedAction(command) || command == "load" || command == "snapshot-load" || command == "snapshot-save"
+        || command == "ingest" || command == "sort" || command == "write-matches" || command == "stats"
+        || command == "script" || command == "instrument-reset" || command == "instrument-json" || command == "trace-json";
+}
+
+inline string trimWorkloadText(const string& text) {
+    size_t begin = text.find_first_not_of(" \t\r\n");
+    if (begin == string::npos) return "";
+    size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+// CSV files a storage was loaded from; empty until a load names them
+struct CsvSource {
+    string jobFile;
+    string resumeFile;
+
+    bool empty() const { return jobFile.empty(); }
+};
+
+// Split "jobs.csv,resumes.csv"; false without the comma
+inline bool parseCsvPair(const string& text, CsvSource& source) {
+    size_t comma = text.find(',');
+    if (comma == string::npos) return false;
+    source.jobFile = text.substr(0, comma);
+    source.resumeFile = text.substr(comma + 1);
+    return true;
+}
+
+class WorkloadRunner {
+private:
+    ArrayDataStorage arrayStorage;
+    LinkedListDataStorage listStorage;
+    bool useArray;
+    bool arrayLoaded;
+    int topK;
+    string scorer;
+    bool scorerChosen;                   // otherwise the storage's default scorer
+    int repeat;
+    MatchOutputFormat format;
+    int scriptDepth;
+    PerfCounters perf;
+    JobFilter jobFilter;                 // category/priority restriction, any by default
+    CsvSource arraySource;               // CSV files ingest reads for each storage
+    CsvSource listSource;
+
+    bool fail(const WorkloadStep& step, const char* message) {
+        cerr << "Error: " << step.command << (step.argument.empty() ? "" : " ") << step.argument
+             << ": " << message << endl;
+        return false;
+    }
+
+    bool isLoaded() const { return useArray ? arrayLoaded : listStorage.isDataLoaded(); }
+
+    CsvSource& currentSource() { return useArray ? arraySource : listSource; }
+
+    static bool parseInt(const string& text, int& value) {
+        if (text.empty()) return false;
+        char* end = nullptr;
+        long parsed = strtol(text.c_str(), &end, 10);
+        if (*end != '\0') return false;
+        value = static_cast<int>(parsed);
+        return true;
+    }
+
+    const Resume* findArrayResume(int id) { return arrayStorage.findResumeById(id); }
+
+    const Resume* findListResume(int id) { return listStorage.findResumeById(id); }
+
+    // Top topK jobs of resume as (job id, score); false for an unknown scorer
+    bool matchResume(const Resume& resume, CustomArray<int>& jobIds, CustomArray<double>& scores) {
+        jobIds.clear();
+        scores.clear();
+        if (!jobFilter.isAny()) return matchResumeFiltered(resume, jobIds, scores);
+        if (useArray) {
+            QueryResult ranked;
+            if (scorer == "weighted") arrayStorage.queryTopJobsForResume(resume, topK, ranked);
+            else if (scorer == "keyword") arrayStorage.queryTopJobsByKeywords(resume, topK, ranked);
+            else if (scorer == "bm25") arrayStorage.queryTopJobsBySkillBM25(resume, topK, ranked);
+            else if (scorer == "description") arrayStorage.queryTopJobsByDescription(resume, topK, ranked);
+            else if (scorer == "jaccard") {
+                JaccardScorer jaccard;
+                arrayStorage.queryTopJobsWith(resume, jaccard, topK, ranked);
+            } else if (scorer == "cosine") {
+                CosineScorer cosine;
+                arrayStorage.queryTopJobsWith(resume, cosine, topK, ranked);
+            } else {
+                return false;
+            }
+            for (int i = 0; i < ranked.size(); i++) {
+                jobIds.push_back(arrayStorage.getJobArray()[ranked.indices[i]].id);
+                scores.push_back(ranked.scores[i]);
+            }
+            return true;
+        }
+
+        HandleQueryResult<Job> ranked;
+        if (scorer == "jaccard") listStorage.queryTopMatches(resume, topK, ranked);
+        else if (scorer == "lsh") listStorage.queryApproximateTopMatches(resume, topK, ranked);
+        else if (scorer == "weighted") {
+            WeightedScorer weighted;
+            listStorage.queryTopMatchesWith(resume, weighted, topK, ranked);
+        } else if (scorer == "cosine") {
+            CosineScorer cosine;
+            listStorage.queryTopMatchesWith(resume, cosine, topK, ranked);
+        } else {
+            return false;
+        }
+        for (int i = 0; i < ranked.size(); i++) {
+            jobIds.push_back(ranked.items[i]->id);
+            scores.push_back(ranked.scores[i]);
+        }
+        return true;
+    }
+
+    // matchResume within the jobFilter buckets
+    bool matchResumeFiltered(const Resume& resume, CustomArray<int>& jobIds, CustomArray<double>& scores) {
+        if (useArray) {
+            QueryResult ranked;
+            if (scorer == "weighted") {
+                arrayStorage.queryTopJobsForResumeFiltered(resume, jobFilter, topK, ranked);
+            } else if (scorer == "keyword") {
+                KeywordScorer keyword(arrayStorage.getKeywordMatcher());
+                arrayStorage.queryTopJobsFiltered(resume, keyword, jobFilter, topK, ranked);
+            } else if (scorer == "bm25") {
+                BM25Scorer bm25(arrayStorage.getSkillStatistics());
+                arrayStorage.queryTopJobsFiltered(resume, bm25, jobFilter, topK, ranked);
+            } else if (scorer == "jaccard") {
+                JaccardScorer jaccard;
+                arrayStorage.queryTopJobsFiltered(resume, jaccard, jobFilter, topK, ranked);
+            } else if (scorer == "cosine") {
+                CosineScorer cosine;
+                arrayStorage.queryTopJobsFiltered(resume, cosine, jobFilter, topK, ranked);
+            } else {
+                return false;
+            }
+            for (int i = 0; i < ranked.size(); i++) {
+                jobIds.push_back(arrayStorage.getJobArray()[ranked.indices[i]].id);
+                scores.push_back(ranked.scores[i]);
+            }
+            return true;
+        }
+
+        HandleQueryResult<Job> ranked;
+        if (scorer == "jaccard") {
+            JaccardScorer jaccard;
+            listStorage.queryTopMatchesFiltered(resume, jaccard, jobFilter, topK, ranked);
+        } else if (scorer == "weighted") {
+            WeightedScorer weighted;
+            listStorage.queryTopMatchesFiltered(resume, weighted, jobFilter, topK, ranked);
+        } else if (scorer == "cosine") {
+            CosineScorer cosine;
+            listStorage.queryTopMatchesFiltered(resume, cosine, jobFilter, topK, ranked);
+        } else {
+            return false;
+        }
+        for (int i = 0; i < ranked.size(); i++) {
+            jobIds.push_back(ranked.items[i]->id);
+            scores.push_back(ranked.scores[i]);
+        }
+        return true;
+    }
+
+    bool sortBy(const string& key) {
+        if (useArray) {
+            if (key == "title") arrayStorage.sortJobsBy(JobTitleLess(), true, "sort.jobs.title");
+            else if (key == "skillCount") arrayStorage.quickSortJobsBySkillCount();
+            else if (key == "skillCount-merge") arrayStorage.mergeSortJobsBySkillCount();
+            else if (key == "resumeSkillCount") arrayStorage.sortResumesBy(ResumeSkillCountLess(), true, "sort.resumes.skillCount");
+            else if (key == "bubble-title") arrayStorage.bubbleSortJobsByTitle();
+            else return false;
+            return true;
+        }
+        if (key == "title") listStorage.bubbleSortJobsByTitle();
+        else if (key == "skillCount") listStorage.bubbleSortJobsBySkillCount();
+        else if (key == "resumeSkillCount") listStorage.bubbleSortResumesBySkillCount();
+        else return false;
+        return true;
+    }
+
+    bool applySetting(const WorkloadStep& step) {
+        const string& value = step.argument;
+        int number = 0;
+        if (step.command == "storage") {
+            if (value == "array") useArray = true;
+            else if (value == "linkedlist" || value == "list") useArray = false;
+            else return fail(step, "expected array or linkedlist");
+            if (!scorerChosen) scorer = useArray ? "weighted" : "jaccard";
+        } else if (step.command == "topk") {
+            if (!parseInt(value, number) || number <= 0) return fail(step, "expected a positive number");
+            topK = number;
+        } else if (step.command == "repeat") {
+            if (!parseInt(value, number) || number <= 0) return fail(step, "expected a positive number");
+            repeat = number;
+        } else if (step.command == "scorer") {
+            if (value.empty()) return fail(step, "expected a scorer name");
+            scorer = value;
+            scorerChosen = true;
+        } else if (step.command == "format") {
+            if (value == "csv") format = MATCH_OUTPUT_CSV;
+            else if (value == "binary") format = MATCH_OUTPUT_BINARY;
+            else return fail(step, "expected csv or binary");
+        } else if (step.command == "cache") {
+            if (value != "on" && value != "off") return fail(step, "expected on or off");
+            arrayStorage.setMatchCacheEnabled(value == "on");
+            listStorage.setMatchCacheEnabled(value == "on");
+        } else if (step.command == "threads") {
+            if (!parseInt(value, number) || number <= 0) return fail(step, "expected a positive number");
+            setThreadPoolWorkers(number);
+        } else if (step.command == "trace") {
+            if (value != "on" && value != "off") return fail(step, "expected on or off");
+            setTracing(value == "on");
+        } else if (step.command == "category") {
+            if (value == "any") jobFilter.category = JOB_FILTER_ANY;
+            else if (jobCategoryCode(value.c_str()) >= 0) jobFilter.category = jobCategoryCode(value.c_str());
+            else return fail(step, "expected a job category or any");
+        } else if (step.command == "priority") {
+            if (value == "any") jobFilter.priority = JOB_FILTER_ANY;
+            else if (parseInt(value, number) && number >= 1 && number <= 3) jobFilter.priority = number;
+            else return fail(step, "expected 1-3 or any");
+        } else if (step.command == "perf") {
+            if (value != "on" && value != "off") return fail(step, "expected on or off");
+            if (value == "off") {
+                perf.close();
+            } else if (!perf.open()) {
+                cerr << "Warning: hardware counters unavailable: " << perf.unavailableReason()
+                     << "; reporting wall times only" << endl;
+            }
+        }
+        return true;
+    }
+
+    // One execution of an action; false stops the workload
+    bool runOnce(const WorkloadStep& step, bool report) {
+        const string& command = step.command;
+        const string& value = step.argument;
+
+        if (command == "load") {
+            CsvSource source;
+            source.jobFile = DEFAULT_JOB_FILE;
+            source.resumeFile = DEFAULT_RESUME_FILE;
+            if (!value.empty() && !parseCsvPair(value, source)) return fail(step, "expected jobs.csv,resumes.csv");
+            bool ok = useArray ? arrayStorage.loadArrayData(source.jobFile.c_str(), source.resumeFile.c_str())
+                               : listStorage.loadLinkedListData(source.jobFile.c_str(), source.resumeFile.c_str());
+            if (useArray) arrayLoaded = ok;
+            currentSource() = ok ? source : CsvSource();
+            return ok || fail(step, "load failed");
+        }
+        if (command == "snapshot-load") {
+            if (value.empty()) return fail(step, "expected a file name");
+            bool ok = useArray ? arrayStorage.loadFromSnapshot(value.c_str()) : listStorage.loadFromSnapshot(value.c_str());
+            if (useArray) arrayLoaded = ok;
+            currentSource() = CsvSource();
+            return ok || fail(step, "could not load snapshot");
+        }
+        if (command == "stats") {
+            if (report) {
+                threadPool().printStats();
+                printInstrumentationSummary(cout);
+            }
+            return true;
+        }
+        if (command == "instrument-reset") {
+            resetInstrumentation();
+            return true;
+        }
+        if (command == "instrument-json" || command == "trace-json") {
+            if (value.empty()) return fail(step, "expected a file name");
+            bool ok = command == "instrument-json" ? saveInstrumentationJson(value.c_str()) : saveChromeTrace(value.c_str());
+            return ok || fail(step, "write failed");
+        }
+        if (command == "script") return runScript(value.c_str());
+
+        if (!isLoaded()) return fail(step, "no data loaded (use load or snapshot-load first)");
+
+        if (command == "snapshot-save") {
+            if (value.empty()) return fail(step, "expected a file name");
+            bool ok = useArray ? arrayStorage.saveSnapshot(value.c_str()) : listStorage.saveSnapshot(value.c_str());
+            return ok || fail(step, "could not save snapshot");
+        }
+        if (command == "ingest") {
+            // The byte offsets belong to the loaded files, so never fall back to the defaults
+            if (!value.empty() && !parseCsvPair(value, currentSource())) return fail(step, "expected jobs.csv,resumes.csv");
+            const CsvSource& source = currentSource();
+            if (source.empty()) return fail(step, "no CSV files to ingest from (after snapshot-load, give jobs.csv,resumes.csv)");
+            int rows = useArray ? arrayStorage.ingestNewRows(source.jobFile.c_str(), source.resumeFile.c_str())
+                                : listStorage.ingestNewRows(source.jobFile.c_str(), source.resumeFile.c_str());
+            if (report) cout << "Ingested " << rows << " rows" << endl;
+            return true;
+        }
+        if (command == "sort") return sortBy(value) || fail(step, "unknown sort key for this storage");
+        if (command == "match-resume") {
+            int id = 0;
+            if (!parseInt(value, id)) return fail(step, "expected a resume id");
+            const Resume* resume = useArray ? findArrayResume(id) : findListResume(id);
+            if (resume == nullptr) return fail(step, "no resume with this id");
+            CustomArray<int> jobIds;
+            CustomArray<double> scores;
+            if (!matchResume(*resume, jobIds, scores)) return fail(step, "unknown scorer for this storage");
+            if (report) {
+                cout << "Top " << topK << " (" << scorer << ") for resume " << id << ":";
+                for (int i = 0; i < jobIds.size(); i++) cout << " " << jobIds[i] << " [" << scores[i] << "]";
+                cout << endl;
+            }
+            return true;
+        }
+        if (command == "match-all") {
+            CustomArray<int> jobIds;
+            CustomArray<double> scores;
+            long long rows = 0;
+            if (useArray) {
+                for (int r = 0; r < arrayStorage.getResumeArray().getSize(); r++) {
+                    if (!matchResume(arrayStorage.getResumeArray()[r], jobIds, scores)) return fail(step, "unknown scorer for this storage");
+                    rows += jobIds.size();
+                }
+            } else {
+                for (const ListNode<Resume>* node = listStorage.getResumeList().getHead(); node != nullptr; node = node->next) {
+                    if (!matchResume(node->data, jobIds, scores)) return fail(step, "unknown scorer for this storage");
+                    rows += jobIds.size();
+                }
+            }
+            if (report) cout << "Matched all resumes, " << rows << " ranked rows" << endl;
+            return true;
+        }
+        if (command == "search-skill" || command == "search-title") {
+            CustomString text(value.c_str());
+            int found;
+            if (useArray) {
+                QueryResult matches;
+                if (command == "search-skill") arrayStorage.queryJobsBySkillFiltered(text, jobFilter, matches);
+                else arrayStorage.queryJobsByTitle(text, matches);
+                found = matches.size();
+            } else {
+                HandleQueryResult<Job> matches;
+                if (command == "search-skill") listStorage.queryJobsBySkillFiltered(text, jobFilter, matches);
+                else listStorage.queryJobsByTitle(text, matches);
+                found = matches.size();
+            }
+            if (report) cout << "Found " << found << " jobs" << endl;
+            return true;
+        }
+        if (command == "search-title-indexed") {
+            CustomString text(value.c_str());
+            int found;
+            if (useArray) {
+                found = arrayStorage.binarySearchJobByTitle(text) != nullptr ? 1 : 0;
+            } else {
+                HandleQueryResult<Job> matches;
+                listStorage.queryJobsByTitleIndexed(text, matches);
+                found = matches.size();
+            }
+            if (report) cout << "Found " << found << " jobs" << endl;
+            return true;
+        }
+        if (command == "search-title-keyword") {
+            CustomString text(value.c_str());
+            int found = 0;
+            if (useArray) {
+                QueryResult matches;
+                arrayStorage.queryJobsByTitleKeyword(text, matches);
+                found = matches.size();
+            } else {
+                CustomString lowerText = convertToLowerCase(text);
+                if (lowerText.c_str() == nullptr) return fail(step, "expected a keyword");
+                for (const ListNode<Job>* node = listStorage.getJobList().getHead(); node != nullptr; node = node->next) {
+                    const char* title = node->data.lowerCaseTitle.c_str();
+                    if (title && strstr(title, lowerText.c_str())) found++;
+                }
+            }
+            if (report) cout << "Found " << found << " jobs" << endl;
+            return true;
+        }
+        if (command == "complete-skill") {
+            CustomString prefix(value.c_str());
+            CustomArray<int> ids;
+            if (useArray) arrayStorage.completeSkill(prefix, topK, ids);
+            else listStorage.completeSkill(prefix, topK, ids);
+            if (report) {
+                cout << "Completions for '" << value << "':";
+                for (int i = 0; i < ids.size(); i++) {
+                    cout << " '" << (useArray ? arrayStorage.getSkillName(ids[i]) : listStorage.getSkillName(ids[i])) << "'";
+                }
+                cout << endl;
+            }
+            return true;
+        }
+        if (command == "search-skill-fuzzy") {
+            CustomString text(value.c_str());
+            int skillId = useArray ? arrayStorage.resolveSkillId(text) : listStorage.resolveSkillId(text);
+            int found = 0;
+            if (skillId != SKILL_TRIE_NONE && useArray) {
+                QueryResult matches;
+                arrayStorage.queryJobsBySkillId(skillId, matches);
+                found = matches.size();
+            } else if (skillId != SKILL_TRIE_NONE) {
+                HandleQueryResult<Job> matches;
+                listStorage.queryJobsBySkillId(skillId, matches);
+                found = matches.size();
+            }
+            if (report) {
+                if (skillId == SKILL_TRIE_NONE) cout << "No skill close to '" << value << "'" << endl;
+                else cout << "Found " << found << " jobs with '"
+                          << (useArray ? arrayStorage.getSkillName(skillId) : listStorage.getSkillName(skillId)) << "'" << endl;
+            }
+            return true;
+        }
+        if (command == "write-matches") {
+            if (!useArray) return fail(step, "only the array storage writes batch output");
+            if (value.empty()) return fail(step, "expected a file name");
+            return arrayStorage.writeAllMatches(value.c_str(), topK, format) >= 0 || fail(step, "write failed");
+        }
+        return fail(step, "unknown command");
+    }
+
+public:
+    WorkloadRunner() : useArray(true), arrayLoaded(false), topK(5), scorer("weighted"), scorerChosen(false), repeat(1),
+                       format(MATCH_OUTPUT_CSV), scriptDepth(0) {}
+
+    // Apply a setting or run an action repeat times with timing
+    bool runStep(const WorkloadStep& step) {
+        if (isWorkloadSetting(step.command)) return applySetting(step);
+        if (!isWorkloadAction(step.command)) return fail(step, "unknown command");
+
+        double totalMs = 0.0, minMs = 0.0, maxMs = 0.0;
+        int runs = isRepeatedAction(step.command) ? repeat : 1;
+        CounterSnapshot before = instrumentCounters();
+        PerfSample perfBefore = perf.read();
+        for (int i = 0; i < runs; i++) {
+            auto start = chrono::steady_clock::now();
+            if (!runOnce(step, i == 0)) return false;
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            totalMs += ms;
+            minMs = i == 0 ? ms : min(minMs, ms);
+            maxMs = max(maxMs, ms);
+        }
+        if (step.command != "script") {
+            cout << "[workload] " << (useArray ? "array" : "linkedlist") << " " << step.command
+                 << (step.argument.empty() ? "" : " ") << step.argument << " x" << runs
+                 << ": total " << totalMs << " ms, mean " << totalMs / runs << " ms, min " << minMs
+                 << " ms, max " << maxMs << " ms";
+            CounterSnapshot moved = instrumentCounters() - before;
+            for (int i = 0; i < COUNTER_KINDS; i++) {
+                if (moved.values[i] > 0) cout << ", " << instrumentCounterName(i) << " " << moved.values[i] / runs << "/run";
+            }
+            printPerfSample(cout, perf.read() - perfBefore, runs);
+            cout << endl;
+        }
+        return true;
+    }
+
+    // Steps of a script file, settings in line order
+    bool runScript(const char* filename) {
+        if (scriptDepth >= 8) {
+            cerr << "Error: scripts nested too deeply at " << filename << endl;
+            return false;
+        }
+        ifstream in(filename);
+        if (!in.is_open()) {
+            cerr << "Error: Could not open workload script " << filename << endl;
+            return false;
+        }
+        scriptDepth++;
+        string line;
+        int lineNumber = 0;
+        bool ok = true;
+        while (ok && getline(in, line)) {
+            lineNumber++;
+            size_t comment = line.find('#');
+            if (comment != string::npos) line = line.substr(0, comment);
+            line = trimWorkloadText(line);
+            if (line.empty()) continue;
+            WorkloadStep step;
+            size_t space = line.find_first_of(" \t");
+            step.command = line.substr(0, space);
+            if (space != string::npos) step.argument = trimWorkloadText(line.substr(space));
+            ok = runStep(step);
+            if (!ok) cerr << "  at " << filename << ":" << lineNumber << endl;
+        }
+        scriptDepth--;
+        return ok;
+    }
+};
+
+inline void printCommandLineUsage() {
+    cout << "Usage: main [--storage=array|linkedlist] [--load[=jobs.csv,resumes.csv]] [--snapshot-load=FILE]\n"
+         << "            [--sort=KEY] [--match-resume=ID] [--match-all] [--search-skill=S] [--search-title=T]\n"
+         << "            [--search-title-indexed=T] [--search-title-keyword=T]\n"
+         << "            [--complete-skill=PREFIX] [--search-skill-fuzzy=S]\n"
+         << "            [--write-matches=FILE] [--ingest] [--snapshot-save=FILE] [--stats] [--script=FILE]\n"
+         << "            [--topk=K] [--scorer=NAME] [--repeat=N] [--format=csv|binary] [--cache=on|off] [--threads=N]\n"
+         << "            [--trace=on|off] [--instrument-reset] [--instrument-json=FILE] [--trace-json=FILE]\n"
+         << "            [--perf=on|off] [--category=NAME|any] [--priority=1-3|any]\n"
+         << "Without options the interactive menu starts. See workload.hpp for the script format." << endl;
+}
+
+// Run argv as a workload; returns the process exit code
+inline int runCommandLine(int argc, char** argv) {
+    CustomArray<WorkloadStep> settings;
+    CustomArray<WorkloadStep> actions;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printCommandLineUsage();
+            return 0;
+        }
+        if (arg.compare(0, 2, "--") != 0) {
+            cerr << "Error: unexpected argument " << arg << endl;
+            printCommandLineUsage();
+            return 1;
+        }
+        WorkloadStep step;
+        size_t equals = arg.find('=');
+        step.command = arg.substr(2, equals == string::npos ? string::npos : equals - 2);
+        if (equals != string::npos) step.argument = arg.substr(equals + 1);
+        if (isWorkloadSetting(step.command)) {
+            settings.push_back(step);
+        } else if (isWorkloadAction(step.command)) {
+            actions.push_back(step);
+        } else {
+            cerr << "Error: unknown option " << arg << endl;
+            printCommandLineUsage();
+            return 1;
+        }
+    }
+
+    WorkloadRunner runner;
+    for (int i = 0; i < settings.size(); i++) {
+        if (!runner.runStep(settings[i])) return 1;
+    }
+    for (int i = 0; i < actions.size(); i++) {
+        if (!runner.runStep(actions[i])) return 1;
+    }
+    return 0;
+}